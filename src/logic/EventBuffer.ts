@@ -1,66 +1,105 @@
-// Compact, single-buffer event stream utilities for JS<->WASM turns.
-// Layout per event (all little-endian):
-// - header u32: low 16 bits = type, high 16 bits = size in dwords (including header)
-// - payload: packed words; floats read via Float32 view.
+// Single-producer/single-consumer event rings shared with WASM (event_buffer.h).
+// Layout: a 48-word header (write index, read index, each on its own cache
+// line, then capWords and the producer's counters), then capWords data words.
+// Per event (all little-endian):
+// - u32 size in words, including these two header words
+// - u32 type
+// - payload: packed words; floats read via the Float32 view.
+// Events are contiguous; a 0 size word means "continue at data word 0".
+// read/write are free-running word counts shared through Atomics, so the two
+// sides may run on different threads.
 
-export const EVENT_BUFFER_WORDS = 65536;
+export const EVENT_BUFFER_WORDS = 65536; // data words per ring, a power of two
+export const EVENT_RING_HEADER_WORDS = 48;
 
-export class EventBuffer {
-  u32!: Uint32Array;
+const HDR_WRITE = 0;
+const HDR_READ = 16;
+const HDR_DROPPED_EVENTS = 33;
+const HDR_DROPPED_WORDS = 34;
+const HDR_PEAK_WORDS = 35;
+
+export function eventRingBytes(capWords: number): number {
+  return (EVENT_RING_HEADER_WORDS + capWords) * 4;
+}
+
+export interface EventRingStats {
+  droppedEvents: number; // reserve calls that did not fit
+  droppedWords: number;
+  peakWords: number; // highest fill the producer has seen
+}
+
+export class EventRing {
+  header!: Uint32Array;
+  u32!: Uint32Array; // data words; event indices below point into it
   f32!: Float32Array;
   capWords: number = 0;
-  cursor: number = 0;
+  private pendingWrite: number = 0;
+  private readPos: number = 0;
 
+  // WASM initializes the header (init_agents); the views only attach to it.
   constructor(buffer: ArrayBuffer, basePtrBytes: number, capWords: number) {
-  this.u32 = new Uint32Array(buffer, basePtrBytes, capWords);
-  this.f32 = new Float32Array(buffer, basePtrBytes, capWords);
+  this.header = new Uint32Array(buffer, basePtrBytes, EVENT_RING_HEADER_WORDS);
+  this.u32 = new Uint32Array(buffer, basePtrBytes + EVENT_RING_HEADER_WORDS * 4, capWords);
+  this.f32 = new Float32Array(buffer, basePtrBytes + EVENT_RING_HEADER_WORDS * 4, capWords);
   this.capWords = capWords;
-  this.cursor = 0;
   }
 
-  public writeHeader(type: number, sizeWords: number): void {
-  if (this.cursor + sizeWords >= this.capWords) throw new Error("event buffer full");
-  this.u32[this.cursor] = ((sizeWords & 0xffff) << 16) | (type & 0xffff);
+  // Producer. Index of the new event (payload from +2), or -1 if it does not fit.
+  public reserve(type: number, sizeWords: number): number {
+  const read = Atomics.load(this.header, HDR_READ);
+  const pos = this.pendingWrite & (this.capWords - 1);
+  const skip = sizeWords > this.capWords - pos ? this.capWords - pos : 0;
+  if (sizeWords < 2 || ((this.pendingWrite - read) >>> 0) + skip + sizeWords > this.capWords) {
+    if (this.header[HDR_DROPPED_EVENTS]++ === 0) console.warn("event ring full, dropping commands");
+    this.header[HDR_DROPPED_WORDS] += sizeWords;
+    return -1;
+  }
+  if (skip > 0) {
+    this.u32[pos] = 0;
+    this.pendingWrite = (this.pendingWrite + skip) >>> 0;
+  }
+  const e = this.pendingWrite & (this.capWords - 1);
+  this.u32[e] = sizeWords;
+  this.u32[e + 1] = type;
+  this.pendingWrite = (this.pendingWrite + sizeWords) >>> 0;
+  const used = (this.pendingWrite - read) >>> 0;
+  if (used > this.header[HDR_PEAK_WORDS]) this.header[HDR_PEAK_WORDS] = used;
+  return e;
   }
 
-  public beginFrame(): void {
-  this.cursor = 0;
+  // Producer. Makes every reserved event visible to the consumer.
+  public publish(): void {
+  Atomics.store(this.header, HDR_WRITE, this.pendingWrite);
   }
 
-  public commitFrame(): void {
-  this.u32[this.cursor] = 0;
+  // Producer. True once the consumer has popped every published event, i.e.
+  // WASM has applied the commands.
+  public consumed(): boolean {
+  return Atomics.load(this.header, HDR_READ) === Atomics.load(this.header, HDR_WRITE);
+  }
+
+  // Consumer. Index of the next event, or -1 if there is none.
+  public front(): number {
+  const write = Atomics.load(this.header, HDR_WRITE);
+  while (this.readPos !== write) {
+    const pos = this.readPos & (this.capWords - 1);
+    if (this.u32[pos] !== 0) return pos;
+    this.readPos = (this.readPos + this.capWords - pos) >>> 0; // wrap marker
+  }
+  return -1;
   }
-}
-/*
-export function forEachEvent(
-  buf: EventBuffer,
-  handlers: {
-  mixed?: (x: number, y: number) => void;
-  unknown?: (type: number, sizeWords: number, startWord: number) => void;
-  },
-): void {
-  let p = 0;
-  const cap = buf.capWords;
-  while (true) {
-  const header = buf.u32[p] >>> 0;
-  if (header === 0) break;
-  const type = header & 0xffff;
-  const size = header >>> 16;
-  if (size <= 0 || p + size > cap) break; // malformed; stop
 
-  switch (type) {
-    case EVT_MIXED: {
-    const x = buf.f32[p + 1];
-    const y = buf.f32[p + 2];
-    handlers.mixed?.(x, y);
-    break;
-    }
-    default:
-    handlers.unknown?.(type, size, p);
-    break;
+  // Consumer. Frees the event returned by front().
+  public pop(): void {
+  this.readPos = (this.readPos + this.u32[this.readPos & (this.capWords - 1)]) >>> 0;
+  Atomics.store(this.header, HDR_READ, this.readPos);
   }
 
-  p += size;
+  public stats(): EventRingStats {
+  return {
+    droppedEvents: this.header[HDR_DROPPED_EVENTS],
+    droppedWords: this.header[HDR_DROPPED_WORDS],
+    peakWords: this.header[HDR_PEAK_WORDS],
+  };
   }
 }
-*/
@@ -0,0 +1,91 @@
+import { WasmFacade } from "./WasmFacade";
+
+// Mirrors profiler.h. Header words (u32):
+// [0] seq (odd while written), [1] stage count, [2] words per stage, [3] window, [4] buckets,
+// then per stage: name ptr, total samples, last/min/mean/p99/max us (f32), bucket counts.
+const HEADER_WORDS = 6;
+const MAX_READ_ATTEMPTS = 8;
+
+export interface StageProfile {
+  name: string;
+  samples: number;
+  lastUs: number;
+  minUs: number;
+  meanUs: number;
+  p99Us: number;
+  maxUs: number;
+  // buckets[b] counts window samples in [2^(b-1), 2^b) us, bucket 0 is < 1us
+  buckets: number[];
+}
+
+const nameCache = new Map<number, string>();
+
+function readCString(heap: Uint8Array, ptr: number): string {
+  let name = nameCache.get(ptr);
+  if (name === undefined) {
+    let end = ptr;
+    while (heap[end] !== 0) end++;
+    name = new TextDecoder().decode(heap.slice(ptr, end));
+    nameCache.set(ptr, name);
+  }
+  return name;
+}
+
+/**
+ * Consistent copy of the stats page, or null if the page is unavailable or a
+ * writer kept it busy for every attempt.
+ */
+export function readFrameProfile(wasm: WasmFacade): StageProfile[] | null {
+  if (!wasm._get_profiler_stats_ptr) return null;
+  const pagePtr = wasm._get_profiler_stats_ptr();
+  if (!pagePtr) return null;
+
+  const u32 = wasm.HEAPU32;
+  const h = pagePtr >>> 2;
+  const stageCount = u32[h + 1];
+  const stageWords = u32[h + 2];
+  const bucketCount = u32[h + 4];
+  const pageWords = HEADER_WORDS + stageCount * stageWords;
+
+  for (let attempt = 0; attempt < MAX_READ_ATTEMPTS; attempt++) {
+    const seqBefore = Atomics.load(u32, h);
+    if (seqBefore & 1) continue;
+    const copy = u32.slice(h, h + pageWords);
+    if (Atomics.load(u32, h) !== seqBefore) continue;
+
+    const f32 = new Float32Array(copy.buffer);
+    const stages: StageProfile[] = [];
+    for (let i = 0; i < stageCount; i++) {
+      const s = HEADER_WORDS + i * stageWords;
+      stages.push({
+        name: readCString(wasm.HEAPU8, copy[s]),
+        samples: copy[s + 1],
+        lastUs: f32[s + 2],
+        minUs: f32[s + 3],
+        meanUs: f32[s + 4],
+        p99Us: f32[s + 5],
+        maxUs: f32[s + 6],
+        buckets: Array.from(copy.subarray(s + 7, s + 7 + bucketCount)),
+      });
+    }
+    return stages;
+  }
+  return null;
+}
+
+export function dumpFrameProfile(wasm: WasmFacade): void {
+  const stages = readFrameProfile(wasm);
+  if (!stages) {
+    console.error('Frame profiler stats are not available');
+    return;
+  }
+  console.table(stages.map(s => ({
+    stage: s.name,
+    samples: s.samples,
+    'last us': s.lastUs.toFixed(1),
+    'min us': s.minUs.toFixed(1),
+    'mean us': s.meanUs.toFixed(1),
+    'p99 us': s.p99Us.toFixed(1),
+    'max us': s.maxUs.toFixed(1),
+  })));
+}
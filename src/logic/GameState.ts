@@ -16,6 +16,7 @@ import { Agents } from "./agents/Agents";
 import { getRandomTriangle } from "./navmesh/NavUtils";
 import { WAgent } from "./WAgent";
 import { AgentConfigs } from "./agents/AgentConfigs";
+import type { PathResult, WatchedAgentState } from "./agents/EventHandler";
 
 const INITIAL_SPAWN_SEED = 12345;
 
@@ -78,6 +79,14 @@ export class GameState { // This is a POD class. No functions allowed.
 
   public hypothetical: HypotheticalState | null = null;
 
+  // Answers to cmdFindPath by request id (EVT_PATH_RESULT); callers delete what they consumed.
+  public pathResults: Map<number, PathResult> = new Map();
+  // Agent subscriptions (watchAgents), by agent: fields asked for, then what
+  // WASM last reported. The selected agent's corridor is watched on top.
+  public agentWatchFields: Map<number, number> = new Map();
+  public watchedCorridors: Map<number, number[]> = new Map();
+  public watchedAgentStates: Map<number, WatchedAgentState> = new Map();
+
   public rngSeed: number;
   public rngSeedW: number;
 
@@ -15,7 +15,8 @@ import { updateWAgentGridSpawners } from "./WAgentGridSpawner";
 import { updateAgentStatistic } from "./agents/AgentStatistic";
 import { updateAgentCollisions } from "./agents/AgentCollision";
 import { WasmFacade } from "./WasmFacade";
-import { handleEvents } from "./agents/EventHandler";
+import { flushQueuedTargets, handleEvents, SetTargetsFlags } from "./agents/EventHandler";
+import { SIM_THREADED } from "./initializers/WasmInit";
 
 /**
  * A global queue for commands. Components or other systems can push commands here.
@@ -78,8 +79,12 @@ export function update(gs: GameState, deltaTime: number): void {
   }
   
   if (deltaTime > 0) {
+    // The threaded sim holds its lock for a whole tick, so nothing here takes
+    // it: the event rings need no lock, brains and spawners read agent data
+    // as it is (a value may be one tick old) and change live agents only
+    // through commands. New agents fill slots the sim does not touch until
+    // sim_thread_post_frame raises the active count.
     handleEvents(gs);
-    gs.wasm_agents.events.beginFrame();
 
     updateAvatar(gs.avatar, effectiveDeltaTime, gs.navmesh);
 
@@ -102,12 +107,22 @@ export function update(gs: GameState, deltaTime: number): void {
       updateAgentCollisions(gs.agents, gs.agentGrid);
     }
 
-    // wasm agents
-    for (const agent of gs.wagents) {
-      agent.brain.stack[agent.brain.stack.length - 1].update(gs, agent, effectiveDeltaTime);
+    // wasm agents. Brains decide from the state their last commands produced,
+    // so they skip frames until the sim has applied them; otherwise an agent
+    // just sent off would still read as Standing and be sent off again.
+    const commands = gs.wasm_agents.commands;
+    if (commands.consumed()) {
+      for (const agent of gs.wagents) {
+        agent.brain.stack[agent.brain.stack.length - 1].update(gs, agent, effectiveDeltaTime);
+      }
+      flushQueuedTargets(commands, SetTargetsFlags.FIND_PATH);
+    }
+    commands.publish();
+    if (SIM_THREADED) {
+      WasmFacade._sim_thread_post_frame!(effectiveDeltaTime, gs.wagents.length);
+    } else {
+      WasmFacade._update_simulation(effectiveDeltaTime, gs.wagents.length);
     }
-    gs.wasm_agents.events.commitFrame();
-    WasmFacade._update_simulation(effectiveDeltaTime, gs.wagents.length);
 
   }
 
@@ -0,0 +1,114 @@
+import { WasmFacade } from "./WasmFacade";
+
+// Mirrors nav_telemetry.h. Header words (u32):
+// [0] seq (odd while publishing), [1] frames published, [2] words per block, [3] reason count,
+// then three counter blocks: last frame, totals, per-field peak of any frame.
+const HEADER_WORDS = 4;
+const MAX_READ_ATTEMPTS = 8;
+
+export enum RepathReason {
+  FROM_START = 0,
+  FROM_STUCK = 1,
+  AFTER_PATH_RECOVERY = 2,
+  AFTER_ESCAPING = 3,
+}
+const REASON_NAMES = ['from start', 'from stuck', 'after path recovery', 'after escaping'];
+
+// Order MUST match NAV_COUNTERS in nav_telemetry.h
+const NAV_COUNTERS = [
+  'astar_calls',
+  'astar_nodes_expanded',
+  'astar_iteration_cap',
+  'astar_no_path',
+  'astar_invalid_polys',
+  'patch_direct_ok',
+  'patch_miter_ok',
+  'patch_miter_fail',
+  'patch_intersection_ok',
+  'patch_intersection_fail',
+  'corner_recomputes',
+  'corner_recompute_empty',
+] as const;
+
+export type NavCounterName = typeof NAV_COUNTERS[number];
+
+export interface NavCounterBlock {
+  counters: Record<NavCounterName, number>;
+  // Indexed by RepathReason
+  repaths: number[];
+  repathFailures: number[];
+}
+
+export interface NavTelemetry {
+  frames: number;
+  lastFrame: NavCounterBlock;
+  total: NavCounterBlock;
+  peak: NavCounterBlock;
+}
+
+function readBlock(words: Uint32Array, start: number, reasonCount: number): NavCounterBlock {
+  const counters = {} as Record<NavCounterName, number>;
+  NAV_COUNTERS.forEach((name, i) => { counters[name] = words[start + i]; });
+  const repathStart = start + NAV_COUNTERS.length;
+  return {
+    counters,
+    repaths: Array.from(words.subarray(repathStart, repathStart + reasonCount)),
+    repathFailures: Array.from(words.subarray(repathStart + reasonCount, repathStart + reasonCount * 2)),
+  };
+}
+
+/**
+ * Consistent copy of the telemetry page, or null if it is unavailable or was
+ * being published on every attempt.
+ */
+export function readNavTelemetry(wasm: WasmFacade): NavTelemetry | null {
+  if (!wasm._get_nav_telemetry_ptr) return null;
+  const pagePtr = wasm._get_nav_telemetry_ptr();
+  if (!pagePtr) return null;
+
+  const u32 = wasm.HEAPU32;
+  const h = pagePtr >>> 2;
+  const blockWords = u32[h + 2];
+  const reasonCount = u32[h + 3];
+  if (blockWords !== NAV_COUNTERS.length + reasonCount * 2) {
+    console.error(`NavTelemetry layout mismatch: ${blockWords} words per block`);
+    return null;
+  }
+
+  for (let attempt = 0; attempt < MAX_READ_ATTEMPTS; attempt++) {
+    const seqBefore = Atomics.load(u32, h);
+    if (seqBefore & 1) continue;
+    const copy = u32.slice(h, h + HEADER_WORDS + blockWords * 3);
+    if (Atomics.load(u32, h) !== seqBefore) continue;
+
+    return {
+      frames: copy[1],
+      lastFrame: readBlock(copy, HEADER_WORDS, reasonCount),
+      total: readBlock(copy, HEADER_WORDS + blockWords, reasonCount),
+      peak: readBlock(copy, HEADER_WORDS + blockWords * 2, reasonCount),
+    };
+  }
+  return null;
+}
+
+export function dumpNavTelemetry(wasm: WasmFacade): void {
+  const t = readNavTelemetry(wasm);
+  if (!t) {
+    console.error('Nav telemetry is not available');
+    return;
+  }
+  console.log(`Nav telemetry over ${t.frames} frames`);
+  console.table(NAV_COUNTERS.map(name => ({
+    counter: name,
+    'last frame': t.lastFrame.counters[name],
+    total: t.total.counters[name],
+    'peak frame': t.peak.counters[name],
+  })));
+  console.table(REASON_NAMES.map((reason, i) => ({
+    reason,
+    'last frame': t.lastFrame.repaths[i],
+    total: t.total.repaths[i],
+    'peak frame': t.peak.repaths[i],
+    failures: t.total.repathFailures[i],
+  })));
+}
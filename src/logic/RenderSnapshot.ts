@@ -0,0 +1,58 @@
+import { WasmFacade } from "./WasmFacade";
+
+// Mirrors render_snapshot.h. Header words (u32):
+// [0] seq, [1] latest_slot, [2] capacity, [3] slot_count, then per slot 9 words:
+// active_agents, sim_time (f32), positions_x, positions_y, looks, frame_ids, states,
+// is_alive ptrs, slot seq.
+const HEADER_WORDS = 4;
+const SLOT_WORDS = 9;
+
+export interface RenderSnapshotView {
+  seq: number;
+  activeAgents: number;
+  simTime: number;
+  positions_x: Float32Array;
+  positions_y: Float32Array;
+  looks: Float32Array;
+  frame_ids: Uint16Array;
+  states: Uint8Array;
+  is_alive: Uint8Array;
+}
+
+/**
+ * Views into the most recently published simulation frame. The views alias
+ * WASM memory and stay valid until the sim publishes two more frames; check
+ * renderSnapshotStillValid(view.seq) after reading if that matters.
+ */
+export function readRenderSnapshot(wasm: WasmFacade): RenderSnapshotView | null {
+  if (!wasm._get_render_snapshot_ptr) return null;
+  const headerPtr = wasm._get_render_snapshot_ptr();
+  if (!headerPtr) return null;
+
+  const u32 = wasm.HEAPU32;
+  const h = headerPtr >>> 2;
+  const seq = Atomics.load(u32, h);
+  if (seq === 0) return null;
+  const slot = Atomics.load(u32, h + 1);
+  const w = h + HEADER_WORDS + slot * SLOT_WORDS;
+  const activeAgents = u32[w];
+  const buffer = wasm.HEAPU8.buffer;
+
+  return {
+    seq,
+    activeAgents,
+    simTime: wasm.HEAPF32[w + 1],
+    positions_x: new Float32Array(buffer, u32[w + 2], activeAgents),
+    positions_y: new Float32Array(buffer, u32[w + 3], activeAgents),
+    looks: new Float32Array(buffer, u32[w + 4], activeAgents * 2),
+    frame_ids: new Uint16Array(buffer, u32[w + 5], activeAgents),
+    states: new Uint8Array(buffer, u32[w + 6], activeAgents),
+    is_alive: new Uint8Array(buffer, u32[w + 7], activeAgents),
+  };
+}
+
+export function renderSnapshotStillValid(wasm: WasmFacade, seq: number): boolean {
+  const headerPtr = wasm._get_render_snapshot_ptr ? wasm._get_render_snapshot_ptr() : 0;
+  if (!headerPtr) return false;
+  return (Atomics.load(wasm.HEAPU32, headerPtr >>> 2) - seq) >>> 0 < 2;
+}
@@ -0,0 +1,102 @@
+import { WasmFacade } from "./WasmFacade";
+import { RepathReason } from "./NavTelemetry";
+
+// Mirrors trace_log.h. Header words (u32):
+// [0] records written, [1] capacity, [2] words per record, [3] min level, then records:
+// seq, code | level << 16, agent (i32), sim_time (f32), args[4].
+const HEADER_WORDS = 4;
+
+export enum TraceCode {
+  FIND_PATH = 1,
+  CORRIDOR_INVALID_POLYS = 2,
+  CORRIDOR_ITERATION_LIMIT = 3,
+  CORRIDOR_NO_PATH = 4,
+  UNWALKABLE_TRIANGLE = 5,
+  PREDICAMENT_RESET = 6,
+  NO_CORNER_AFTER_STUCK = 7,
+  PATH_RECOVERY_FAILED = 8,
+  NO_CORNER_AFTER_ESCAPE = 9,
+  END_TARGET_OFF_NAVMESH = 10,
+  CORNER_BLOB_NOT_FOUND = 11,
+  CORNER_BLOB_CLOSEST = 12,
+  UNKNOWN_COMMAND = 13,
+  BAD_COMMAND = 14,
+}
+
+const enum TraceLevel {
+  DEBUG = 0,
+  INFO = 1,
+  WARN = 2,
+  ERROR = 3,
+}
+
+interface TraceArgs {
+  i: Int32Array;
+  f: Float32Array;
+}
+
+const FORMATTERS: Record<number, (a: TraceArgs) => string> = {
+  [TraceCode.FIND_PATH]: a => `findPath from tri ${a.i[0]} to tri ${a.i[1]} (${RepathReason[a.i[2]] ?? a.i[2]})`,
+  [TraceCode.CORRIDOR_INVALID_POLYS]: a => `findCorridor: invalid start or end poly (${a.i[0]} -> ${a.i[1]})`,
+  [TraceCode.CORRIDOR_ITERATION_LIMIT]: a => `findCorridor: iteration limit reached (${a.i[0]} -> ${a.i[1]}, ${a.i[2]} iterations)`,
+  [TraceCode.CORRIDOR_NO_PATH]: a => `findCorridor: no path found (${a.i[0]} -> ${a.i[1]}, ${a.i[2]} iterations)`,
+  [TraceCode.UNWALKABLE_TRIANGLE]: a => `Agent moved into unwalkable triangle ${a.i[1]} (was ${a.i[0]}, walkable count ${a.i[2]})`,
+  [TraceCode.PREDICAMENT_RESET]: a => `Predicament reset at (${a.f[0].toFixed(2)}, ${a.f[1].toFixed(2)})`,
+  [TraceCode.NO_CORNER_AFTER_STUCK]: () => `No corners after stuck repath`,
+  [TraceCode.PATH_RECOVERY_FAILED]: () => `Path recovery failed`,
+  [TraceCode.NO_CORNER_AFTER_ESCAPE]: () => `No corners after escape`,
+  [TraceCode.END_TARGET_OFF_NAVMESH]: () => `End target is outside the navmesh`,
+  [TraceCode.CORNER_BLOB_NOT_FOUND]: a => `No blob found for corner (${a.f[0].toFixed(2)}, ${a.f[1].toFixed(2)}), ${a.i[2]} blobs nearby`,
+  [TraceCode.CORNER_BLOB_CLOSEST]: a => `Closest blob to (${a.f[0].toFixed(2)}, ${a.f[1].toFixed(2)}) is ${a.i[2]} at distance ${a.f[3].toFixed(3)}`,
+  [TraceCode.UNKNOWN_COMMAND]: a => `Unknown event type ${a.i[0]}`,
+  [TraceCode.BAD_COMMAND]: a => `Malformed command of type ${a.i[0]} (${a.i[1]} words), skipped`,
+};
+
+let readIndex = 0;
+const scratch = new ArrayBuffer(16);
+const args: TraceArgs = { i: new Int32Array(scratch), f: new Float32Array(scratch) };
+
+/**
+ * Formats and prints every trace record written since the last call.
+ * Records are only read once their seq word is published, so a record still
+ * being written by the sim thread is left for the next drain.
+ */
+export function drainTraceLog(wasm: WasmFacade): void {
+  if (!wasm._get_trace_log_ptr) return;
+  const headerPtr = wasm._get_trace_log_ptr();
+  if (!headerPtr) return;
+
+  const u32 = wasm.HEAPU32;
+  const h = headerPtr >>> 2;
+  const written = Atomics.load(u32, h);
+  const capacity = u32[h + 1];
+  const recordWords = u32[h + 2];
+
+  if (((written - readIndex) >>> 0) > capacity) {
+    console.warn(`[WASM trace] dropped ${(written - capacity - readIndex) >>> 0} records`);
+    readIndex = (written - capacity) >>> 0;
+  }
+
+  while (readIndex !== written) {
+    const r = h + HEADER_WORDS + (readIndex & (capacity - 1)) * recordWords;
+    if (Atomics.load(u32, r) !== ((readIndex + 1) >>> 0)) break;
+
+    const codeLevel = u32[r + 1];
+    const code = codeLevel & 0xffff;
+    const level = (codeLevel >>> 16) & 0xff;
+    const agent = wasm.HEAP32[r + 2];
+    const simTime = wasm.HEAPF32[r + 3];
+    args.i.set(wasm.HEAP32.subarray(r + 4, r + 8));
+
+    const format = FORMATTERS[code];
+    const text = format ? format(args) : `unknown trace code ${code}`;
+    const line = `[WASM t=${simTime.toFixed(2)}${agent >= 0 ? ` agent=${agent}` : ''}] ${text}`;
+    switch (level) {
+      case TraceLevel.DEBUG: console.debug(line); break;
+      case TraceLevel.INFO: console.info(line); break;
+      case TraceLevel.WARN: console.warn(line); break;
+      default: console.error(line); break;
+    }
+    readIndex = (readIndex + 1) >>> 0;
+  }
+}
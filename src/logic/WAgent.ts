@@ -9,7 +9,7 @@ export function serialize_wagent(gameState: GameState, idx: number) {
   const wasm_agents = gameState.wasm_agents;
   const agent = gameState.wagents.find(a => a.idx === idx);
 
-  if (!wasm_agents.positions || !agent) {
+  if (!wasm_agents.positions_x || !agent) {
     return null;
   }
 
@@ -17,9 +17,9 @@ export function serialize_wagent(gameState: GameState, idx: number) {
     idx: idx,
     display: agent.display,
     // Core physics
-    position: { x: wasm_agents.positions[idx * 2], y: wasm_agents.positions[idx * 2 + 1] },
+    position: { x: wasm_agents.positions_x[idx], y: wasm_agents.positions_y[idx] },
     last_coordinate: { x: wasm_agents.last_coordinates[idx * 2], y: wasm_agents.last_coordinates[idx * 2 + 1] },
-    velocity: { x: wasm_agents.velocities[idx * 2], y: wasm_agents.velocities[idx * 2 + 1] },
+    velocity: { x: wasm_agents.velocities_x[idx], y: wasm_agents.velocities_y[idx] },
     look: { x: wasm_agents.looks[idx * 2], y: wasm_agents.looks[idx * 2 + 1] },
     state: wasm_agents.states[idx],
     is_alive: wasm_agents.is_alive[idx],
@@ -162,7 +162,7 @@ export function updateWAgentGridSpawners(
   if (!spawners) return;
 
   // Skip spawning until WASM agents are initialized
-  if (!gs.wasm_agents.positions || !gs.wasm_agents.is_alive) {
+  if (!gs.wasm_agents.positions_x || !gs.wasm_agents.is_alive) {
     // console.log(`[WASM Grid Spawner] Skipping spawn - WASM agents not initialized`);
     return;
   }
@@ -6,6 +6,8 @@ import { AgentConfigs, type AgentConfig } from "./agents/AgentConfigs";
 import { MAX_AGENTS } from "./agents/Agents";
 import { baseAtlas } from "./BaseAtlas";
 import { Brain, BrainCellType, createBrain } from './agents/ai/Brain';
+import { cmdSpawnBatch } from './agents/EventHandler';
+import { advanceSeed } from './core/mathUtils';
 
 export interface WAgentSpawner {
   config : AgentConfig;
@@ -44,12 +46,12 @@ export function createWasmAgentFromPrototype(gs: GameState, agent: Agent): WAgen
   
   const idx = gs.wagents.length;
   
-  agents.positions[idx * 2] = agent.coordinate.x;
-  agents.positions[idx * 2 + 1] = agent.coordinate.y;
+  agents.positions_x[idx] = agent.coordinate.x;
+  agents.positions_y[idx] = agent.coordinate.y;
   agents.last_coordinates[idx * 2] = agent.coordinate.x;
   agents.last_coordinates[idx * 2 + 1] = agent.coordinate.y;
-  agents.velocities[idx * 2] = 0;
-  agents.velocities[idx * 2 + 1] = 0;
+  agents.velocities_x[idx] = 0;
+  agents.velocities_y[idx] = 0;
   agents.looks[idx * 2] = 1;
   agents.looks[idx * 2 + 1] = 0;
   agents.states[idx] = 0; // Standing
@@ -87,13 +89,42 @@ export function createWasmAgentFromPrototype(gs: GameState, agent: Agent): WAgen
   return wAgent;
 }
 
+// Spawns up to count agents of config at random walkable points of extent
+// ([minX, minY, maxX, maxY]) with one CMD_SPAWN_BATCH; WASM places them when
+// the frame's commands are processed. Slots it cannot place stay dead.
+// Returns the number of slots taken.
+export function spawnWasmAgentBatch(gs: GameState, config: AgentConfig, extent: number[], count: number): number {
+  count = Math.min(count, MAX_AGENTS - gs.wagents.length);
+  if (count <= 0) return 0;
+
+  const prototype = new Agent();
+  Object.assign(prototype, config);
+  const first = gs.wagents.length;
+  for (let i = 0; i < count; i++) {
+    gs.wagents.push(new WAgent(first + i, prototype.display, createBrain(config.brainCells as BrainCellType[])));
+  }
+
+  cmdSpawnBatch(gs.wasm_agents.commands, first, count, gs.rngSeedW, extent, {
+    accel: prototype.accel,
+    resistance: prototype.resistance,
+    intelligence: prototype.intelligence,
+    maxFrustration: prototype.maxFrustration,
+    arrivalDesiredSpeed: prototype.arrivalDesiredSpeed,
+    arrivalThresholdSq: prototype.arrivalThresholdSq,
+    lookSpeed: prototype.lookSpeed,
+    frameId: baseAtlas.getFrameId(prototype.display) ?? 0,
+  });
+  gs.rngSeedW = advanceSeed(gs.rngSeedW);
+  return count;
+}
+
 export function updateWAgentSpawnersBench(spawners: WAgentSpawner[], dt: number, gs: GameState) {
   if (!spawners) {
     return;
   }
 
   // Skip spawning until WASM agents are initialized
-  if (!gs.wasm_agents.positions || !gs.wasm_agents.is_alive) {
+  if (!gs.wasm_agents.positions_x || !gs.wasm_agents.is_alive) {
     console.log(`[WASM Spawner] Skipping spawn - WASM agents not initialized`);
     return;
   }
@@ -137,7 +168,7 @@ export function updateWAgentSpawners(spawners: WAgentSpawner[], dt: number, gs:
   }
 
   // Skip spawning until WASM agents are initialized
-  if (!gs.wasm_agents.positions || !gs.wasm_agents.is_alive) {
+  if (!gs.wasm_agents.positions_x || !gs.wasm_agents.is_alive) {
     console.log(`[WASM Spawner] Skipping spawn - WASM agents not initialized`);
     return;
   }
@@ -1,5 +1,5 @@
 import { Wasm } from "./Wasm";
-import { WasmImpulse } from "./wasm_impulse_codes";
+import { WasmImpulse, SCENARIO_NAMES, ScenarioName } from "./wasm_impulse_codes";
 
 export interface WasmFacade {
   _init_agents: (sharedBuffer: number, maxAgents: number, seed: number, eventsBasePtr: number, eventsCapWords: number) => void;
@@ -8,13 +8,40 @@ export interface WasmFacade {
   _add_agent: (x: number, y: number) => number;
   _update: (dt: number, m3x3Ptr: number, widthPx: number, heightPx: number, dpr: number) => void;
   _update_simulation: (dt: number, active_agents: number) => void;
+  _update_simulation_steps?: (dt: number, steps: number, active_agents: number, emitEveryStep: boolean) => number;
+  _get_sim_steps_stats_ptr?: () => number;
   _load_blob_data: (blobBuffer: number, bufferSize: number) => void;
   _clear_blob_data: () => void;
   _get_blob_count: () => number;
   _g_navTriIndexPackedHeader?: number;
   _set_rng_seed?: (seed: number) => void;
   _set_constants_buffer: (ptr: number, debug : boolean) => void;
-  _set_selected_wagent_idx?: (idx: number) => void;
+
+  // Threaded simulation (see sim_thread.h)
+  _sim_thread_start?: (tickDt: number, maxTicksPerWake: number) => number;
+  _sim_thread_stop?: () => void;
+  _sim_thread_post_frame?: (dt: number, activeAgents: number) => void;
+  _sim_thread_lock?: () => void;
+  _sim_thread_unlock?: () => void;
+  _get_render_snapshot_ptr?: () => number;
+
+  // Shared agent column layout (see agent_layout.h)
+  _get_agent_layout_bytes: (maxAgents: number) => number;
+  _get_agent_layout_ptr: () => number;
+
+  // Binary trace ring (see trace_log.h)
+  _get_trace_log_ptr?: () => number;
+
+  // Per-stage profiler stats page (see profiler.h)
+  _get_profiler_stats_ptr?: () => number;
+
+  // Pathfinding telemetry page (see nav_telemetry.h)
+  _get_nav_telemetry_ptr?: () => number;
+
+  // Simulation snapshots (see sim_snapshot.h)
+  _snapshot_simulation?: (activeAgents: number, basePtr: number, baseBytes: number) => number;
+  _get_sim_snapshot_ptr?: () => number;
+  _restore_simulation?: (dataPtr: number, bytes: number, basePtr: number, baseBytes: number) => number;
   
   // Navmesh data access functions
   _get_g_navmesh_ptr?: () => number;
@@ -25,6 +52,11 @@ export interface WasmFacade {
   // Pathfinding test function
   _test_find_corridor?: (startX: number, startY: number, endX: number, endY: number, pathFreeWidth: number, pathWidthPenaltyMult: number, resultPtr: number, maxLength: number) => number;
   _get_agent_corridor?: (agentIdx: number, resultPtr: number, maxLength: number) => number;
+
+  // Batched navmesh queries (see nav_batch.h)
+  _nav_locate_batch?: (pointsPtr: number, hintsPtr: number, count: number, outPtr: number) => number;
+  _nav_raycast_batch?: (segmentsPtr: number, hintsPtr: number, count: number, outPtr: number, outWords: number) => number;
+  _nav_corridor_batch?: (segmentsPtr: number, hintsPtr: number, count: number, pathFreeWidth: number, pathWidthPenaltyMult: number, outPtr: number, outWords: number) => number;
   
   ccall: (fname: string, returnType: string | null, argTypes: string[], args: any[]) => any;
   cwrap: (fname: string, returnType: string | null, argTypes: string[]) => Function;
@@ -45,11 +77,47 @@ export interface WasmFacade {
   _sprite_renderer_clear?: () => void;
   triggerPointInTriangleBench: () => void;
   triggerPointInPolygonBench: () => void;
-  setSelectedWAgentIdx?: (idx: number | null) => void;
-  // Convenience: request agent's corridor by index (emits via events on next sim update)
-  requestAgentCorridorByIndex?: (idx: number | null) => void;
+  triggerPhysSimdBench: () => void;
+  triggerNavConstantsBench: () => void;
+  // Crowd scenario benchmarks (scenario_bench.h); results are printed to the console
+  triggerScenarioSuite: () => void;
+  triggerScenario: (name: ScenarioName) => void;
+  triggerMicrobenchSuite: () => void;
   // Synchronous fetch of an agent's corridor by index
   getAgentCorridorByIndex?: (idx: number, maxLength?: number) => number[];
+  // Runs `steps` ticks inside WASM; returns the batch totals (StepBatchStats in model.h)
+  fastForward?: (dt: number, steps: number, activeAgents: number, emitEveryStep?: boolean) => StepBatchStats | null;
+  // Copy of the current simulation state; pass a keyframe as base for a delta snapshot
+  snapshotSimulation?: (activeAgents: number, base?: Uint8Array) => Uint8Array | null;
+  // Returns the snapshot's active agent count, or -1 if it was rejected
+  restoreSimulation?: (snapshot: Uint8Array, base?: Uint8Array) => number;
+  // Batched navmesh queries; need no sim thread lock, but not during navmesh load (nav_batch.h)
+  locateBatch?: (points: Float32Array, hints?: Int32Array) => Int32Array | null;
+  raycastBatch?: (segments: Float32Array, hints?: Int32Array) => NavBatchResult | null;
+  corridorBatch?: (segments: Float32Array, pathFreeWidth: number, pathWidthPenaltyMult: number, hints?: Int32Array) => NavBatchResult | null;
+}
+
+// Packed output of a batched query: data holds `count` fixed-size records
+// (NAV_BATCH_RAY_WORDS / NAV_BATCH_PATH_WORDS) followed by the corridors they
+// point at with (offset, length) word pairs.
+export interface NavBatchResult {
+  count: number;
+  recordWords: number;
+  data: Int32Array;
+}
+
+export const NAV_BATCH_LOCATE_WORDS = 2;
+export const NAV_BATCH_RAY_WORDS = 5;
+export const NAV_BATCH_PATH_WORDS = 2;
+
+export interface StepBatchStats {
+  steps: number;
+  aliveAgents: number;
+  repaths: number;
+  astarCalls: number;
+  simTime: number;
+  wallMs: number;
+  maxStepMs: number;
 }
 
 declare global {
@@ -80,20 +148,29 @@ export async function createWasmModule(): Promise<WasmFacade> {
     this._wasm_impulse(WasmImpulse.POINT_IN_POLYGON_BENCH);
   }
 
-  wasmModule.setSelectedWAgentIdx = function(idx: number | null){
-    if (this._set_selected_wagent_idx) {
-      this._set_selected_wagent_idx(idx == null ? -1 : idx|0);
-    }
+  wasmModule.triggerPhysSimdBench = function(){
+    this._wasm_impulse(WasmImpulse.PHYS_SIMD_BENCH);
+  }
+
+  wasmModule.triggerNavConstantsBench = function(){
+    this._wasm_impulse(WasmImpulse.NAV_CONSTANTS_BENCH);
   }
 
-  // TS API: request agent corridor by index.
-  // This leverages the existing selected-agent mechanism in WASM which
-  // broadcasts the selected agent's corridor at the end of the next
-  // simulation update via EVT_SELECTED_CORRIDOR.
-  wasmModule.requestAgentCorridorByIndex = function(idx: number | null){
-  if (typeof this.setSelectedWAgentIdx === 'function') {
-    this.setSelectedWAgentIdx(idx);
+  wasmModule.triggerScenarioSuite = function(){
+    this._wasm_impulse(WasmImpulse.SCENARIO_SUITE);
   }
+
+  wasmModule.triggerScenario = function(name: ScenarioName){
+    const idx = SCENARIO_NAMES.indexOf(name);
+    if (idx === -1) {
+      console.error(`Unknown scenario ${name}; expected one of ${SCENARIO_NAMES.join(', ')}`);
+      return;
+    }
+    this._wasm_impulse(WasmImpulse.SCENARIO_FIRST + idx);
+  }
+
+  wasmModule.triggerMicrobenchSuite = function(){
+    this._wasm_impulse(WasmImpulse.MICROBENCH_SUITE);
   }
 
   // Synchronous API: copies corridor into a TS array immediately.
@@ -117,6 +194,111 @@ export async function createWasmModule(): Promise<WasmFacade> {
   return out;
   }
 
+  wasmModule.fastForward = function(dt: number, steps: number, activeAgents: number, emitEveryStep: boolean = false): StepBatchStats | null {
+  if (!this._update_simulation_steps || !this._get_sim_steps_stats_ptr) return null;
+  if (this._update_simulation_steps(dt, steps|0, activeAgents|0, emitEveryStep) <= 0) return null;
+  const w = this._get_sim_steps_stats_ptr() >>> 2;
+  return {
+    steps: this.HEAPU32[w],
+    aliveAgents: this.HEAPU32[w + 1],
+    repaths: this.HEAPU32[w + 2],
+    astarCalls: this.HEAPU32[w + 3],
+    simTime: this.HEAPF32[w + 4],
+    wallMs: this.HEAPF32[w + 5],
+    maxStepMs: this.HEAPF32[w + 6],
+  };
+  }
+
+  // Grow-only scratch allocation shared by the batch query helpers.
+  let batchScratchPtr = 0;
+  let batchScratchBytes = 0;
+  function batchScratch(module: WasmFacade, bytes: number): number {
+    if (bytes <= batchScratchBytes) return batchScratchPtr;
+    if (batchScratchPtr) module._wasm_free!(batchScratchPtr);
+    batchScratchBytes = Math.max(bytes, batchScratchBytes * 2, 64 * 1024);
+    batchScratchPtr = module._wasm_alloc!(batchScratchBytes);
+    if (!batchScratchPtr) batchScratchBytes = 0;
+    return batchScratchPtr;
+  }
+
+  // Lays out input, hints and output in scratch and retries with a larger
+  // output until every query's corridor fits.
+  function runCorridorBatch(module: WasmFacade, input: Float32Array, hints: Int32Array | undefined, count: number, recordWords: number,
+                            call: (inPtr: number, hintsPtr: number, outPtr: number, outWords: number) => number): NavBatchResult | null {
+    const hintsWords = hints ? count * 2 : 0;
+    let outWords = count * (recordWords + 32);
+    for (;;) {
+      const base = batchScratch(module, (input.length + hintsWords + outWords) * 4);
+      if (!base) return null;
+      module.HEAPF32.set(input, base >>> 2);
+      const hintsPtr = hints ? base + input.length * 4 : 0;
+      if (hints) module.HEAP32.set(hints.subarray(0, hintsWords), hintsPtr >>> 2);
+      const outPtr = base + (input.length + hintsWords) * 4;
+      const answered = call(base, hintsPtr, outPtr, outWords);
+      if (answered === count) {
+        const w = outPtr >>> 2;
+        const last = w + (count - 1) * recordWords + recordWords - 2;
+        const used = count > 0 ? Math.max(count * recordWords, module.HEAP32[last] + module.HEAP32[last + 1]) : 0;
+        return { count, recordWords, data: module.HEAP32.slice(w, w + used) };
+      }
+      outWords *= 2;
+    }
+  }
+
+  wasmModule.locateBatch = function(points: Float32Array, hints?: Int32Array): Int32Array | null {
+  if (!this._nav_locate_batch || !this._wasm_alloc || !this._wasm_free) return null;
+  const count = points.length >> 1;
+  const hintsWords = hints ? count : 0;
+  const base = batchScratch(this, (count * 2 + hintsWords + count * NAV_BATCH_LOCATE_WORDS) * 4);
+  if (!base) return null;
+  this.HEAPF32.set(points.subarray(0, count * 2), base >>> 2);
+  const hintsPtr = hints ? base + count * 8 : 0;
+  if (hints) this.HEAP32.set(hints.subarray(0, count), hintsPtr >>> 2);
+  const outPtr = base + (count * 2 + hintsWords) * 4;
+  this._nav_locate_batch(base, hintsPtr, count, outPtr);
+  return this.HEAP32.slice(outPtr >>> 2, (outPtr >>> 2) + count * NAV_BATCH_LOCATE_WORDS);
+  }
+
+  wasmModule.raycastBatch = function(segments: Float32Array, hints?: Int32Array): NavBatchResult | null {
+  if (!this._nav_raycast_batch || !this._wasm_alloc || !this._wasm_free) return null;
+  const count = segments.length >> 2;
+  return runCorridorBatch(this, segments.subarray(0, count * 4), hints, count, NAV_BATCH_RAY_WORDS,
+    (inPtr, hintsPtr, outPtr, outWords) => this._nav_raycast_batch!(inPtr, hintsPtr, count, outPtr, outWords));
+  }
+
+  wasmModule.corridorBatch = function(segments: Float32Array, pathFreeWidth: number, pathWidthPenaltyMult: number, hints?: Int32Array): NavBatchResult | null {
+  if (!this._nav_corridor_batch || !this._wasm_alloc || !this._wasm_free) return null;
+  const count = segments.length >> 2;
+  return runCorridorBatch(this, segments.subarray(0, count * 4), hints, count, NAV_BATCH_PATH_WORDS,
+    (inPtr, hintsPtr, outPtr, outWords) => this._nav_corridor_batch!(inPtr, hintsPtr, count, pathFreeWidth, pathWidthPenaltyMult, outPtr, outWords));
+  }
+
+  // Copies bytes into a temporary WASM allocation for the duration of fn.
+  function withHeapCopy<T>(module: WasmFacade, bytes: Uint8Array | undefined, fn: (ptr: number) => T): T {
+    if (!bytes || !module._wasm_alloc || !module._wasm_free) return fn(0);
+    const ptr = module._wasm_alloc(bytes.length);
+    try {
+      module.HEAPU8.set(bytes, ptr);
+      return fn(ptr);
+    } finally {
+      module._wasm_free(ptr);
+    }
+  }
+
+  wasmModule.snapshotSimulation = function(activeAgents: number, base?: Uint8Array): Uint8Array | null {
+  if (!this._snapshot_simulation || !this._get_sim_snapshot_ptr) return null;
+  const bytes = withHeapCopy(this, base, (basePtr) => this._snapshot_simulation!(activeAgents|0, basePtr, base ? base.length : 0)) >>> 0;
+  if (bytes === 0) return null;
+  const ptr = this._get_sim_snapshot_ptr() >>> 0;
+  return this.HEAPU8.slice(ptr, ptr + bytes);
+  }
+
+  wasmModule.restoreSimulation = function(snapshot: Uint8Array, base?: Uint8Array): number {
+  if (!this._restore_simulation) return -1;
+  return withHeapCopy(this, snapshot, (dataPtr) =>
+    withHeapCopy(this, base, (basePtr) => this._restore_simulation!(dataPtr, snapshot.length, basePtr, base ? base.length : 0)));
+  }
+
   return wasmModule;
 }
 
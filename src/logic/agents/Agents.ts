@@ -1,14 +1,18 @@
-import { EventBuffer } from "../EventBuffer";
+import { EventRing } from "../EventBuffer";
 import { WAgent } from "../WAgent";
 
 // Maximum number of agents supported by the system
 export const MAX_AGENTS = 36100;
 
+// Column views are created from the WASM layout descriptor (agent_layout.h);
+// property names must match the column names there.
 export class Agents {
   // Core physics
-  public positions! : Float32Array;
+  public positions_x! : Float32Array;
+  public positions_y! : Float32Array;
   public last_coordinates! : Float32Array;
-  public velocities! : Float32Array;
+  public velocities_x! : Float32Array;
+  public velocities_y! : Float32Array;
   public looks! : Float32Array;
   public states! : Uint8Array;
   public is_alive! : Uint8Array;
@@ -49,8 +53,12 @@ export class Agents {
   public arrival_threshold_sqs! : Float32Array;
   public predicament_ratings! : Float32Array;
 
-  // At very end
   public frame_ids! : Uint16Array;
 
-  public events!: EventBuffer;
+  // Column name -> AGENT_COLUMNS index, for CMD_SET_PARAMS
+  public columnIds: Record<string, number> = {};
+
+  // TS -> WASM commands and WASM -> TS events (event_buffer.h)
+  public commands!: EventRing;
+  public events!: EventRing;
 }
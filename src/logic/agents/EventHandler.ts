@@ -1,12 +1,21 @@
-import { EventBuffer } from "../EventBuffer";
+import { EventRing } from "../EventBuffer";
 import { GameState } from "../GameState";
 import { dynamicScene } from "../drawing/DynamicScene";
+import { Point2 } from "../core/math";
+import { Agents } from "./Agents";
 
 
 export enum AgentEventType {
   NONE = 0,
   CMD_SET_CORRIDOR = 1,
-  EVT_SELECTED_CORRIDOR = 2,
+  CMD_FIND_PATH = 5,
+  EVT_PATH_RESULT = 6,
+  CMD_SET_TARGETS = 7,
+  CMD_SET_PARAMS = 8,
+  CMD_SPAWN_BATCH = 9,
+  CMD_WATCH_AGENTS = 10,
+  EVT_CORRIDOR_DELTA = 11,
+  EVT_AGENT_STATE = 12,
 }
 
 export enum CorridorAction {
@@ -15,24 +24,84 @@ export enum CorridorAction {
   SET_AND_RECALC_CORNERS = 3,
 }
 
+// Flags of cmdFindPath (PathRequestFlags in path_workers.h).
+export enum PathRequestFlags {
+  NONE = 0,
+  APPLY_TO_AGENT = 1,
+  NO_CORRIDOR = 2,
+}
+
+// Flags of cmdSetTargets (SetTargetsFlags in event_handler.h).
+export enum SetTargetsFlags {
+  NONE = 0,
+  FIND_PATH = 1,
+}
+
+// Fields of watchAgents (AgentWatchFields in agent_watch.h).
+export enum AgentWatchFields {
+  NONE = 0,
+  CORRIDOR = 1,
+  STATE = 2,
+  CORNERS = 4,
+}
+
+export interface WatchedAgentState {
+  state: number;
+  cornerCount: number;
+  corners: number[]; // x, y of next_corners then next_corners2
+}
+
+export interface PathResult {
+  agent: number; // -1 if the request named none
+  found: boolean;
+  length: number; // polygons, also with NO_CORRIDOR
+  corridor: number[]; // end polygon first, as agent corridors; empty with NO_CORRIDOR
+}
+
 export function handleEvents(gs: GameState) {
   const events = gs.wasm_agents.events;
-  while (events.u32[events.cursor] != 0) {
-    const header = events.u32[events.cursor];
-    const type = header & 0xffff;
-    const size = (header >> 16) & 0xffff;
+  for (let e = events.front(); e >= 0; e = events.front()) {
+    const size = events.u32[e];
+    const type = events.u32[e + 1];
+    const p = e + 2; // payload
     switch (type) {
-      case AgentEventType.EVT_SELECTED_CORRIDOR: {
-        const agentIdx = events.u32[events.cursor + 1] | 0;
-        const count = size - 2;
-        const corridor: number[] = new Array(count);
-        for (let i = 0; i < count; i++) {
-          corridor[i] = events.u32[events.cursor + 2 + i] | 0;
+      case AgentEventType.EVT_CORRIDOR_DELTA: {
+        const agentIdx = events.u32[p];
+        let corridor = gs.watchedCorridors.get(agentIdx);
+        if (!corridor) {
+          corridor = [];
+          gs.watchedCorridors.set(agentIdx, corridor);
         }
-        // Publish to DynamicScene
+        corridor.length = Math.min(corridor.length, events.u32[p + 1]);
+        for (let i = p + 2; i < e + size; i++) {
+          corridor.push(events.u32[i] | 0);
+        }
+        // Publish to DynamicScene (a copy, so the reactive scene sees a change)
         if (dynamicScene.selectedWAgentIdx === agentIdx) {
-          dynamicScene.selectedWAgentCorridor = corridor;
+          dynamicScene.selectedWAgentCorridor = corridor.slice();
+        }
+        break;
+      }
+      case AgentEventType.EVT_AGENT_STATE: {
+        gs.watchedAgentStates.set(events.u32[p], {
+          state: events.u32[p + 1],
+          cornerCount: events.u32[p + 2],
+          corners: [events.f32[p + 3], events.f32[p + 4], events.f32[p + 5], events.f32[p + 6]],
+        });
+        break;
+      }
+      case AgentEventType.EVT_PATH_RESULT: {
+        const polys = size - 6;
+        const corridor: number[] = new Array(polys);
+        for (let i = 0; i < polys; i++) {
+          corridor[i] = events.u32[p + 4 + i] | 0;
         }
+        gs.pathResults.set(events.u32[p], {
+          agent: events.u32[p + 1] | 0,
+          found: events.u32[p + 2] !== 0,
+          length: events.u32[p + 3],
+          corridor,
+        });
         break;
       }
       // case AgentEventType.NONE:
@@ -42,18 +111,188 @@ export function handleEvents(gs: GameState) {
         // console.warn(`Unknown event type from WASM: ${type}`);
         break;
     }
-    events.cursor += size;
+    events.pop();
   }
 }
 
-export function cmdSetCorridor(buf: EventBuffer, agent_index: number, corridor1: number[], action: CorridorAction) {
-  const sizeWords = 3 + corridor1.length; // header + agent + action + N polys
-  buf.writeHeader(AgentEventType.CMD_SET_CORRIDOR, sizeWords);
-  const base = buf.cursor + 1; // payload starts after header
-  buf.u32[base] = agent_index >>> 0;
-  buf.u32[base + 1] = action >>> 0;
+// Commands are visible to WASM once the caller publishes the ring; a full ring
+// drops them (counted in EventRing.stats()).
+export function cmdSetCorridor(buf: EventRing, agent_index: number, corridor1: number[], action: CorridorAction) {
+  const sizeWords = 4 + corridor1.length; // size + type + agent + action + N polys
+  const e = buf.reserve(AgentEventType.CMD_SET_CORRIDOR, sizeWords);
+  if (e < 0) return;
+  buf.u32[e + 2] = agent_index >>> 0;
+  buf.u32[e + 3] = action >>> 0;
   for (let i = 0; i < corridor1.length; i++) {
-    buf.u32[base + 2 + i] = corridor1[i] >>> 0;
+    buf.u32[e + 4 + i] = corridor1[i] >>> 0;
+  }
+}
+
+// Asynchronous A* on the WASM path workers. The result arrives as
+// EVT_PATH_RESULT in gs.pathResults under id, usually on the next frame (a
+// long search comes later); with APPLY_TO_AGENT the agent is already
+// following it by then.
+export function cmdFindPath(buf: EventRing, id: number, agent_index: number, start: Point2, end: Point2, flags: PathRequestFlags) {
+  const sizeWords = 9; // size + type + id + agent + flags + startX, startY, endX, endY
+  const e = buf.reserve(AgentEventType.CMD_FIND_PATH, sizeWords);
+  if (e < 0) return;
+  buf.u32[e + 2] = id >>> 0;
+  buf.u32[e + 3] = agent_index >>> 0;
+  buf.u32[e + 4] = flags >>> 0;
+  buf.f32[e + 5] = start.x;
+  buf.f32[e + 6] = start.y;
+  buf.f32[e + 7] = end.x;
+  buf.f32[e + 8] = end.y;
+}
+
+// Targets queued by brains this frame, sent as one CMD_SET_TARGETS by
+// flushQueuedTargets: 4 words per agent (agent, x, y, tri).
+const queuedTargets: number[] = [];
+
+// tri may be -1 to have WASM look it up.
+export function queueTarget(agent_index: number, x: number, y: number, tri: number) {
+  queuedTargets.push(agent_index, x, y, tri);
+}
+
+export function flushQueuedTargets(buf: EventRing, flags: SetTargetsFlags) {
+  const count = queuedTargets.length / 4;
+  if (count === 0) return;
+  const e = buf.reserve(AgentEventType.CMD_SET_TARGETS, 4 + count * 4); // size + type + flags + count + entries
+  queuedTargets.length = 0;
+  if (e < 0) return;
+  buf.u32[e + 2] = flags >>> 0;
+  buf.u32[e + 3] = count;
+  for (let i = 0; i < count; i++) {
+    const q = i * 4;
+    const w = e + 4 + q;
+    buf.u32[w] = queuedTargets[q] >>> 0;
+    buf.f32[w + 1] = queuedTargets[q + 1];
+    buf.f32[w + 2] = queuedTargets[q + 2];
+    buf.u32[w + 3] = queuedTargets[q + 3] >>> 0;
+  }
+}
+
+// One agent's CMD_SET_TARGETS, sent at once instead of with the frame's queue
+// so that a CMD_SET_CORRIDOR for the agent can follow it.
+export function cmdSetTarget(buf: EventRing, agent_index: number, x: number, y: number, tri: number, flags: SetTargetsFlags) {
+  const e = buf.reserve(AgentEventType.CMD_SET_TARGETS, 8); // size + type + flags + count + one entry
+  if (e < 0) return;
+  buf.u32[e + 2] = flags >>> 0;
+  buf.u32[e + 3] = 1;
+  buf.u32[e + 4] = agent_index >>> 0;
+  buf.f32[e + 5] = x;
+  buf.f32[e + 6] = y;
+  buf.u32[e + 7] = tri >>> 0;
+}
+
+// Writes column (an Agents column name) for agents [first, first + count):
+// values holds one element per agent (two numbers for x/y columns), or is a
+// single number written to all of them.
+export function cmdSetParams(buf: EventRing, agents: Agents, column: string, first: number, count: number, values: ArrayLike<number> | number) {
+  const view = (agents as unknown as Record<string, ArrayLike<number>>)[column];
+  const id = agents.columnIds[column];
+  if (id === undefined) {
+    console.warn(`cmdSetParams: unknown agent column ${column}`);
+    return;
   }
-  buf.cursor += sizeWords;
+  const isFloat = view instanceof Float32Array;
+  const words = view.length / agents.is_alive.length; // 2 for x/y columns
+  const broadcast = typeof values === "number";
+  const valueWords = broadcast ? words : count * words;
+  const e = buf.reserve(AgentEventType.CMD_SET_PARAMS, 6 + valueWords); // size + type + column + first + count + broadcast + values
+  if (e < 0) return;
+  buf.u32[e + 2] = id;
+  buf.u32[e + 3] = first >>> 0;
+  buf.u32[e + 4] = count >>> 0;
+  buf.u32[e + 5] = broadcast ? 1 : 0;
+  for (let i = 0; i < valueWords; i++) {
+    const v = typeof values === "number" ? values : values[i];
+    if (isFloat) buf.f32[e + 6 + i] = v;
+    else buf.u32[e + 6 + i] = v >>> 0;
+  }
+}
+
+export interface SpawnBatchParams {
+  accel: number;
+  resistance: number;
+  intelligence: number;
+  maxFrustration: number;
+  arrivalDesiredSpeed: number;
+  arrivalThresholdSq: number;
+  lookSpeed: number;
+  frameId: number;
+}
+
+// Spawns agents [first, first + count) at random walkable points of
+// [minX, minY]-[maxX, maxY]; slots WASM cannot place stay dead.
+export function cmdSpawnBatch(buf: EventRing, first: number, count: number, seed: number, extent: number[], p: SpawnBatchParams) {
+  const e = buf.reserve(AgentEventType.CMD_SPAWN_BATCH, 17); // size + type + first + count + seed + extent + 7 params + frame id
+  if (e < 0) return;
+  buf.u32[e + 2] = first >>> 0;
+  buf.u32[e + 3] = count >>> 0;
+  buf.u32[e + 4] = seed >>> 0;
+  buf.f32[e + 5] = extent[0];
+  buf.f32[e + 6] = extent[1];
+  buf.f32[e + 7] = extent[2];
+  buf.f32[e + 8] = extent[3];
+  buf.f32[e + 9] = p.accel;
+  buf.f32[e + 10] = p.resistance;
+  buf.f32[e + 11] = p.intelligence;
+  buf.f32[e + 12] = p.maxFrustration;
+  buf.f32[e + 13] = p.arrivalDesiredSpeed;
+  buf.f32[e + 14] = p.arrivalThresholdSq;
+  buf.f32[e + 15] = p.lookSpeed;
+  buf.u32[e + 16] = p.frameId >>> 0;
+}
+
+export function cmdWatchAgents(buf: EventRing, agent_indices: ArrayLike<number>, fields: AgentWatchFields) {
+  const count = agent_indices.length;
+  const e = buf.reserve(AgentEventType.CMD_WATCH_AGENTS, 4 + count); // size + type + fields + count + agents
+  if (e < 0) return;
+  buf.u32[e + 2] = fields >>> 0;
+  buf.u32[e + 3] = count;
+  for (let i = 0; i < count; i++) {
+    buf.u32[e + 4 + i] = agent_indices[i] >>> 0;
+  }
+}
+
+// Drops what TS holds for fields no longer watched.
+function pruneWatched(gs: GameState, agent_index: number, fields: number) {
+  if (!(fields & AgentWatchFields.CORRIDOR)) gs.watchedCorridors.delete(agent_index);
+  if (!(fields & (AgentWatchFields.STATE | AgentWatchFields.CORNERS))) gs.watchedAgentStates.delete(agent_index);
+}
+
+// Sends agent_index's watch fields, the selected agent's corridor included.
+function sendWatch(gs: GameState, agent_index: number) {
+  const selected = dynamicScene.selectedWAgentIdx === agent_index ? AgentWatchFields.CORRIDOR : 0;
+  const fields = (gs.agentWatchFields.get(agent_index) ?? 0) | selected;
+  pruneWatched(gs, agent_index, fields);
+  cmdWatchAgents(gs.wasm_agents.commands, [agent_index], fields);
+}
+
+// Subscribes agents to fields (NONE unsubscribes); WASM then reports changes
+// into gs.watchedCorridors and gs.watchedAgentStates.
+export function watchAgents(gs: GameState, agent_indices: number[], fields: AgentWatchFields) {
+  const batch: number[] = [];
+  for (const idx of agent_indices) {
+    if (fields === AgentWatchFields.NONE) gs.agentWatchFields.delete(idx);
+    else gs.agentWatchFields.set(idx, fields);
+    if (idx === dynamicScene.selectedWAgentIdx) {
+      sendWatch(gs, idx);
+    } else {
+      pruneWatched(gs, idx, fields);
+      batch.push(idx);
+    }
+  }
+  if (batch.length > 0) cmdWatchAgents(gs.wasm_agents.commands, batch, fields);
+}
+
+// Selects the WASM agent whose corridor the dynamic scene draws.
+export function selectWAgent(gs: GameState, agent_index: number | null) {
+  const previous = dynamicScene.selectedWAgentIdx;
+  dynamicScene.selectedWAgentIdx = agent_index;
+  // An already watched corridor is not resent; start from what TS has.
+  dynamicScene.selectedWAgentCorridor = agent_index === null ? null : gs.watchedCorridors.get(agent_index)?.slice() ?? null;
+  if (previous !== null && previous !== agent_index) sendWatch(gs, previous);
+  if (agent_index !== null) sendWatch(gs, agent_index);
 }
@@ -24,4 +24,10 @@ export const NavConst = {
   CORNER_OFFSET_SQ: 2.1 * 2.1,
   PATH_FREE_WIDTH: 70,
   PATH_WIDTH_PENALTY_MULT: 3,
+
+  // Extra A* edge cost for entering a packed polygon, as a share of its length; 0 = off.
+  CONGESTION_COST_MULT: 0,
+  // Share of a polygon's crowding still remembered after one second.
+  CONGESTION_DECAY: 0.3,
+  CONGESTION_UPDATE_FRAMES: 4,
 }; 
\ No newline at end of file
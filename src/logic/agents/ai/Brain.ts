@@ -4,7 +4,7 @@ import { getRandomTriangleInArea, getTriangleFromPoint } from "../../navmesh/Nav
 import { WAgent } from "../../WAgent";
 import { AgentState, STUCK_DANGER_1 } from "../Agent";
 import { Agents } from "../Agents";
-import { cmdSetCorridor, CorridorAction } from "../EventHandler";
+import { cmdSetCorridor, cmdSetParams, cmdSetTarget, CorridorAction, queueTarget, SetTargetsFlags } from "../EventHandler";
 import { raycastCorridor } from "../../Raycasting";
 import { Point2, set, getLineSegmentIntersectionPoint, lineLineIntersect } from "../../core/math";
 import { NavConst } from "../NavConst";
@@ -26,18 +26,18 @@ export enum BrainCellType{
 }
 
 
+// Brains read agent data directly but change it only through commands, which
+// WASM applies before the next brain pass (Model.ts). CMD_SET_TARGETS sets the
+// end target, resets the predicament rating, clears the corridor and makes the
+// agent Traveling; the frame's queued targets also schedule the path search.
 function update_random_journey(gs: GameState, a: WAgent, dt: number): void {
-  if (gs.wasm_agents.states[a.idx] == AgentState.Standing) {
-    const data = gs.wasm_agents;
+  const data = gs.wasm_agents;
+  if (data.states[a.idx] == AgentState.Standing && data.is_alive[a.idx]) {
     const navmesh = gs.navmesh;
     const endNode = getRandomTriangleInArea(navmesh, 0, 0, 30, gs.rngSeedW);
     gs.rngSeedW = advanceSeed(gs.rngSeedW);
 
-    data.end_targets[a.idx * 2] = navmesh.triangle_centroids[endNode * 2];
-    data.end_targets[a.idx * 2 + 1] = navmesh.triangle_centroids[endNode * 2 + 1];
-    data.end_target_tris[a.idx] = endNode;
-    data.predicament_ratings[a.idx] = 0;
-    data.states[a.idx] = AgentState.Traveling;
+    queueTarget(a.idx, navmesh.triangle_centroids[endNode * 2], navmesh.triangle_centroids[endNode * 2 + 1], endNode);
   }
 }
 
@@ -58,9 +58,9 @@ export class WanderDirCell implements BrainCell{
     if (gs.wasm_agents.states[a.idx] === AgentState.Standing || gs.gameTime >= this.endAt){
       const data = gs.wasm_agents;
       const navmesh = gs.navmesh;
-      data.predicament_ratings[a.idx] = 0;
+      cmdSetParams(data.commands, data, "predicament_ratings", a.idx, 1, 0);
       // Choose a random direction, raycast ~150m; use entire corridor
-      set(raycastPoint, data.positions[a.idx * 2], data.positions[a.idx * 2 + 1]);
+      set(raycastPoint, data.positions_x[a.idx], data.positions_y[a.idx]);
 
       const r1 = seededRandom(gs.rngSeedW); gs.rngSeedW = r1.newSeed;
       const angle = r1.value * Math.PI * 2;
@@ -109,10 +109,6 @@ export class WanderDirCell implements BrainCell{
         endX = raycastEndPoint.x;
         endY = raycastEndPoint.y;
       }
-      data.end_targets[a.idx * 2] = endX;
-      data.end_targets[a.idx * 2 + 1] = endY;
-      data.end_target_tris[a.idx] = endTri;
-
       // Estimate travel time from distance/maxSpeed; pick 50-100% of it
       const maxSpeed = Math.max(1e-3, data.max_speeds[a.idx] || 1);
       const dxTot = endX - raycastPoint.x;
@@ -122,8 +118,8 @@ export class WanderDirCell implements BrainCell{
       const factor = 0.5 + 0.5 * rLen.value; // 50–100%
       this.endAt = gs.gameTime + (dist / maxSpeed) * factor;
 
-      cmdSetCorridor(gs.wasm_agents.events, a.idx, polyCorridor, CorridorAction.SET_AND_STRAIGHT_CORNER);
-      data.states[a.idx] = AgentState.Traveling;
+      cmdSetTarget(data.commands, a.idx, endX, endY, endTri, SetTargetsFlags.NONE);
+      cmdSetCorridor(data.commands, a.idx, polyCorridor, CorridorAction.SET_AND_STRAIGHT_CORNER);
     }
   }
 }
@@ -142,9 +138,9 @@ export class WanderFloatCell implements BrainCell{
     // Choose a neighboring walkable polygon weighted by edge length
     const navmesh = gs.navmesh;
     const data = gs.wasm_agents;
-    data.predicament_ratings[a.idx] = 0;
-    data.stuck_ratings[a.idx] = 0;
-    data.path_frustrations[a.idx] = 0;
+    cmdSetParams(data.commands, data, "predicament_ratings", a.idx, 1, 0);
+    cmdSetParams(data.commands, data, "stuck_ratings", a.idx, 1, 0);
+    cmdSetParams(data.commands, data, "path_frustrations", a.idx, 1, 0);
     let startTri = data.current_tris[a.idx];
     const curPoly = navmesh.triangle_to_polygon[startTri];
 
@@ -183,8 +179,8 @@ export class WanderFloatCell implements BrainCell{
     }
 
     // Current position for distance checks
-    const curX = data.positions[a.idx * 2];
-    const curY = data.positions[a.idx * 2 + 1];
+    const curX = data.positions_x[a.idx];
+    const curY = data.positions_y[a.idx];
 
     // First try: pick a point inside neighbor poly, up to 5 attempts, >=10m away
     const MIN_DIST = 10.0;
@@ -192,11 +188,8 @@ export class WanderFloatCell implements BrainCell{
     if (first) {
       corridor.length = 0;
       corridor.push(nextPoly, curPoly);
-      data.end_targets[a.idx * 2] = first.x;
-      data.end_targets[a.idx * 2 + 1] = first.y;
-      data.end_target_tris[a.idx] = first.tri;
-      cmdSetCorridor(gs.wasm_agents.events, a.idx, corridor, CorridorAction.SET_AND_STRAIGHT_CORNER);
-      gs.wasm_agents.states[a.idx] = AgentState.Traveling;
+      cmdSetTarget(data.commands, a.idx, first.x, first.y, first.tri, SetTargetsFlags.NONE);
+      cmdSetCorridor(data.commands, a.idx, corridor, CorridorAction.SET_AND_STRAIGHT_CORNER);
       return;
     }
 
@@ -238,11 +231,8 @@ export class WanderFloatCell implements BrainCell{
 
     corridor.length = 0;
     corridor.push(nextPoly2, nextPoly, curPoly);
-    data.end_targets[a.idx * 2] = second.x;
-    data.end_targets[a.idx * 2 + 1] = second.y;
-    data.end_target_tris[a.idx] = second.tri;
-    cmdSetCorridor(gs.wasm_agents.events, a.idx, corridor, CorridorAction.SET_AND_RECALC_CORNERS);
-    gs.wasm_agents.states[a.idx] = AgentState.Traveling;
+    cmdSetTarget(data.commands, a.idx, second.x, second.y, second.tri, SetTargetsFlags.NONE);
+    cmdSetCorridor(data.commands, a.idx, corridor, CorridorAction.SET_AND_RECALC_CORNERS);
   }
 }
 
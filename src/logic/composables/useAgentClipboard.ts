@@ -37,13 +37,13 @@ function customStringify(obj: any): string {
 
 function findNearestWAgent(gameState: GameState, x: number, y: number): WAgent | null {
   const wasm_agents = gameState.wasm_agents;
-  if (!wasm_agents.positions) return null;
+  if (!wasm_agents.positions_x) return null;
   let nearest: WAgent | null = null;
   let minDist = Infinity;
   for (const agent of gameState.wagents) {
     const idx = agent.idx;
-    const ax = wasm_agents.positions[idx * 2];
-    const ay = wasm_agents.positions[idx * 2 + 1];
+    const ax = wasm_agents.positions_x[idx];
+    const ay = wasm_agents.positions_y[idx];
     const dx = ax - x;
     const dy = ay - y;
     const d2 = dx * dx + dy * dy;
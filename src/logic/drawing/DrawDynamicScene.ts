@@ -52,11 +52,11 @@ export class DrawDynamicScene {
     primitives.clear();
 
     const selIdx = dynamicScene.selectedWAgentIdx;
-    if (typeof selIdx === 'number' && selIdx !== null && gameState.wasm_agents.positions) {
+    if (typeof selIdx === 'number' && selIdx !== null && gameState.wasm_agents.positions_x) {
       const agents = gameState.wasm_agents;
       const navmesh = gameState.navmesh;
 
-      const startPoint = { x: agents.positions[selIdx * 2], y: agents.positions[selIdx * 2 + 1] };
+      const startPoint = { x: agents.positions_x[selIdx], y: agents.positions_y[selIdx] };
       const endPoint = { x: agents.end_targets[selIdx * 2], y: agents.end_targets[selIdx * 2 + 1] };
 
       const corridor = dynamicScene.selectedWAgentCorridor || [];
@@ -2,6 +2,9 @@ import * as PIXI from 'pixi.js';
 import { BaseAgentSpritePool, AgentSpriteElements } from './BaseAgentSpritePool';
 import { Agents } from '../agents/Agents';
 import type { AgentRenderingMode } from './AgentRenderer';
+import { SIM_THREADED } from '../initializers/WasmInit';
+import { WasmFacade } from '../WasmFacade';
+import { readRenderSnapshot } from '../RenderSnapshot';
 
 export class WasmAgentSpritePool extends BaseAgentSpritePool {
   private enabled: boolean = false;
@@ -33,7 +36,7 @@ export class WasmAgentSpritePool extends BaseAgentSpritePool {
     }
 
     // Check if WASM agents are initialized and we have active agents
-    if (!agents.positions || !agents.is_alive || wagentsCount === 0) {
+    if (!agents.positions_x || !agents.is_alive || wagentsCount === 0) {
       if (this.wasRenderingEnabled) {
         this.removeAllAgentsFromContainers(container);
         this.wasRenderingEnabled = false;
@@ -44,14 +47,23 @@ export class WasmAgentSpritePool extends BaseAgentSpritePool {
     this.wasRenderingEnabled = true;
     this.drawnCounts.clear();
 
+    // The live SoA is being written by the sim thread; draw its last published frame instead.
+    let src: Pick<Agents, 'positions_x' | 'positions_y' | 'looks' | 'frame_ids' | 'is_alive'> = agents;
+    if (SIM_THREADED) {
+      const snap = readRenderSnapshot(WasmFacade);
+      if (!snap) return;
+      src = snap;
+      wagentsCount = Math.min(wagentsCount, snap.activeAgents);
+    }
+
     // Iterate over allocated agent slots, skipping dead agents
     for (let i = 0; i < wagentsCount; i++) {
       // Skip dead agents
-      if (!agents.is_alive[i]) {
+      if (!src.is_alive[i]) {
         continue;
       }
 
-      const fid = (agents.frame_ids && agents.frame_ids.length > i) ? agents.frame_ids[i] : 0;
+      const fid = (src.frame_ids && src.frame_ids.length > i) ? src.frame_ids[i] : 0;
       const displayName = this.getFrameNameById(fid);
       if (!this.pools.has(displayName)) {
         this.pools.set(displayName, []);
@@ -69,9 +81,9 @@ export class WasmAgentSpritePool extends BaseAgentSpritePool {
       }
       
       const { sprite } = element;
-      sprite.x = agents.positions[i * 2];
-      sprite.y = -agents.positions[i * 2 + 1];
-      sprite.rotation = Math.atan2(-agents.looks[i * 2 + 1], agents.looks[i * 2]) - Math.PI / 2;
+      sprite.x = src.positions_x[i];
+      sprite.y = -src.positions_y[i];
+      sprite.rotation = Math.atan2(-src.looks[i * 2 + 1], src.looks[i * 2]) - Math.PI / 2;
       const AGENT_SPRITE_SCALE = 0.3;
       sprite.scale.set(AGENT_SPRITE_SCALE);
       this.ensureInContainer(element, container);
@@ -1,7 +1,7 @@
 import { Agents, MAX_AGENTS } from "../agents/Agents";
 import { WasmFacade } from "../WasmFacade";
 import { GameState } from "../GameState";
-import { EVENT_BUFFER_WORDS, EventBuffer } from "../EventBuffer";
+import { EVENT_BUFFER_WORDS, EventRing, eventRingBytes } from "../EventBuffer";
 
 function calculateAgentGridMemory(): number {
   const CELL_SIZE = 256.0;
@@ -21,64 +21,14 @@ function calculateAgentGridMemory(): number {
   return cell_data_size + cell_offsets_size + cell_counts_size;
 }
 
-export function calculateAgentsMemory(): number {
-  const sizeOfPoint2 = 2 * 4; // 8 bytes
-  const sizeOfInt = 4;
-  const sizeOfFloat = 4;
-  const sizeOfUint8 = 1;
-  const sizeOfBool = 1;
-
+export function calculateAgentsMemory(wasmModule: WasmFacade): number {
   let totalSize = 0;
 
-  // Core physics
-  totalSize += sizeOfPoint2 * MAX_AGENTS; // positions
-  totalSize += sizeOfPoint2 * MAX_AGENTS; // last_coordinates
-  totalSize += sizeOfPoint2 * MAX_AGENTS; // velocities
-  totalSize += sizeOfPoint2 * MAX_AGENTS; // looks
-  totalSize += sizeOfUint8 * MAX_AGENTS; // states
-  totalSize += sizeOfBool * MAX_AGENTS; // is_alive
-
-  // Navigation data
-  totalSize += sizeOfInt * MAX_AGENTS; // current_tris
-  totalSize += sizeOfPoint2 * MAX_AGENTS; // next_corners
-  totalSize += sizeOfInt * MAX_AGENTS; // next_corner_tris
-  totalSize += sizeOfPoint2 * MAX_AGENTS; // next_corners2
-  totalSize += sizeOfInt * MAX_AGENTS; // next_corner_tris2
-  totalSize += sizeOfUint8 * MAX_AGENTS; // num_valid_corners
-  totalSize += sizeOfPoint2 * MAX_AGENTS; // pre_escape_corners
-  totalSize += sizeOfInt * MAX_AGENTS; // pre_escape_corner_tris
-  totalSize += sizeOfPoint2 * MAX_AGENTS; // end_targets
-  totalSize += sizeOfInt * MAX_AGENTS; // end_target_tris
-  totalSize += sizeOfPoint2 * MAX_AGENTS; // last_valid_positions
-  totalSize += sizeOfInt * MAX_AGENTS; // last_valid_tris
-  totalSize += sizeOfFloat * MAX_AGENTS; // stuck_ratings
-  totalSize += sizeOfFloat * MAX_AGENTS; // path_frustrations
-  totalSize += sizeOfInt * MAX_AGENTS; // alien_polys
-  totalSize += sizeOfPoint2 * MAX_AGENTS; // last_visible_points_for_next_corner
-
-  // Statistics
-  totalSize += sizeOfPoint2 * MAX_AGENTS; // last_end_targets
-  totalSize += sizeOfInt * MAX_AGENTS; // min_corridor_lengths
-  totalSize += sizeOfFloat * MAX_AGENTS; // last_distances_to_next_corner
-  totalSize += sizeOfFloat * MAX_AGENTS; // sight_ratings
-  totalSize += sizeOfInt * MAX_AGENTS; // last_next_corner_tris
+  // Shared agent columns, laid out by WASM (agent_layout.h); +16 for start alignment
+  totalSize += wasmModule._get_agent_layout_bytes(MAX_AGENTS) + 16;
 
-  // Parameters
-  totalSize += sizeOfFloat * MAX_AGENTS; // max_speeds
-  totalSize += sizeOfFloat * MAX_AGENTS; // accels
-  totalSize += sizeOfFloat * MAX_AGENTS; // resistances
-  totalSize += sizeOfFloat * MAX_AGENTS; // intelligences
-  totalSize += sizeOfFloat * MAX_AGENTS; // arrival_desired_speeds
-  totalSize += sizeOfFloat * MAX_AGENTS; // look_speeds
-  totalSize += sizeOfFloat * MAX_AGENTS; // max_frustrations
-  totalSize += sizeOfFloat * MAX_AGENTS; // arrival_threshold_sqs
-  totalSize += sizeOfFloat * MAX_AGENTS; // predicament_ratings
-
-  // At very end: frame_ids
-  totalSize += 2 * MAX_AGENTS; // frame_ids (uint16)
-
-  // Events buffer (single stream, word-addressable)
-  totalSize += EVENT_BUFFER_WORDS * 4; // u32 words
+  // Command and event rings
+  totalSize += eventRingBytes(EVENT_BUFFER_WORDS) * 2;
 
   // C++ dynamic allocations
   totalSize += calculateAgentGridMemory();
@@ -96,131 +46,73 @@ export function initializeAgents(
   buffer: ArrayBuffer, 
   offset: number
 ): number {
-  let currentOffset = offset;
-
-  // Core physics
-  agents.positions = new Float32Array(buffer, currentOffset, MAX_AGENTS * 2);
-  currentOffset += MAX_AGENTS * 2 * 4;
-
-  agents.last_coordinates = new Float32Array(buffer, currentOffset, MAX_AGENTS * 2);
-  currentOffset += MAX_AGENTS * 2 * 4;
-
-  agents.velocities = new Float32Array(buffer, currentOffset, MAX_AGENTS * 2);
-  currentOffset += MAX_AGENTS * 2 * 4;
-
-  agents.looks = new Float32Array(buffer, currentOffset, MAX_AGENTS * 2);
-  currentOffset += MAX_AGENTS * 2 * 4;
-
-  agents.states = new Uint8Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 1;
-
-  agents.is_alive = new Uint8Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 1;
-
-  // Navigation data
-  agents.current_tris = new Int32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.next_corners = new Float32Array(buffer, currentOffset, MAX_AGENTS * 2);
-  currentOffset += MAX_AGENTS * 2 * 4;
-
-  agents.next_corner_tris = new Int32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.next_corners2 = new Float32Array(buffer, currentOffset, MAX_AGENTS * 2);
-  currentOffset += MAX_AGENTS * 2 * 4;
-
-  agents.next_corner_tris2 = new Int32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.num_valid_corners = new Uint8Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 1;
-
-  agents.pre_escape_corners = new Float32Array(buffer, currentOffset, MAX_AGENTS * 2);
-  currentOffset += MAX_AGENTS * 2 * 4;
-
-  agents.pre_escape_corner_tris = new Int32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.end_targets = new Float32Array(buffer, currentOffset, MAX_AGENTS * 2);
-  currentOffset += MAX_AGENTS * 2 * 4;
-
-  agents.end_target_tris = new Int32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.last_valid_positions = new Float32Array(buffer, currentOffset, MAX_AGENTS * 2);
-  currentOffset += MAX_AGENTS * 2 * 4;
-
-  agents.last_valid_tris = new Int32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.stuck_ratings = new Float32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.path_frustrations = new Float32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.alien_polys = new Int32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.last_visible_points_for_next_corner = new Float32Array(buffer, currentOffset, MAX_AGENTS * 2);
-  currentOffset += MAX_AGENTS * 2 * 4;
-
-  // Statistics
-  agents.last_end_targets = new Float32Array(buffer, currentOffset, MAX_AGENTS * 2);
-  currentOffset += MAX_AGENTS * 2 * 4;
-
-  agents.min_corridor_lengths = new Int32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.last_distances_to_next_corner = new Float32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.sight_ratings = new Float32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.last_next_corner_tris = new Int32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  // Parameters
-  agents.max_speeds = new Float32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.accels = new Float32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.resistances = new Float32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.intelligences = new Float32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.arrival_desired_speeds = new Float32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.look_speeds = new Float32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.max_frustrations = new Float32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.arrival_threshold_sqs = new Float32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  agents.predicament_ratings = new Float32Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 4;
-
-  // At very end
-  agents.frame_ids = new Uint16Array(buffer, currentOffset, MAX_AGENTS);
-  currentOffset += MAX_AGENTS * 2;
+  // SIMD columns expect a 16-byte aligned start
+  const layoutOffset = (offset + 15) & ~15;
+  const layoutBytes = wasmModule._get_agent_layout_bytes(MAX_AGENTS);
+  let currentOffset = layoutOffset + layoutBytes;
 
   const eventsOffset = currentOffset;
-  agents.events = new EventBuffer(buffer, eventsOffset, EVENT_BUFFER_WORDS);
-  currentOffset += EVENT_BUFFER_WORDS * 4;
+  agents.commands = new EventRing(buffer, eventsOffset, EVENT_BUFFER_WORDS);
+  agents.events = new EventRing(buffer, eventsOffset + eventRingBytes(EVENT_BUFFER_WORDS), EVENT_BUFFER_WORDS);
+  currentOffset += eventRingBytes(EVENT_BUFFER_WORDS) * 2;
 
   const bytesWritten = currentOffset - offset;
   
-     wasmModule._init_agents(offset, MAX_AGENTS, gs.rngSeed, eventsOffset, EVENT_BUFFER_WORDS);
+  wasmModule._init_agents(layoutOffset, MAX_AGENTS, gs.rngSeed, eventsOffset, EVENT_BUFFER_WORDS);
+  bindAgentColumns(agents, wasmModule, buffer, layoutOffset);
   
   return bytesWritten;
 }
+
+// Column types from agent_layout.h
+const enum AgentColumnType {
+  F32 = 0,
+  I32 = 1,
+  U8 = 2,
+  U16 = 3,
+  F32X2 = 4,
+}
+
+function readCString(heap: Uint8Array, ptr: number): string {
+  let end = ptr;
+  while (heap[end] !== 0) end++;
+  return String.fromCharCode(...heap.subarray(ptr, end));
+}
+
+/**
+ * Creates the Agents typed-array views from the column descriptor that
+ * init_agents published (see agent_layout.h for the word layout).
+ */
+function bindAgentColumns(agents: Agents, wasmModule: WasmFacade, buffer: ArrayBuffer, base: number): void {
+  const u32 = wasmModule.HEAPU32;
+  const desc = wasmModule._get_agent_layout_ptr() >>> 2;
+  const columnCount = u32[desc];
+  const wordsPerColumn = u32[desc + 2];
+  const columns = agents as unknown as Record<string, ArrayBufferView>;
+
+  for (let c = 0; c < columnCount; c++) {
+    const w = desc + 3 + c * wordsPerColumn;
+    const name = readCString(wasmModule.HEAPU8, u32[w]);
+    const type = u32[w + 1] as AgentColumnType;
+    const byteOffset = base + u32[w + 3];
+    const length = u32[w + 4];
+    agents.columnIds[name] = c;
+    switch (type) {
+      case AgentColumnType.F32:
+      case AgentColumnType.F32X2:
+        columns[name] = new Float32Array(buffer, byteOffset, length);
+        break;
+      case AgentColumnType.I32:
+        columns[name] = new Int32Array(buffer, byteOffset, length);
+        break;
+      case AgentColumnType.U8:
+        columns[name] = new Uint8Array(buffer, byteOffset, length);
+        break;
+      case AgentColumnType.U16:
+        columns[name] = new Uint16Array(buffer, byteOffset, length);
+        break;
+      default:
+        throw new Error(`Unknown agent column type ${type} for ${name}`);
+    }
+  }
+}
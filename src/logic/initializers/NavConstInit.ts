@@ -31,6 +31,9 @@ export function initializeConst(wasm: WasmFacade, buffer: ArrayBuffer, offset: n
   f32[i++] = NavConst.CORNER_OFFSET_SQ;
   f32[i++] = NavConst.PATH_FREE_WIDTH;
   f32[i++] = NavConst.PATH_WIDTH_PENALTY_MULT;
+  f32[i++] = NavConst.CONGESTION_COST_MULT;
+  f32[i++] = NavConst.CONGESTION_DECAY;
+  i32[i++] = NavConst.CONGESTION_UPDATE_FRAMES;
 
   if (i !== Object.keys(NavConst).length) {
     throw new Error("Mismatch between number of constants and initialized values");
@@ -7,18 +7,75 @@ function alignTo(size: number, alignment: number): number {
   return Math.ceil(size / alignment) * alignment;
 }
 
+// navmesh.bin v2 (see src/wasm/navmesh_format.h): header, section directory,
+// 16-byte aligned sections. Only what sizing needs is read here; the WASM side
+// validates the checksum.
+const NAVMESH_V2_MAGIC = 0x3256414E; // "NAV2"
+const NAVMESH_V2_HEADER_BYTES = 80;
+const NAVMESH_V2_SECTION_BYTES = 16;
+const NAV_SECTION_TRIANGLES = 1;
+const NAV_SECTION_BUILDINGS = 8;
+const NAV_SECTION_BLOB_BUILDINGS = 10;
+const NAV_SECTION_AUX = [11, 12, 13];
+const NAV_SECTION_INDEX = [14, 15, 16, 17, 18, 19, 20, 21];
+
+interface NavmeshBinaryInfo {
+  bbox: DataView; // real then buffered bbox, 8 floats
+  trianglesLen: number;
+  buildingsLen: number;
+  blobBuildingsLen: number;
+  walkableTriangleCount: number;
+  walkablePolygonCount: number;
+  bakedAux: boolean;
+  bakedIndexCellSize: number; // 0 if the spatial indices are not baked
+}
+
+function readNavmeshBinaryInfo(navmeshBin: ArrayBuffer): NavmeshBinaryInfo {
+  const view = new DataView(navmeshBin);
+  if (navmeshBin.byteLength >= NAVMESH_V2_HEADER_BYTES && view.getUint32(0, true) === NAVMESH_V2_MAGIC) {
+    const sectionCount = view.getUint32(12, true);
+    const sectionBytes = new Map<number, number>();
+    for (let i = 0; i < sectionCount; i++) {
+      const entry = NAVMESH_V2_HEADER_BYTES + i * NAVMESH_V2_SECTION_BYTES;
+      sectionBytes.set(view.getUint32(entry, true), view.getUint32(entry + 8, true));
+    }
+    const cellSize = view.getFloat32(24, true);
+    return {
+      bbox: new DataView(navmeshBin, 36, 32),
+      trianglesLen: (sectionBytes.get(NAV_SECTION_TRIANGLES) ?? 0) / 4,
+      buildingsLen: (sectionBytes.get(NAV_SECTION_BUILDINGS) ?? 0) / 4,
+      blobBuildingsLen: (sectionBytes.get(NAV_SECTION_BLOB_BUILDINGS) ?? 0) / 4,
+      walkableTriangleCount: view.getInt32(28, true),
+      walkablePolygonCount: view.getInt32(32, true),
+      bakedAux: NAV_SECTION_AUX.every((id) => sectionBytes.has(id)),
+      bakedIndexCellSize: cellSize > 0 && NAV_SECTION_INDEX.every((id) => sectionBytes.has(id)) ? cellSize : 0,
+    };
+  }
+
+  // v1: 8 floats of bbox, then the header (after BBOX: 8 floats = 32 bytes for both real and buffered bbox)
+  const headerView = new DataView(navmeshBin, 32, 13 * 4);
+  return {
+    bbox: new DataView(navmeshBin, 0, 32),
+    trianglesLen: headerView.getInt32(4, true),
+    buildingsLen: headerView.getInt32(32, true),
+    blobBuildingsLen: headerView.getInt32(40, true),
+    walkableTriangleCount: headerView.getInt32(44, true),
+    walkablePolygonCount: headerView.getInt32(48, true),
+    bakedAux: false,
+    bakedIndexCellSize: 0,
+  };
+}
+
 export function calculateNavmeshMemory(navmeshBin: ArrayBuffer, enableLogging : boolean): number {
-  // Parse header structure (after BBOX: now 8 floats = 32 bytes for both real and buffered bbox)
-  const headerView = new DataView(navmeshBin, 32, 14 * 4);
-  
-  const trianglesLen = headerView.getInt32(4, true);
-  const buildingsLen = headerView.getInt32(32, true);
-  const blobBuildingsLen = headerView.getInt32(40, true);
-  const walkableTriangleCount = headerView.getInt32(44, true);
-  const walkablePolygonCount = headerView.getInt32(48, true);
+  const info = readNavmeshBinaryInfo(navmeshBin);
+  const trianglesLen = info.trianglesLen;
+  const buildingsLen = info.buildingsLen;
+  const blobBuildingsLen = info.blobBuildingsLen;
+  const walkableTriangleCount = info.walkableTriangleCount;
+  const walkablePolygonCount = info.walkablePolygonCount;
   
   // Parse both bboxes
-  const bboxView = new DataView(navmeshBin, 0, 32);
+  const bboxView = info.bbox;
   const realMinX = bboxView.getFloat32(0, true);
   const realMinY = bboxView.getFloat32(4, true);
   const realMaxX = bboxView.getFloat32(8, true);
@@ -55,10 +112,15 @@ export function calculateNavmeshMemory(navmeshBin: ArrayBuffer, enableLogging :
   // 1. Raw binary data from file
   totalMemory += alignTo(navmeshBin.byteLength, SIMD_ALIGNMENT);
   
-  // 2. Auxiliary structures computed in C++
-  totalMemory += alignTo(walkableTriangleCount * 2 * 4, SIMD_ALIGNMENT); // triangle_centroids (Point2)
-  totalMemory += alignTo((trianglesLen / 3) * 4, SIMD_ALIGNMENT); // triangle_to_polygon 
-  totalMemory += alignTo(buildingsLen * 4, SIMD_ALIGNMENT); // building_to_blob
+  // 2. Auxiliary structures computed in C++ (unless baked into a v2 binary)
+  if (!info.bakedAux) {
+    totalMemory += alignTo(walkableTriangleCount * 2 * 4, SIMD_ALIGNMENT); // triangle_centroids (Point2)
+    totalMemory += alignTo((trianglesLen / 3) * 4, SIMD_ALIGNMENT); // triangle_to_polygon 
+    totalMemory += alignTo(buildingsLen * 4, SIMD_ALIGNMENT); // building_to_blob
+  }
+  if (info.bakedIndexCellSize === cellSize) {
+    return totalMemory;
+  }
   
   // 3. Spatial indices (using 2x average for triangles/buildings, 3x for polygons)
   // Triangle spatial index
@@ -6,6 +6,10 @@ import { WasmFacade, createWasmModule } from "../WasmFacade";
 import { GameState } from "../GameState";
 
 export const INIT_LOGGING = false;
+// Run the WASM simulation on its own thread at a fixed tick (requires cross-origin isolation).
+export const SIM_THREADED = false;
+export const SIM_TICK_DT = 1 / 60;
+export const SIM_MAX_TICKS_PER_WAKE = 4;
 let wasmModule: WasmFacade;
 
 export class WasmInit {
@@ -21,7 +25,7 @@ export class WasmInit {
     const totalMemoryRequired = 
       calculateConstMemory() +
       calculateNavmeshMemory(navmeshBin, INIT_LOGGING) +
-      calculateAgentsMemory();
+      calculateAgentsMemory(wasmModule);
 
     // Phase 3: Single contiguous allocation
     if (!wasmModule._wasm_alloc) {
@@ -52,6 +56,15 @@ export class WasmInit {
     
     // Initialize WASM renderer after core WASM is ready
     await RenderInit.initializeRenderer(wasmModule, '#wasm-agents-canvas', '/img/base.webp');
+
+    if (SIM_THREADED) {
+      if (!wasmModule._sim_thread_start || !self.crossOriginIsolated) {
+        throw new Error("Threaded simulation requires sim_thread_start and a cross-origin isolated page.");
+      }
+      if (!wasmModule._sim_thread_start(SIM_TICK_DT, SIM_MAX_TICKS_PER_WAKE)) {
+        throw new Error("Threaded simulation requires a WASM build with THREADS=1.");
+      }
+    }
     
     return wasmModule;
   }
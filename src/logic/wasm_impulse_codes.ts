@@ -1,4 +1,23 @@
 export enum WasmImpulse {
   POINT_IN_TRIANGLE_BENCH = 1,
   POINT_IN_POLYGON_BENCH = 2,
-} 
\ No newline at end of file
+  PHYS_SIMD_BENCH = 3,
+  NAV_CONSTANTS_BENCH = 4,
+  SCENARIO_SUITE = 5,
+  MICROBENCH_SUITE = 6,
+  // SCENARIO_FIRST + index into SCENARIO_NAMES runs a single scenario
+  SCENARIO_FIRST = 16,
+}
+
+// Order MUST match SCENARIOS in scenario_bench.h
+export const SCENARIO_NAMES = [
+  'random_journeys_1k',
+  'random_journeys_10k',
+  'random_journeys_50k',
+  'all_to_one',
+  'bottleneck_crossing',
+  'mass_stuck_recovery',
+  'cold_start_navmesh',
+] as const;
+
+export type ScenarioName = typeof SCENARIO_NAMES[number]; 
\ No newline at end of file
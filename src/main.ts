@@ -11,6 +11,12 @@ import { Wasm } from './logic/Wasm';
 import { runPointInTriangleBenchmark } from './logic/debug/PointInTriangleBenchmark';
 import { WasmFacade } from './logic/WasmFacade';
 import { dispatchFrameUpdate } from './logic/FrameUpdate';
+import { drainTraceLog } from './logic/TraceLog';
+import { dumpFrameProfile } from './logic/FrameProfiler';
+import { dumpNavTelemetry } from './logic/NavTelemetry';
+import { ScenarioName } from './logic/wasm_impulse_codes';
+import { spawnWasmAgentBatch } from './logic/WAgentSpawner';
+import { AgentConfigs, type AgentConfig } from './logic/agents/AgentConfigs';
 
 
 async function initializeGame() {
@@ -47,6 +53,19 @@ async function initializeGame() {
   (window as any).runPointInTriangleBenchmark = () => runPointInTriangleBenchmark(gameState);
   (window as any).runPointInTriangleBenchmarkWasm = () => WasmFacade.triggerPointInTriangleBench();
   (window as any).runPointInPolygonBenchmarkWasm = () => WasmFacade.triggerPointInPolygonBench();
+  (window as any).runPhysSimdBenchmarkWasm = () => WasmFacade.triggerPhysSimdBench();
+  (window as any).runNavConstantsBenchmarkWasm = () => WasmFacade.triggerNavConstantsBench();
+  (window as any).runScenarioSuiteWasm = () => WasmFacade.triggerScenarioSuite();
+  (window as any).runScenarioWasm = (name: ScenarioName) => WasmFacade.triggerScenario(name);
+  (window as any).runMicrobenchWasm = () => WasmFacade.triggerMicrobenchSuite();
+  // Warm up the WASM crowd without rendering; stop the simulation thread first.
+  (window as any).fastForwardWasm = (seconds: number, dt: number = 1 / 60) =>
+    WasmFacade.fastForward!(dt, Math.round(seconds / dt), gameState.wagents.length);
+  // One CMD_SPAWN_BATCH of count agents over [minX, minY, maxX, maxY]; config is an AgentConfigs name.
+  (window as any).spawnWasmBatch = (extent: number[], count: number, config: keyof typeof AgentConfigs = "benchmarkerSmart") =>
+    spawnWasmAgentBatch(gameState, AgentConfigs[config] as AgentConfig, extent, count);
+  (window as any).dumpFrameProfile = () => dumpFrameProfile(WasmFacade);
+  (window as any).dumpNavTelemetry = () => dumpNavTelemetry(WasmFacade);
 
   // --- Game Loop ---
   let lastTimestamp = 0;
@@ -67,6 +86,7 @@ async function initializeGame() {
 
     processInputs(gameState);
     Model.update(gameState, Math.min(1, deltaTime));
+    drainTraceLog(WasmFacade);
 
     if (wasmRenderEnabled.value) {
       Wasm.render(gameState);
@@ -25,8 +25,8 @@ void update_agent_collisions(int num_agents) {
       for (int j = i + 1; j < count; ++j) {
         int agent_index2 = agent_grid.cell_data[offset + j];
 
-        Point2& pos1 = agent_data.positions[agent_index1];
-        Point2& pos2 = agent_data.positions[agent_index2];
+        const Point2 pos1 = agent_data.positions[agent_index1];
+        const Point2 pos2 = agent_data.positions[agent_index2];
 
         float dist_sq = math::distance_sq(pos1, pos2);
 
@@ -50,6 +50,7 @@ void initialize_agent_grid(int max_agents) {
 
 void clear_and_reindex_grid(int num_agents) {
   std::fill(agent_grid.cell_counts.begin(), agent_grid.cell_counts.end(), 0);
+  agent_grid.overflowed = false;
 
   generate_halton_offset();
 
@@ -65,10 +66,14 @@ void clear_and_reindex_grid(int num_agents) {
         int offset = agent_grid.cell_offsets[cell_index] + count;
         agent_grid.cell_data[offset] = i;
         agent_grid.cell_counts[cell_index]++;
+      } else {
+        agent_grid.overflowed = true;
       }
     }
   }
 
+  agent_grid.indexed_agents = num_agents;
+
   frame_counter++;
 }
 
@@ -84,4 +89,27 @@ int get_cell_index(Point2 position) {
   }
 
   return grid_y * GRID_WIDTH + grid_x;
-} 
\ No newline at end of file
+} 
+bool agent_grid_cell_range(const BoundingBox& box, int* x0, int* y0, int* x1, int* y1) {
+  if (agent_grid.cell_counts.empty()) return false;
+  const float fx0 = floor((box.minX + halton_offset.x - WORLD_MIN_X) / CELL_SIZE);
+  const float fy0 = floor((box.minY + halton_offset.y - WORLD_MIN_Y) / CELL_SIZE);
+  const float fx1 = floor((box.maxX + halton_offset.x - WORLD_MIN_X) / CELL_SIZE);
+  const float fy1 = floor((box.maxY + halton_offset.y - WORLD_MIN_Y) / CELL_SIZE);
+  if (!(fx1 >= 0.0f && fy1 >= 0.0f && fx0 < GRID_WIDTH && fy0 < GRID_HEIGHT)) return false;
+  *x0 = fx0 < 0.0f ? 0 : static_cast<int>(fx0);
+  *y0 = fy0 < 0.0f ? 0 : static_cast<int>(fy0);
+  *x1 = fx1 >= GRID_WIDTH ? GRID_WIDTH - 1 : static_cast<int>(fx1);
+  *y1 = fy1 >= GRID_HEIGHT ? GRID_HEIGHT - 1 : static_cast<int>(fy1);
+  return true;
+}
+
+int agent_grid_cell_index(int grid_x, int grid_y) {
+  return grid_y * GRID_WIDTH + grid_x;
+}
+
+BoundingBox agent_grid_cell_bounds(int grid_x, int grid_y) {
+  const float minX = WORLD_MIN_X + grid_x * CELL_SIZE - halton_offset.x;
+  const float minY = WORLD_MIN_Y + grid_y * CELL_SIZE - halton_offset.y;
+  return {minX, minY, minX + CELL_SIZE, minY + CELL_SIZE};
+}
@@ -7,6 +7,15 @@ void initialize_agent_grid(int max_agents);
 void clear_and_reindex_grid(int num_agents);
 int get_cell_index(Point2 position);
 
+// Cells the last reindex put agents of box into, clamped to the grid, as the
+// inclusive range [x0, x1] x [y0, y1]. False if box lies outside the grid.
+bool agent_grid_cell_range(const BoundingBox& box, int* x0, int* y0, int* x1, int* y1);
+int agent_grid_cell_index(int grid_x, int grid_y);
+// World rect of a cell under the jitter of the last reindex.
+BoundingBox agent_grid_cell_bounds(int grid_x, int grid_y);
+
 extern AgentGridData agent_grid;
+// Frames reindexed so far; selects the Halton grid jitter of the next reindex.
+extern int frame_counter;
 
 #endif // AGENT_GRID_H 
\ No newline at end of file
@@ -1,128 +1,96 @@
 #include "agent_init.h"
 #include "agent_statistic.h"
+#include "agent_layout.h"
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 
 extern AgentSoA agent_data;
 
-void initialize_shared_buffer_layout(uint8_t* sharedBuffer, int maxAgents) {
-  size_t offset = 0;
-
-  // Core physics
-  agent_data.positions = reinterpret_cast<Point2*>(sharedBuffer + offset);
-  offset += sizeof(Point2) * maxAgents;
-
-  agent_data.last_coordinates = reinterpret_cast<Point2*>(sharedBuffer + offset);
-  offset += sizeof(Point2) * maxAgents;
-
-  agent_data.velocities = reinterpret_cast<Point2*>(sharedBuffer + offset);
-  offset += sizeof(Point2) * maxAgents;
-  
-  agent_data.looks = reinterpret_cast<Point2*>(sharedBuffer + offset);
-  offset += sizeof(Point2) * maxAgents;
-
-  agent_data.states = reinterpret_cast<AgentState*>(sharedBuffer + offset);
-  offset += sizeof(AgentState) * maxAgents;
-  
-  agent_data.is_alive = reinterpret_cast<bool*>(sharedBuffer + offset);
-  offset += sizeof(bool) * maxAgents;
-
-
-  // Navigation data
-  agent_data.current_tris = reinterpret_cast<int*>(sharedBuffer + offset);
-  offset += sizeof(int) * maxAgents;
-  
-  agent_data.next_corners = reinterpret_cast<Point2*>(sharedBuffer + offset);
-  offset += sizeof(Point2) * maxAgents;
-
-  agent_data.next_corner_tris = reinterpret_cast<int*>(sharedBuffer + offset);
-  offset += sizeof(int) * maxAgents;
-
-  agent_data.next_corners2 = reinterpret_cast<Point2*>(sharedBuffer + offset);
-  offset += sizeof(Point2) * maxAgents;
-
-  agent_data.next_corner_tris2 = reinterpret_cast<int*>(sharedBuffer + offset);
-  offset += sizeof(int) * maxAgents;
-
-  agent_data.num_valid_corners = reinterpret_cast<uint8_t*>(sharedBuffer + offset);
-  offset += sizeof(uint8_t) * maxAgents;
+namespace {
 
-  agent_data.pre_escape_corners = reinterpret_cast<Point2*>(sharedBuffer + offset);
-  offset += sizeof(Point2) * maxAgents;
+struct AgentColumnInfo {
+  const char* name;
+  uint32_t type;
+  uint32_t group;
+  uint32_t align;
+  uint32_t elem_size;
+};
 
-  agent_data.pre_escape_corner_tris = reinterpret_cast<int*>(sharedBuffer + offset);
-  offset += sizeof(int) * maxAgents;
+const AgentColumnInfo k_agent_columns[AGENT_COLUMN_COUNT] = {
+#define X(name, member, ctype, type, group, align) {#name, type, group, align, sizeof(ctype)},
+  AGENT_COLUMNS(X)
+#undef X
+};
 
-  agent_data.end_targets = reinterpret_cast<Point2*>(sharedBuffer + offset);
-  offset += sizeof(Point2) * maxAgents;
-
-  agent_data.end_target_tris = reinterpret_cast<int*>(sharedBuffer + offset);
-  offset += sizeof(int) * maxAgents;
-
-  agent_data.last_valid_positions = reinterpret_cast<Point2*>(sharedBuffer + offset);
-  offset += sizeof(Point2) * maxAgents;
-
-  agent_data.last_valid_tris = reinterpret_cast<int*>(sharedBuffer + offset);
-  offset += sizeof(int) * maxAgents;
-
-  agent_data.stuck_ratings = reinterpret_cast<float*>(sharedBuffer + offset);
-  offset += sizeof(float) * maxAgents;
-  
-  agent_data.path_frustrations = reinterpret_cast<float*>(sharedBuffer + offset);
-  offset += sizeof(float) * maxAgents;
+uint32_t g_agent_layout[AGENT_LAYOUT_HEADER_WORDS + AGENT_COLUMN_COUNT * AGENT_LAYOUT_COLUMN_WORDS];
 
-  agent_data.alien_polys = reinterpret_cast<int*>(sharedBuffer + offset);
-  offset += sizeof(int) * maxAgents;
-
-  agent_data.last_visible_points_for_next_corner = reinterpret_cast<Point2*>(sharedBuffer + offset);
-  offset += sizeof(Point2) * maxAgents;
-
-  // Statistics
-  agent_data.last_end_targets = reinterpret_cast<Point2*>(sharedBuffer + offset);
-  offset += sizeof(Point2) * maxAgents;
-
-  agent_data.min_corridor_lengths = reinterpret_cast<int*>(sharedBuffer + offset);
-  offset += sizeof(int) * maxAgents;
-
-  agent_data.last_distances_to_next_corner = reinterpret_cast<float*>(sharedBuffer + offset);
-  offset += sizeof(float) * maxAgents;
-
-  agent_data.sight_ratings = reinterpret_cast<float*>(sharedBuffer + offset);
-  offset += sizeof(float) * maxAgents;
-
-  agent_data.last_next_corner_tris = reinterpret_cast<int*>(sharedBuffer + offset);
-  offset += sizeof(int) * maxAgents;
-
-  // Parameters
-  agent_data.max_speeds = reinterpret_cast<float*>(sharedBuffer + offset);
-  offset += sizeof(float) * maxAgents;
+inline size_t align_up(size_t v, size_t a) {
+  return (v + a - 1) & ~(a - 1);
+}
 
-  agent_data.accels = reinterpret_cast<float*>(sharedBuffer + offset);
-  offset += sizeof(float) * maxAgents;
+// Assigns byte offsets group by group, keeping table order within a group.
+size_t compute_agent_layout(int maxAgents, size_t* offsets) {
+  size_t offset = 0;
+  for (uint32_t group = 0; group < AGENT_GROUP_COUNT; ++group) {
+    for (int c = 0; c < AGENT_COLUMN_COUNT; ++c) {
+      const AgentColumnInfo& col = k_agent_columns[c];
+      if (col.group != group) continue;
+      offset = align_up(offset, col.align);
+      offsets[c] = offset;
+      offset += static_cast<size_t>(col.elem_size) * maxAgents;
+    }
+  }
+  return align_up(offset, 16);
+}
 
-  agent_data.resistances = reinterpret_cast<float*>(sharedBuffer + offset);
-  offset += sizeof(float) * maxAgents;
+} // namespace
 
-  agent_data.intelligences = reinterpret_cast<float*>(sharedBuffer + offset);
-  offset += sizeof(float) * maxAgents;
+size_t agent_layout_bytes(int maxAgents) {
+  size_t offsets[AGENT_COLUMN_COUNT];
+  return compute_agent_layout(maxAgents, offsets);
+}
 
-  agent_data.arrival_desired_speeds = reinterpret_cast<float*>(sharedBuffer + offset);
-  offset += sizeof(float) * maxAgents;
+const uint32_t* agent_layout_descriptor() {
+  return g_agent_layout;
+}
 
-  agent_data.look_speeds = reinterpret_cast<float*>(sharedBuffer + offset);
-  offset += sizeof(float) * maxAgents;
+void bind_agent_columns(AgentSoA& soa, uint8_t* buffer, int maxAgents) {
+  if (reinterpret_cast<uintptr_t>(buffer) & 15) {
+    printf("[WASM] Agent buffer %p is not 16-byte aligned; SIMD columns will be unaligned\n", static_cast<void*>(buffer));
+  }
 
-  agent_data.max_frustrations = reinterpret_cast<float*>(sharedBuffer + offset);
-  offset += sizeof(float) * maxAgents;
+  size_t offsets[AGENT_COLUMN_COUNT];
+  compute_agent_layout(maxAgents, offsets);
 
-  agent_data.arrival_threshold_sqs = reinterpret_cast<float*>(sharedBuffer + offset);
-  offset += sizeof(float) * maxAgents;
+  int c = 0;
+#define X(name, member, ctype, type, group, align) \
+  soa.member = reinterpret_cast<ctype*>(buffer + offsets[c++]);
+  AGENT_COLUMNS(X)
+#undef X
 
-  agent_data.predicament_ratings = reinterpret_cast<float*>(sharedBuffer + offset);
-  offset += sizeof(float) * maxAgents;
+  soa.capacity = maxAgents;
+}
 
-  // At very end
-  agent_data.frame_ids = reinterpret_cast<uint16_t*>(sharedBuffer + offset);
-  offset += sizeof(uint16_t) * maxAgents;
+void initialize_shared_buffer_layout(uint8_t* sharedBuffer, int maxAgents) {
+  bind_agent_columns(agent_data, sharedBuffer, maxAgents);
+
+  size_t offsets[AGENT_COLUMN_COUNT];
+  const size_t totalBytes = compute_agent_layout(maxAgents, offsets);
+
+  g_agent_layout[0] = static_cast<uint32_t>(AGENT_COLUMN_COUNT);
+  g_agent_layout[1] = static_cast<uint32_t>(totalBytes);
+  g_agent_layout[2] = static_cast<uint32_t>(AGENT_LAYOUT_COLUMN_WORDS);
+  for (int i = 0; i < AGENT_COLUMN_COUNT; ++i) {
+    const AgentColumnInfo& col = k_agent_columns[i];
+    uint32_t* w = g_agent_layout + AGENT_LAYOUT_HEADER_WORDS + i * AGENT_LAYOUT_COLUMN_WORDS;
+    w[0] = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(col.name));
+    w[1] = col.type;
+    w[2] = col.group;
+    w[3] = static_cast<uint32_t>(offsets[i]);
+    w[4] = static_cast<uint32_t>(col.type == AGENT_COL_F32X2 ? maxAgents * 2 : maxAgents);
+    w[5] = static_cast<uint32_t>(col.elem_size * maxAgents);
+  }
 }
 
 void initialize_agent_defaults(int idx, float x, float y) {
@@ -169,4 +137,34 @@ void initialize_agent_defaults(int idx, float x, float y) {
   agent_data.frame_ids[idx] = 0;
 
   reset_agent_stuck(idx);
-}
\ No newline at end of file
+}
+
+int agent_column_words(int column) {
+  if (column < 0 || column >= AGENT_COLUMN_COUNT) return 0;
+  return k_agent_columns[column].elem_size > 4 ? static_cast<int>(k_agent_columns[column].elem_size / 4) : 1;
+}
+
+bool write_agent_column(int column, int first, int count, const uint32_t* words, bool broadcast) {
+  if (column < 0 || column >= AGENT_COLUMN_COUNT || first < 0 || count < 0 ||
+      static_cast<int64_t>(first) + count > agent_data.capacity) return false;
+  uint8_t* const bases[AGENT_COLUMN_COUNT] = {
+#define X(name, member, ctype, type, group, align) reinterpret_cast<uint8_t*>(agent_data.member),
+    AGENT_COLUMNS(X)
+#undef X
+  };
+  const uint32_t size = k_agent_columns[column].elem_size;
+  const int stride = broadcast ? 0 : agent_column_words(column);
+  uint8_t* dst = bases[column] + static_cast<size_t>(first) * size;
+  for (int i = 0; i < count; ++i, dst += size) {
+    const uint32_t* src = words + i * stride;
+    if (size >= 4) {
+      std::memcpy(dst, src, size);
+    } else if (size == 2) {
+      const uint16_t v = static_cast<uint16_t>(src[0]);
+      std::memcpy(dst, &v, 2);
+    } else {
+      *dst = static_cast<uint8_t>(src[0]);
+    }
+  }
+  return true;
+}
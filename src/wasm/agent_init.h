@@ -6,4 +6,17 @@
 void initialize_shared_buffer_layout(uint8_t* sharedBuffer, int maxAgents);
 void initialize_agent_defaults(int idx, float x, float y);
 
+// Writes agents [first, first + count) of AGENT_COLUMNS entry column (the
+// layout descriptor order). words holds one element per agent, or a single
+// element for all of them with broadcast; an element is two words in F32X2
+// columns and one word otherwise (narrowed for U8/U16). Returns false for an
+// unknown column or a range outside the capacity.
+bool write_agent_column(int column, int first, int count, const uint32_t* words, bool broadcast);
+// Words per element of write_agent_column for column, 0 if there is no such column.
+int agent_column_words(int column);
+
+// Points soa's columns into buffer (agent_layout_bytes(maxAgents) bytes) without
+// publishing the layout descriptor. Headless scenarios use it for private agent sets.
+void bind_agent_columns(AgentSoA& soa, uint8_t* buffer, int maxAgents);
+
 #endif // AGENT_INIT_H
\ No newline at end of file
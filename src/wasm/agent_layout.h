@@ -0,0 +1,87 @@
+#ifndef AGENT_LAYOUT_H
+#define AGENT_LAYOUT_H
+
+#include <cstdint>
+#include <cstddef>
+#include "data_structures.h"
+
+// Element type of a shared agent column, also tells TS which typed array to create.
+enum AgentColumnType : uint32_t {
+  AGENT_COL_F32 = 0,
+  AGENT_COL_I32 = 1,
+  AGENT_COL_U8 = 2,
+  AGENT_COL_U16 = 3,
+  AGENT_COL_F32X2 = 4, // interleaved Point2
+};
+
+// Columns are packed group by group so the per-tick working set stays contiguous.
+enum AgentColumnGroup : uint32_t {
+  AGENT_GROUP_HOT = 0,  // read or written for every agent every tick
+  AGENT_GROUP_WARM = 1, // navigation state touched on repath/corner updates
+  AGENT_GROUP_COLD = 2, // statistics, escape bookkeeping, rarely read params
+  AGENT_GROUP_COUNT = 3,
+};
+
+// Single source of truth for the shared agent buffer.
+// X(name, member, ctype, type, group, align)
+//   name   - column name exported to TS (property name on Agents.ts)
+//   member - AgentSoA member the column pointer is assigned to
+//   align  - byte alignment of the column start within the buffer
+// Reordering entries or moving them between groups needs no TS changes.
+#define AGENT_COLUMNS(X) \
+  X(positions_x, positions.x, float, AGENT_COL_F32, AGENT_GROUP_HOT, 16) \
+  X(positions_y, positions.y, float, AGENT_COL_F32, AGENT_GROUP_HOT, 16) \
+  X(velocities_x, velocities.x, float, AGENT_COL_F32, AGENT_GROUP_HOT, 16) \
+  X(velocities_y, velocities.y, float, AGENT_COL_F32, AGENT_GROUP_HOT, 16) \
+  X(next_corners, next_corners, Point2, AGENT_COL_F32X2, AGENT_GROUP_HOT, 16) \
+  X(next_corners2, next_corners2, Point2, AGENT_COL_F32X2, AGENT_GROUP_HOT, 16) \
+  X(last_coordinates, last_coordinates, Point2, AGENT_COL_F32X2, AGENT_GROUP_HOT, 16) \
+  X(looks, looks, Point2, AGENT_COL_F32X2, AGENT_GROUP_HOT, 16) \
+  X(max_speeds, max_speeds, float, AGENT_COL_F32, AGENT_GROUP_HOT, 16) \
+  X(accels, accels, float, AGENT_COL_F32, AGENT_GROUP_HOT, 16) \
+  X(resistances, resistances, float, AGENT_COL_F32, AGENT_GROUP_HOT, 16) \
+  X(intelligences, intelligences, float, AGENT_COL_F32, AGENT_GROUP_HOT, 16) \
+  X(arrival_desired_speeds, arrival_desired_speeds, float, AGENT_COL_F32, AGENT_GROUP_HOT, 16) \
+  X(stuck_ratings, stuck_ratings, float, AGENT_COL_F32, AGENT_GROUP_HOT, 16) \
+  X(current_tris, current_tris, int, AGENT_COL_I32, AGENT_GROUP_HOT, 16) \
+  X(states, states, AgentState, AGENT_COL_U8, AGENT_GROUP_HOT, 16) \
+  X(is_alive, is_alive, bool, AGENT_COL_U8, AGENT_GROUP_HOT, 16) \
+  X(num_valid_corners, num_valid_corners, uint8_t, AGENT_COL_U8, AGENT_GROUP_HOT, 16) \
+  X(frame_ids, frame_ids, uint16_t, AGENT_COL_U16, AGENT_GROUP_HOT, 16) \
+  X(next_corner_tris, next_corner_tris, int, AGENT_COL_I32, AGENT_GROUP_WARM, 4) \
+  X(next_corner_tris2, next_corner_tris2, int, AGENT_COL_I32, AGENT_GROUP_WARM, 4) \
+  X(end_targets, end_targets, Point2, AGENT_COL_F32X2, AGENT_GROUP_WARM, 8) \
+  X(end_target_tris, end_target_tris, int, AGENT_COL_I32, AGENT_GROUP_WARM, 4) \
+  X(last_valid_positions, last_valid_positions, Point2, AGENT_COL_F32X2, AGENT_GROUP_WARM, 8) \
+  X(last_valid_tris, last_valid_tris, int, AGENT_COL_I32, AGENT_GROUP_WARM, 4) \
+  X(path_frustrations, path_frustrations, float, AGENT_COL_F32, AGENT_GROUP_WARM, 4) \
+  X(alien_polys, alien_polys, int, AGENT_COL_I32, AGENT_GROUP_WARM, 4) \
+  X(last_visible_points_for_next_corner, last_visible_points_for_next_corner, Point2, AGENT_COL_F32X2, AGENT_GROUP_WARM, 8) \
+  X(look_speeds, look_speeds, float, AGENT_COL_F32, AGENT_GROUP_WARM, 4) \
+  X(max_frustrations, max_frustrations, float, AGENT_COL_F32, AGENT_GROUP_WARM, 4) \
+  X(arrival_threshold_sqs, arrival_threshold_sqs, float, AGENT_COL_F32, AGENT_GROUP_WARM, 4) \
+  X(pre_escape_corners, pre_escape_corners, Point2, AGENT_COL_F32X2, AGENT_GROUP_COLD, 8) \
+  X(pre_escape_corner_tris, pre_escape_corner_tris, int, AGENT_COL_I32, AGENT_GROUP_COLD, 4) \
+  X(last_end_targets, last_end_targets, Point2, AGENT_COL_F32X2, AGENT_GROUP_COLD, 8) \
+  X(min_corridor_lengths, min_corridor_lengths, int, AGENT_COL_I32, AGENT_GROUP_COLD, 4) \
+  X(last_distances_to_next_corner, last_distances_to_next_corner, float, AGENT_COL_F32, AGENT_GROUP_COLD, 4) \
+  X(sight_ratings, sight_ratings, float, AGENT_COL_F32, AGENT_GROUP_COLD, 4) \
+  X(last_next_corner_tris, last_next_corner_tris, int, AGENT_COL_I32, AGENT_GROUP_COLD, 4) \
+  X(predicament_ratings, predicament_ratings, float, AGENT_COL_F32, AGENT_GROUP_COLD, 4)
+
+#define AGENT_COLUMN_COUNT_X(name, member, ctype, type, group, align) +1
+const int AGENT_COLUMN_COUNT = 0 AGENT_COLUMNS(AGENT_COLUMN_COUNT_X);
+#undef AGENT_COLUMN_COUNT_X
+
+// Layout descriptor exported to TS via get_agent_layout_ptr (u32 words):
+//   [0] column count, [1] total bytes, [2] words per column
+//   then per column: name ptr (NUL-terminated), type, group, byte offset from
+//   the buffer start, element count, byte size.
+const int AGENT_LAYOUT_HEADER_WORDS = 3;
+const int AGENT_LAYOUT_COLUMN_WORDS = 6;
+
+// Bytes needed for maxAgents when the buffer starts 16-byte aligned.
+size_t agent_layout_bytes(int maxAgents);
+const uint32_t* agent_layout_descriptor();
+
+#endif // AGENT_LAYOUT_H
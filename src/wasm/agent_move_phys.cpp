@@ -6,12 +6,14 @@
 #include <cmath>
 #include "constants_layout.h"
 #include <cstdio>
+#include "simd4.h"
+#include "trace_log.h"
 
 extern Navmesh g_navmesh;
 extern float g_sim_time;
 extern std::vector<uint8_t> g_wall_contact;
 
-void update_agent_phys(int idx, float deltaTime) {
+void integrate_agent_velocity(int idx, float deltaTime, const NavConstants& nc) {
   agent_data.last_coordinates[idx] = agent_data.positions[idx];
 
   if (math::length_sq(agent_data.velocities[idx]) < 0.001f) {
@@ -69,7 +71,7 @@ void update_agent_phys(int idx, float deltaTime) {
   }
 
   desiredMagnitude /= frameRateAdjustedResistance;
-  const float stuckFactor = agent_data.stuck_ratings[idx] / STUCK_DANGER_2;
+  const float stuckFactor = agent_data.stuck_ratings[idx] / nc.stuck_danger_2;
   desiredMagnitude *= math::cvt(stuckFactor * stuckFactor, 0.0f, 1.0f, 1.0f, 0.5f);
   
   desiredVelocity = directionToCorner * desiredMagnitude;
@@ -95,7 +97,128 @@ void update_agent_phys(int idx, float deltaTime) {
   agent_data.velocities[idx] += finalAccelDirection;
 
   agent_data.velocities[idx] *= frameRateAdjustedResistance;
+}
+
+void integrate_agent_velocities(int begin, int end, float deltaTime, const NavConstants& nc) {
+  using namespace simd4;
+  const f4 zero = splat(0.0f);
+  const f4 one = splat(1.0f);
+  const f4 dt = splat(deltaTime);
+  const f4 invStuckDanger = splat(1.0f / nc.stuck_danger_2);
+
+  int i = begin;
+  for (; i + 4 <= end; i += 4) {
+    const bool* alive = agent_data.is_alive + i;
+    const f4 aliveMask = mask_from_bools(alive[0], alive[1], alive[2], alive[3]);
+    if (!any(aliveMask)) continue;
+
+    const AgentState* st = agent_data.states + i;
+    const uint8_t* nvc = agent_data.num_valid_corners + i;
+    const f4 moving = mask_from_bools(
+      st[0] == AgentState::Traveling || st[0] == AgentState::Escaping,
+      st[1] == AgentState::Traveling || st[1] == AgentState::Escaping,
+      st[2] == AgentState::Traveling || st[2] == AgentState::Escaping,
+      st[3] == AgentState::Traveling || st[3] == AgentState::Escaping);
+    const f4 twoCorners = mask_from_bools(nvc[0] >= 2, nvc[1] >= 2, nvc[2] >= 2, nvc[3] >= 2);
+    const f4 oneCorner = mask_from_bools(nvc[0] == 1, nvc[1] == 1, nvc[2] == 1, nvc[3] == 1);
+
+    const f4 px = load(agent_data.positions.x + i);
+    const f4 py = load(agent_data.positions.y + i);
+    f4 vx = load(agent_data.velocities.x + i);
+    f4 vy = load(agent_data.velocities.y + i);
+    f4 cx, cy;
+    load_xy(agent_data.next_corners + i, cx, cy);
+
+    const f4 oldVx = vx, oldVy = vy;
+    const f4 slow = lt(length_sq(vx, vy), splat(0.001f));
+    vx = select(slow, zero, vx);
+    vy = select(slow, zero, vy);
+
+    // No vector pow; resistance is per agent so evaluate it per lane.
+    const float* res = agent_data.resistances + i;
+    const f4 resistance = load(res);
+    const f4 frameRateAdjustedResistance = set(
+      powf(1.0f - res[0], deltaTime), powf(1.0f - res[1], deltaTime),
+      powf(1.0f - res[2], deltaTime), powf(1.0f - res[3], deltaTime));
+
+    // Desired velocity calculation
+    f4 dirX = sub(cx, px);
+    f4 dirY = sub(cy, py);
+    const f4 dstToCorner = sqrt(length_sq(dirX, dirY));
+    const f4 hasDir = gt(dstToCorner, splat(0.01f));
+    const f4 safeDst = select(hasDir, dstToCorner, one);
+    dirX = select(hasDir, div(dirX, safeDst), zero);
+    dirY = select(hasDir, div(dirY, safeDst), zero);
+
+    const f4 maxSpeed = load(agent_data.max_speeds + i);
+    const f4 intelligence = load(agent_data.intelligences + i);
+
+    f4 slowDownStrength = div(splat(1.0f / 8.0f), mul(resistance, resistance));
+    slowDownStrength = mul(slowDownStrength, lerp(splat(0.5f), splat(2.0f), intelligence));
+    f4 slowBeforeCornerDst = mul(maxSpeed, splat(0.25f));
+    f4 slowBeforeCornerSpeed = maxSpeed;
+
+    const f4 nearTurn = mask_and(moving, mask_and(twoCorners, lt(dstToCorner, slowBeforeCornerDst)));
+    if (any(nearTurn)) {
+      f4 c2x, c2y;
+      load_xy(agent_data.next_corners2 + i, c2x, c2y);
+      f4 turnX = sub(c2x, cx);
+      f4 turnY = sub(c2y, cy);
+      normalize_inplace(turnX, turnY);
+      f4 nvx = vx, nvy = vy;
+      normalize_inplace(nvx, nvy);
+
+      f4 turnAlignment = dot(nvx, nvy, turnX, turnY);
+      turnAlignment = mul(add(turnAlignment, one), splat(0.5f));
+      turnAlignment = mul(mul(turnAlignment, turnAlignment), turnAlignment);
+      slowBeforeCornerDst = select(nearTurn, mul(slowBeforeCornerDst, lerp(one, zero, turnAlignment)), slowBeforeCornerDst);
+      slowBeforeCornerSpeed = select(nearTurn, mul(slowBeforeCornerSpeed, lerp(slowDownStrength, one, turnAlignment)), slowBeforeCornerSpeed);
+    }
 
+    const f4 arrivalSpeed = mul(load(agent_data.arrival_desired_speeds + i), maxSpeed);
+    const f4 minSpeed = select(oneCorner, arrivalSpeed, slowBeforeCornerSpeed);
+    const f4 approach = lerp(minSpeed, maxSpeed, div(dstToCorner, slowBeforeCornerDst));
+    f4 desiredMagnitude = select(gt(dstToCorner, slowBeforeCornerDst), maxSpeed, approach);
+    desiredMagnitude = select(moving, desiredMagnitude, zero);
+
+    desiredMagnitude = div(desiredMagnitude, frameRateAdjustedResistance);
+    const f4 stuckFactor = mul(load(agent_data.stuck_ratings + i), invStuckDanger);
+    // cvt(s^2, 0, 1, 1, 0.5) == 1 - 0.5 * s^2
+    desiredMagnitude = mul(desiredMagnitude, sub(one, mul(splat(0.5f), mul(stuckFactor, stuckFactor))));
+
+    const f4 desiredX = mul(dirX, desiredMagnitude);
+    const f4 desiredY = mul(dirY, desiredMagnitude);
+
+    const f4 effectiveInt = select(gt(length_sq(desiredX, desiredY), splat(0.1f)), intelligence, one);
+    const f4 requiredAddition = sub(desiredMagnitude, dot(vx, vy, dirX, dirY));
+    const f4 directPart = mul(requiredAddition, sub(one, effectiveInt));
+    f4 accX = add(mul(dirX, directPart), mul(sub(desiredX, vx), effectiveInt));
+    f4 accY = add(mul(dirY, directPart), mul(sub(desiredY, vy), effectiveInt));
+
+    const f4 diffLn = sqrt(length_sq(accX, accY));
+    const f4 accelThisFrame = min(diffLn, mul(load(agent_data.accels + i), dt));
+    const f4 hasAccel = gt(diffLn, splat(0.001f));
+    const f4 accScale = select(hasAccel, div(accelThisFrame, select(hasAccel, diffLn, one)), zero);
+    accX = mul(accX, accScale);
+    accY = mul(accY, accScale);
+
+    vx = mul(add(vx, accX), frameRateAdjustedResistance);
+    vy = mul(add(vy, accY), frameRateAdjustedResistance);
+
+    // Dead lanes keep their previous state.
+    store(agent_data.velocities.x + i, select(aliveMask, vx, oldVx));
+    store(agent_data.velocities.y + i, select(aliveMask, vy, oldVy));
+    f4 lx, ly;
+    load_xy(agent_data.last_coordinates + i, lx, ly);
+    store_xy(agent_data.last_coordinates + i, select(aliveMask, px, lx), select(aliveMask, py, ly));
+  }
+
+  for (; i < end; ++i) {
+    if (agent_data.is_alive[i]) integrate_agent_velocity(i, deltaTime, nc);
+  }
+}
+
+void update_agent_move(int idx, float deltaTime, const NavConstants& nc) {
   Point2 moveVector = agent_data.velocities[idx] * deltaTime;
   const float moveLnSq = math::length_sq(moveVector);
 
@@ -119,7 +242,7 @@ void update_agent_phys(int idx, float deltaTime) {
         if (!g_wall_contact.empty() && g_wall_contact[idx] == 0) {
           g_wall_contact[idx] = 1;
         }
-        agent_data.stuck_ratings[idx] += STUCK_HIT_WALL;
+        agent_data.stuck_ratings[idx] += nc.stuck_hit_wall;
         Point2 wallVector = std::get<1>(raycastResult) - std::get<0>(raycastResult);
         Point2 wallNormal = {-wallVector.y, wallVector.x};
         math::normalize_inplace(wallNormal);
@@ -146,7 +269,7 @@ void update_agent_phys(int idx, float deltaTime) {
   int newTri = is_point_in_navmesh(agent_data.positions[idx], agent_data.current_tris[idx]);
   if (oldTri != newTri && newTri != -1) {
     if (newTri >= g_navmesh.walkable_triangle_count) {
-      printf("WA agent %d changed to unwalkable triangle from %d to %d. Walkable limit: %d\n", idx, oldTri, newTri, g_navmesh.walkable_triangle_count);
+      TRACE_WARN(TRACE_UNWALKABLE_TRIANGLE, idx, oldTri, newTri, g_navmesh.walkable_triangle_count);
     }
   }
   if (newTri != -1) {
@@ -157,3 +280,8 @@ void update_agent_phys(int idx, float deltaTime) {
     agent_data.current_tris[idx] = -1;
   }
 }
+
+void update_agent_phys(int idx, float deltaTime, const NavConstants& nc) {
+  integrate_agent_velocity(idx, deltaTime, nc);
+  update_agent_move(idx, deltaTime, nc);
+}
@@ -2,7 +2,15 @@
 #define AGENT_MOVE_PHYS_H
 
 #include "data_structures.h"
+#include "nav_constants.h"
 
-void update_agent_phys(int idx, float deltaTime);
+// Scalar reference: last_coordinates, desired velocity, acceleration, resistance.
+void integrate_agent_velocity(int idx, float deltaTime, const NavConstants& nc);
+// Same as integrate_agent_velocity for all alive agents in [begin, end), four lanes at a time.
+void integrate_agent_velocities(int begin, int end, float deltaTime, const NavConstants& nc);
+// Applies the velocity: wall response, escape handling and current triangle update.
+void update_agent_move(int idx, float deltaTime, const NavConstants& nc);
+// integrate_agent_velocity followed by update_agent_move.
+void update_agent_phys(int idx, float deltaTime, const NavConstants& nc);
 
 #endif // AGENT_MOVE_PHYS_H
@@ -3,55 +3,76 @@
 #include "path_corners.h"
 #include "raycasting.h"
 #include "path_patching.h"
-#include "constants_layout.h"
+#include "nav_constants.h"
+#include "trace_log.h"
+#include "nav_telemetry.h"
 #include <vector>
 #include <iostream>
  
 
 extern Navmesh g_navmesh;
 
+// Stores the next corners of agent idx, found from its position along its
+// corridor to its end target. Returns false, leaving them as they were, when
+// there are none.
+static bool store_next_corners(int idx, const NavConstants& nc) {
+  const DualCorner dc = find_next_corner(agent_data.positions[idx], agent_data.corridors[idx], agent_data.end_targets[idx], nc.corner_offset);
+  if (dc.numValid <= 0) return false;
+  agent_data.next_corners[idx] = dc.corner1;
+  agent_data.next_corners2[idx] = dc.corner2;
+  agent_data.next_corner_tris[idx] = dc.tri1;
+  agent_data.next_corner_tris2[idx] = dc.tri2;
+  agent_data.num_valid_corners[idx] = static_cast<uint8_t>(dc.numValid);
+  agent_data.path_frustrations[idx] = 0.0f;
+  agent_data.last_visible_points_for_next_corner[idx] = agent_data.positions[idx];
+  return true;
+}
+
 bool findPathToDestination(
   Navmesh& navmesh,
   int idx,
   int startTri,
   int endTri,
-  const char* errorContext
+  RepathReason reason,
+  const NavConstants& nc
 ) {
   
-  int startPoly = navmesh.triangle_to_polygon[startTri];
-  int endPoly = navmesh.triangle_to_polygon[endTri];
-  std::cout << "findPathToDestination" << std::endl;
+  // Off-mesh agents (or targets) have no triangle, and indexing
+  // triangle_to_polygon with -1 would read out of bounds; findCorridor then
+  // looks the polygon up from the position instead.
+  int startPoly = startTri >= 0 ? navmesh.triangle_to_polygon[startTri] : -1;
+  int endPoly = endTri >= 0 ? navmesh.triangle_to_polygon[endTri] : -1;
+  NAV_COUNT(repaths[reason]);
+  TRACE_DEBUG(TRACE_FIND_PATH, idx, startTri, endTri, static_cast<uint32_t>(reason));
   
-  bool pathFound = findCorridor(navmesh, PATH_FREE_WIDTH, PATH_WIDTH_PENALTY_MULT, agent_data.positions[idx], agent_data.end_targets[idx], agent_data.corridors[idx], startPoly, endPoly);
+  bool pathFound = findCorridor(navmesh, nc.path_free_width, nc.path_width_penalty_mult, nc.congestion_cost_mult, agent_data.positions[idx], agent_data.end_targets[idx], agent_data.corridors[idx], startPoly, endPoly);
   
   if (pathFound) {
-    DualCorner reusableDualCorner = find_next_corner(agent_data.positions[idx], agent_data.corridors[idx], agent_data.end_targets[idx], CORNER_OFFSET);
-    
-    if (reusableDualCorner.numValid > 0) {
-      
-      agent_data.next_corners[idx] = reusableDualCorner.corner1;
-      agent_data.next_corners2[idx] = reusableDualCorner.corner2;
-      agent_data.next_corner_tris[idx] = reusableDualCorner.tri1;
-      agent_data.next_corner_tris2[idx] = reusableDualCorner.tri2;
-      agent_data.num_valid_corners[idx] = reusableDualCorner.numValid;
-      agent_data.path_frustrations[idx] = 0;
-      agent_data.last_visible_points_for_next_corner[idx] = agent_data.positions[idx];
+    if (store_next_corners(idx, nc)) {
       return true;
     } else {
-      
+      NAV_COUNT(corner_recompute_empty);
+      NAV_COUNT(repath_failures[reason]);
       return false;
     }
   } else {
-    
+    NAV_COUNT(repath_failures[reason]);
     return false;
   }
 }
 
+bool recalc_agent_corners(int idx, const NavConstants& nc) {
+  if (store_next_corners(idx, nc)) return true;
+  agent_data.num_valid_corners[idx] = 0;
+  return false;
+}
+
 bool raycastAndPatchCorridor(
   Navmesh& navmesh,
   int idx,
   const Point2& targetPoint,
-  int targetTri
+  int targetTri,
+  const NavConstants& nc
 ) {
   RaycastCorridorResult raycastResult = raycastCorridor(agent_data.positions[idx], targetPoint, agent_data.current_tris[idx], targetTri);
 
@@ -87,17 +108,18 @@ bool raycastAndPatchCorridor(
       newCorridor.insert(newCorridor.end(), raycastPolyCorridor.begin(), raycastPolyCorridor.end());
 
       agent_data.corridors[idx] = newCorridor;
-
+      NAV_COUNT(patch_direct_ok);
       return true;
     } else if (!raycastPolyCorridor.empty()) {
       
       agent_data.corridors[idx] = raycastPolyCorridor;
+      NAV_COUNT(patch_direct_ok);
       return true;
     }
   }
   else {
     
-    return attempt_path_patch(navmesh, idx, raycastResult.hitV1_idx, raycastResult.hitV2_idx, raycastResult.hitTri_idx, triCorridor);
+    return attempt_path_patch(navmesh, idx, raycastResult.hitV1_idx, raycastResult.hitV2_idx, raycastResult.hitTri_idx, triCorridor, nc);
   }
 
   return false;
@@ -2,18 +2,29 @@
 
 #include "data_structures.h"
 #include "navmesh.h"
+#include "nav_telemetry.h"
+#include "nav_constants.h"
 
+// Searches a new corridor from the agent to its end target and sets its next
+// corners. startTri or endTri may be -1 (off the navmesh); the polygon is then
+// looked up from the position.
 bool findPathToDestination(
   Navmesh& navmesh,
   int idx,
   int startTri,
   int endTri,
-  const char* errorContext
+  RepathReason reason,
+  const NavConstants& nc
 );
 
+// Recomputes the agent's next corners from its position, corridor and end
+// target. Returns false (no valid corners) if the corridor leads nowhere.
+bool recalc_agent_corners(int idx, const NavConstants& nc);
+
 bool raycastAndPatchCorridor(
   Navmesh& navmesh,
   int idx,
   const Point2& targetPoint,
-  int targetTri
+  int targetTri,
+  const NavConstants& nc
 ); 
\ No newline at end of file
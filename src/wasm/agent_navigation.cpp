@@ -4,10 +4,9 @@
 #include "data_structures.h"
 #include "constants_layout.h"
 #include "agent_nav_utils.h"
-#include <iostream>
-#include <iomanip>
-#include <sstream>
-#include "wasm_log.h"
+#include "trace_log.h"
+#include "nav_telemetry.h"
+#include "path_workers.h"
 
 extern Navmesh g_navmesh;
 extern float g_sim_time;
@@ -18,7 +17,7 @@ Point2 tempLastVec = {0, 0};
 
 void reset_agent_stuck(int i);
 
-void update_agent_navigation(int idx, float deltaTime, uint64_t* rng_seed) {
+void update_agent_navigation(int idx, float deltaTime, uint64_t* rng_seed, const NavConstants& nc) {
   AgentState state = (AgentState)agent_data.states[idx];
 
   if (state != AgentState::Traveling && state != AgentState::Escaping) {
@@ -27,18 +26,16 @@ void update_agent_navigation(int idx, float deltaTime, uint64_t* rng_seed) {
 
   if (state == AgentState::Traveling) {
     if (agent_data.predicament_ratings[idx] > 37) {
-      {
-        std::ostringstream _oss; _oss.setf(std::ios::fixed); _oss << std::setprecision(2);
-        _oss << "[WASM] Predicament rating is too high, resetting. (" << agent_data.positions[idx].x << ", " << agent_data.positions[idx].y << ")";
-        wasm_console_error(_oss.str());
-      }
+      TRACE_ERROR(TRACE_PREDICAMENT_RESET, idx, agent_data.positions.x[idx], agent_data.positions.y[idx]);
       agent_data.states[idx] = AgentState::Standing;
       agent_data.corridors[idx].clear();
       return;
     }
 
     if (agent_data.corridors[idx].empty()) {
-      findPathToDestination(g_navmesh, idx, agent_data.current_tris[idx], agent_data.end_target_tris[idx], "from start");
+      // A corridor from the path workers arrives at the start of a later step.
+      if (agent_path_pending(idx)) return;
+      findPathToDestination(g_navmesh, idx, agent_data.current_tris[idx], agent_data.end_target_tris[idx], REPATH_FROM_START, nc);
     }
 
     if (agent_data.current_tris[idx] == -1) {
@@ -51,27 +48,27 @@ void update_agent_navigation(int idx, float deltaTime, uint64_t* rng_seed) {
     }
 
     float dangeMult = 2 - agent_data.intelligences[idx];
-    if (agent_data.stuck_ratings[idx] > STUCK_DANGER_1 * dangeMult) {
+    if (agent_data.stuck_ratings[idx] > nc.stuck_danger_1 * dangeMult) {
       bool needFullRepath = false;
       if (agent_data.sight_ratings[idx] < 1) {
         agent_data.sight_ratings[idx]++;
-        if (raycastAndPatchCorridor(g_navmesh, idx, agent_data.next_corners[idx], agent_data.next_corner_tris[idx])) {
+        if (raycastAndPatchCorridor(g_navmesh, idx, agent_data.next_corners[idx], agent_data.next_corner_tris[idx], nc)) {
           agent_data.stuck_ratings[idx] = 0;
         } else {
           needFullRepath = true;
         }
       }
-      else if (agent_data.stuck_ratings[idx] > STUCK_DANGER_2 * dangeMult) {
+      else if (agent_data.stuck_ratings[idx] > nc.stuck_danger_2 * dangeMult) {
         float velocityMagSq = math::length_sq(agent_data.velocities[idx]);
         float maxSpeedSq = agent_data.max_speeds[idx] * agent_data.max_speeds[idx];
-        needFullRepath = agent_data.stuck_ratings[idx] > STUCK_DANGER_3 * dangeMult || velocityMagSq < maxSpeedSq * 0.0025f;
+        needFullRepath = agent_data.stuck_ratings[idx] > nc.stuck_danger_3 * dangeMult || velocityMagSq < maxSpeedSq * 0.0025f;
       }
 
       if (needFullRepath) {
         agent_data.predicament_ratings[idx]++;
-        if (findPathToDestination(g_navmesh, idx, agent_data.current_tris[idx], agent_data.end_target_tris[idx], "from stuck")) {
+        if (findPathToDestination(g_navmesh, idx, agent_data.current_tris[idx], agent_data.end_target_tris[idx], REPATH_FROM_STUCK, nc)) {
         } else {
-          wasm_console_error("[WASM] Pathfinding failed to find a corner after getting stuck.");
+          TRACE_ERROR(TRACE_NO_CORNER_AFTER_STUCK, idx);
         }
         reset_agent_stuck(idx);
       }
@@ -81,7 +78,7 @@ void update_agent_navigation(int idx, float deltaTime, uint64_t* rng_seed) {
     auto& corridor = agent_data.corridors[idx];
     
     if (agent_data.alien_polys[idx] != currentPoly) {
-      const int maxCheck = std::min((int)CORRIDOR_EXPECTED_JUMP, (int)corridor.size());
+      const int maxCheck = std::min((int)nc.corridor_expected_jump, (int)corridor.size());
       int currentCorridorPolyIndex = -1;
 
       const int corridorSize = corridor.size();
@@ -99,14 +96,14 @@ void update_agent_navigation(int idx, float deltaTime, uint64_t* rng_seed) {
         agent_data.path_frustrations[idx]++;
         if (agent_data.path_frustrations[idx] > agent_data.max_frustrations[idx]) {
           agent_data.path_frustrations[idx] = 0;
-          if (findPathToDestination(g_navmesh, idx, agent_data.current_tris[idx], agent_data.end_target_tris[idx], "after path recovery")){
+          if (findPathToDestination(g_navmesh, idx, agent_data.current_tris[idx], agent_data.end_target_tris[idx], REPATH_AFTER_PATH_RECOVERY, nc)){
           } else {
-            if (raycastAndPatchCorridor(g_navmesh, idx, agent_data.end_targets[idx], agent_data.end_target_tris[idx])) {
+            if (raycastAndPatchCorridor(g_navmesh, idx, agent_data.end_targets[idx], agent_data.end_target_tris[idx], nc)) {
               agent_data.next_corners[idx] = agent_data.end_targets[idx];
               agent_data.next_corner_tris[idx] = agent_data.end_target_tris[idx];
               agent_data.num_valid_corners[idx] = 1;
             } else {
-              wasm_console_error("[WASM] Pathfinding failed to recover the path.");
+              TRACE_ERROR(TRACE_PATH_RECOVERY_FAILED, idx);
             }
           }
         } else {
@@ -135,16 +132,18 @@ void update_agent_navigation(int idx, float deltaTime, uint64_t* rng_seed) {
       crossedDemarkationLine = currentCross * lastCross <= 0;
     }
 
-    if (agent_data.num_valid_corners[idx] == 2 && (distanceToCornerSq < CORNER_OFFSET_SQ || crossedDemarkationLine)) {
+    if (agent_data.num_valid_corners[idx] == 2 && (distanceToCornerSq < nc.corner_offset_sq || crossedDemarkationLine)) {
       agent_data.last_visible_points_for_next_corner[idx] = agent_data.next_corners[idx];
       
-      DualCorner corners = find_next_corner(agent_data.positions[idx], agent_data.corridors[idx], agent_data.end_targets[idx], CORNER_OFFSET);
+      DualCorner corners = find_next_corner(agent_data.positions[idx], agent_data.corridors[idx], agent_data.end_targets[idx], nc.corner_offset);
       if (corners.numValid > 0) {
         agent_data.next_corners[idx] = corners.corner1;
         agent_data.next_corner_tris[idx] = corners.tri1;
         agent_data.next_corners2[idx] = corners.corner2;
         agent_data.next_corner_tris2[idx] = corners.tri2;
         agent_data.num_valid_corners[idx] = corners.numValid;
+      } else {
+        NAV_COUNT(corner_recompute_empty);
       }
     }
 
@@ -158,7 +157,7 @@ void update_agent_navigation(int idx, float deltaTime, uint64_t* rng_seed) {
       agent_data.states[idx] = AgentState::Traveling;
       
       if (agent_data.pre_escape_corner_tris[idx] != -1) {
-        if (raycastAndPatchCorridor(g_navmesh, idx, agent_data.pre_escape_corners[idx], agent_data.pre_escape_corner_tris[idx])) {
+        if (raycastAndPatchCorridor(g_navmesh, idx, agent_data.pre_escape_corners[idx], agent_data.pre_escape_corner_tris[idx], nc)) {
           agent_data.next_corners[idx] = agent_data.pre_escape_corners[idx];
           agent_data.next_corner_tris[idx] = agent_data.pre_escape_corner_tris[idx];
           agent_data.pre_escape_corners[idx] = {0, 0};
@@ -168,13 +167,13 @@ void update_agent_navigation(int idx, float deltaTime, uint64_t* rng_seed) {
       }
       
       if (agent_data.end_target_tris[idx] != -1) {
-        if (findPathToDestination(g_navmesh, idx, agent_data.current_tris[idx], agent_data.end_target_tris[idx], "after escaping")) {
+        if (findPathToDestination(g_navmesh, idx, agent_data.current_tris[idx], agent_data.end_target_tris[idx], REPATH_AFTER_ESCAPING, nc)) {
           agent_data.states[idx] = AgentState::Traveling;
         } else {
-          wasm_console_error("[WASM] Pathfinding failed to find a corner after escaping.");
+          TRACE_ERROR(TRACE_NO_CORNER_AFTER_ESCAPE, idx);
         }
       } else {
-        wasm_console_error("[WASM] Original end target is not on navmesh after escaping.");
+        TRACE_ERROR(TRACE_END_TARGET_OFF_NAVMESH, idx);
       }
     }
   }
@@ -2,7 +2,8 @@
 #define AGENT_NAVIGATION_H
 
 #include "data_structures.h"
+#include "nav_constants.h"
 
-void update_agent_navigation(int idx, float deltaTime, uint64_t* rng_seed);
+void update_agent_navigation(int idx, float deltaTime, uint64_t* rng_seed, const NavConstants& nc);
 
 #endif // AGENT_NAVIGATION_H
@@ -17,7 +17,7 @@ void reset_agent_stuck(int i) {
   agent_data.last_end_targets[i] = agent_data.end_targets[i];
 }
 
-void update_agent_statistic(int i, float dt) {
+void update_agent_statistic(int i, float dt, const NavConstants& nc) {
   if (dt == 0.0f) return;
 
   if (agent_data.last_end_targets[i].x != agent_data.end_targets[i].x || 
@@ -30,7 +30,7 @@ void update_agent_statistic(int i, float dt) {
     float velocity_factor = velocity_magnitude / agent_data.max_speeds[i];
     float vf_cubed = velocity_factor * velocity_factor * velocity_factor;
     float velocity_mult = math::lerp(2.0f, 0.4f, vf_cubed);
-    agent_data.stuck_ratings[i] += STUCK_PASSIVE_X1 * dt * velocity_mult;
+    agent_data.stuck_ratings[i] += nc.stuck_passive_x1 * dt * velocity_mult;
 
     float dist = math::distance(agent_data.positions[i], agent_data.next_corners[i]);
 
@@ -42,7 +42,7 @@ void update_agent_statistic(int i, float dt) {
 
     float distance_decrease = agent_data.last_distances_to_next_corner[i] - dist;
     if (distance_decrease > 0) {
-      float mult = (2.0f - agent_data.intelligences[i]) / agent_data.max_speeds[i] * STUCK_DST_X2;
+      float mult = (2.0f - agent_data.intelligences[i]) / agent_data.max_speeds[i] * nc.stuck_dst_x2;
       float decrease_factor = distance_decrease / (velocity_magnitude * dt);
       agent_data.stuck_ratings[i] -= decrease_factor * mult;
       agent_data.last_distances_to_next_corner[i] = dist;
@@ -51,11 +51,11 @@ void update_agent_statistic(int i, float dt) {
 
   int corridor_decrease = agent_data.min_corridor_lengths[i] - agent_data.corridors[i].size();
   if (corridor_decrease > 0) {
-    agent_data.stuck_ratings[i] -= corridor_decrease * STUCK_CORRIDOR_X3;
+    agent_data.stuck_ratings[i] -= corridor_decrease * nc.stuck_corridor_x3;
     agent_data.min_corridor_lengths[i] = agent_data.corridors[i].size();
   }
 
-  agent_data.stuck_ratings[i] *= pow(STUCK_DECAY, dt);
+  agent_data.stuck_ratings[i] *= pow(nc.stuck_decay, dt);
 
   if (agent_data.stuck_ratings[i] < 0) {
     agent_data.stuck_ratings[i] = 0;
@@ -1,7 +1,9 @@
 #ifndef AGENT_STATISTIC_H
 #define AGENT_STATISTIC_H
 
+#include "nav_constants.h"
+
 void reset_agent_stuck(int agent_index);
-void update_agent_statistic(int agent_index, float dt);
+void update_agent_statistic(int agent_index, float dt, const NavConstants& nc);
 
 #endif // AGENT_STATISTIC_H 
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "agent_watch.h"
+#include "data_structures.h"
+#include "event_buffer.h"
+#include "event_handler.h"
+#include <algorithm>
+#include <cstring>
+
+extern AgentSoA agent_data;
+
+AgentWatchList g_agent_watches;
+
+namespace {
+
+// Corridors are stored end polygon first and agents trim them from the back
+// as they advance, so the shared prefix is usually almost all of it.
+uint32_t common_prefix(const std::vector<int>& a, const std::vector<int>& b) {
+  const size_t n = std::min(a.size(), b.size());
+  size_t i = 0;
+  while (i < n && a[i] == b[i]) ++i;
+  return static_cast<uint32_t>(i);
+}
+
+bool same_point(Point2 a, Point2 b) {
+  return a.x == b.x && a.y == b.y;
+}
+
+// false if the report did not fit and has to wait.
+bool emit_corridor(AgentWatch& w) {
+  const std::vector<int>& corridor = agent_data.corridors[w.agent];
+  const uint32_t keep = w.primed ? common_prefix(w.last_corridor, corridor) : 0u;
+  if (w.primed && keep == corridor.size() && keep == w.last_corridor.size()) return true;
+
+  // [agent][keep][polys appended after trimming to keep...]
+  const uint32_t append = static_cast<uint32_t>(corridor.size()) - keep;
+  const uint32_t size = 4 + append;
+  if (size > g_event_ring.cap_words) return true;  // never fits; TS keeps the old corridor
+  if (size > g_event_ring.room()) return false;
+  uint32_t* out = g_event_ring.reserve(EVT_CORRIDOR_DELTA, size);
+  out[2] = static_cast<uint32_t>(w.agent);
+  out[3] = keep;
+  std::memcpy(out + 4, corridor.data() + keep, append * sizeof(int));
+  w.last_corridor = corridor;
+  return true;
+}
+
+bool emit_state(AgentWatch& w) {
+  const int idx = w.agent;
+  const uint8_t state = static_cast<uint8_t>(agent_data.states[idx]);
+  const uint8_t cornerCount = agent_data.num_valid_corners[idx];
+  const Point2 c0 = agent_data.next_corners[idx];
+  const Point2 c1 = agent_data.next_corners2[idx];
+  bool changed = !w.primed;
+  if (w.fields & WATCH_STATE) changed |= state != w.last_state;
+  if (w.fields & WATCH_CORNERS) {
+    changed |= cornerCount != w.last_corner_count || !same_point(c0, w.last_corners[0]) || !same_point(c1, w.last_corners[1]);
+  }
+  if (!changed) return true;
+
+  // [agent][state][corner count][f32 corner x, y][f32 corner2 x, y]
+  if (g_event_ring.room() < 9) return false;
+  uint32_t* out = g_event_ring.reserve(EVT_AGENT_STATE, 9);
+  float* f = reinterpret_cast<float*>(out);
+  out[2] = static_cast<uint32_t>(idx);
+  out[3] = state;
+  out[4] = cornerCount;
+  f[5] = c0.x;
+  f[6] = c0.y;
+  f[7] = c1.x;
+  f[8] = c1.y;
+  w.last_state = state;
+  w.last_corner_count = cornerCount;
+  w.last_corners[0] = c0;
+  w.last_corners[1] = c1;
+  return true;
+}
+
+} // namespace
+
+void watch_agent(int agent, uint32_t fields) {
+  if (agent < 0) return;
+  AgentWatchList& list = g_agent_watches;
+  if (static_cast<size_t>(agent) >= list.slot_of_agent.size()) list.slot_of_agent.resize(agent + 1, -1);
+  const int32_t slot = list.slot_of_agent[agent];
+
+  if (fields == 0) {
+    if (slot < 0) return;
+    // Swap-remove; the moved watch's slot follows it.
+    list.slot_of_agent[list.watches.back().agent] = slot;
+    std::swap(list.watches[slot], list.watches.back());
+    list.watches.pop_back();
+    list.slot_of_agent[agent] = -1;
+    return;
+  }
+
+  if (slot < 0) {
+    list.slot_of_agent[agent] = static_cast<int32_t>(list.watches.size());
+    list.watches.push_back(AgentWatch{agent, fields, false, 0, 0, {}, {}});
+    return;
+  }
+  AgentWatch& w = list.watches[slot];
+  // Newly added fields have nothing on the TS side yet.
+  if (fields & ~w.fields) w.primed = false;
+  w.fields = fields;
+}
+
+void emit_agent_watch_events(int activeAgents) {
+  for (AgentWatch& w : g_agent_watches.watches) {
+    if (w.agent >= activeAgents) continue;
+    if ((w.fields & WATCH_CORRIDOR) && !emit_corridor(w)) return;
+    if ((w.fields & (WATCH_STATE | WATCH_CORNERS)) && !emit_state(w)) return;
+    w.primed = true;
+  }
+}
+
+void reset_agent_watches() {
+  for (AgentWatch& w : g_agent_watches.watches) w.primed = false;
+}
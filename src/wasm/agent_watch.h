@@ -0,0 +1,54 @@
+#ifndef AGENT_WATCH_H
+#define AGENT_WATCH_H
+
+#include <cstdint>
+#include <vector>
+#include "point2.h"
+
+// Agent subscriptions (CMD_WATCH_AGENTS): TS names agents and fields, and
+// emit_events reports a watched agent only when one of its fields changed
+// since the last report. Corridors go out as EVT_CORRIDOR_DELTA trim/append
+// operations, state and corners as EVT_AGENT_STATE. The first report after
+// subscribing (or after reset_agent_watches) carries the full value.
+
+enum AgentWatchFields : uint32_t {
+  WATCH_CORRIDOR = 1,
+  WATCH_STATE = 2,
+  WATCH_CORNERS = 4,
+};
+
+struct AgentWatch {
+  int agent;
+  uint32_t fields;
+  bool primed;               // last_* below hold what TS has
+  uint8_t last_state;
+  uint8_t last_corner_count;
+  Point2 last_corners[2];
+  std::vector<int> last_corridor;
+};
+
+// Watches in subscribe order plus an agent -> watch index map (-1 = none).
+struct AgentWatchList {
+  std::vector<AgentWatch> watches;
+  std::vector<int32_t> slot_of_agent;
+
+  void swap(AgentWatchList& other) {
+    watches.swap(other.watches);
+    slot_of_agent.swap(other.slot_of_agent);
+  }
+};
+
+extern AgentWatchList g_agent_watches;
+
+// Replaces the watched fields of agent; fields == 0 unsubscribes it.
+void watch_agent(int agent, uint32_t fields);
+
+// Reserves the changes of every watched agent below activeAgents in
+// g_event_ring. A report that does not fit waits for the next call.
+void emit_agent_watch_events(int activeAgents);
+
+// Keeps the subscriptions but resends full values on the next emit. After
+// agents or the navmesh are replaced.
+void reset_agent_watches();
+
+#endif // AGENT_WATCH_H
@@ -1,4 +1,25 @@
 #pragma once
 
 void point_in_triangle_bench(); 
-void point_in_polygon_bench(); 
\ No newline at end of file
+void point_in_polygon_bench();
+void phys_simd_bench();
+void nav_constants_bench(); 
+// Largest position gap allowed between the SIMD and scalar velocity passes
+// after one physics step from the same state.
+const float PHYS_SIMD_TOLERANCE = 1e-2f;
+
+struct PhysSimdComparison {
+  int agents = 0;          // alive agents compared
+  int steps = 0;
+  double scalar_ms = 0.0;  // velocity pass only
+  double simd_ms = 0.0;
+  float max_deviation = 0.0f;
+  int worst_agent = -1;
+};
+
+// Replays agents [0, n) for steps physics steps along the scalar trajectory,
+// running the SIMD velocity pass beside the scalar one at every step, and
+// reports the largest per-step position gap. The agent state is restored
+// afterwards. Call with the simulation thread stopped or
+// g_sim_mutex held.
+PhysSimdComparison compare_phys_simd_trajectory(int n, int steps, float dt);
@@ -31,9 +31,12 @@ extern uint8_t* g_constants_buffer; // defined in main.cpp
 #define OFFSET_CORNER_OFFSET_SQ 72
 #define OFFSET_PATH_FREE_WIDTH 76
 #define OFFSET_PATH_WIDTH_PENALTY_MULT 80
+#define OFFSET_CONGESTION_COST_MULT 84
+#define OFFSET_CONGESTION_DECAY 88
+#define OFFSET_CONGESTION_UPDATE_FRAMES 92
 
 // Named macros for convenience
-// All floats except PATH_LOG_RATE
+// All floats except PATH_LOG_RATE and CONGESTION_UPDATE_FRAMES
 #define STUCK_PASSIVE_X1 CONST_F32_AT(OFFSET_STUCK_PASSIVE_X1)
 #define STUCK_DST_X2 CONST_F32_AT(OFFSET_STUCK_DST_X2)
 #define STUCK_CORRIDOR_X3 CONST_F32_AT(OFFSET_STUCK_CORRIDOR_X3)
@@ -55,5 +58,8 @@ extern uint8_t* g_constants_buffer; // defined in main.cpp
 #define MAX_FRUSTRATION_DEFAULT CONST_F32_AT(OFFSET_MAX_FRUSTRATION_DEFAULT)
 #define PATH_FREE_WIDTH CONST_F32_AT(OFFSET_PATH_FREE_WIDTH)
 #define PATH_WIDTH_PENALTY_MULT CONST_F32_AT(OFFSET_PATH_WIDTH_PENALTY_MULT)
+#define CONGESTION_COST_MULT CONST_F32_AT(OFFSET_CONGESTION_COST_MULT)
+#define CONGESTION_DECAY CONST_F32_AT(OFFSET_CONGESTION_DECAY)
+#define CONGESTION_UPDATE_FRAMES CONST_I32_AT(OFFSET_CONGESTION_UPDATE_FRAMES)
 
 #endif // CONSTANTS_LAYOUT_H
\ No newline at end of file
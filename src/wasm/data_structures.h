@@ -15,13 +15,45 @@ enum AgentState : uint8_t {
 
 // Note: Navmesh data structures are now defined in navmesh.h
 
+// Reference to one element of a SplitPoint2 column. Behaves like a Point2
+// lvalue so per-agent code can keep using agent_data.positions[idx].
+// Do not hold it with `auto` beyond the statement if a copy is intended.
+struct Point2Ref {
+  float& x;
+  float& y;
+
+  Point2Ref(float* px, float* py) : x(*px), y(*py) {}
+  operator Point2() const { return Point2(x, y); }
+
+  Point2Ref& operator=(const Point2& p) { x = p.x; y = p.y; return *this; }
+  Point2Ref& operator=(const Point2Ref& p) { x = p.x; y = p.y; return *this; }
+  Point2Ref& operator+=(const Point2& p) { x += p.x; y += p.y; return *this; }
+  Point2Ref& operator-=(const Point2& p) { x -= p.x; y -= p.y; return *this; }
+  Point2Ref& operator*=(float s) { x *= s; y *= s; return *this; }
+  Point2Ref& operator/=(float s) { x /= s; y /= s; return *this; }
+
+  Point2 operator+(const Point2& p) const { return Point2(x + p.x, y + p.y); }
+  Point2 operator-(const Point2& p) const { return Point2(x - p.x, y - p.y); }
+  Point2 operator*(float s) const { return Point2(x * s, y * s); }
+  Point2 operator/(float s) const { return Point2(x / s, y / s); }
+};
+
+// Point2 column stored as separate x[] and y[] streams (SIMD friendly).
+struct SplitPoint2 {
+  float* x;
+  float* y;
+
+  Point2Ref operator[](int idx) const { return Point2Ref(x + idx, y + idx); }
+};
+
 // Defines the Structure of Arrays (SoA) layout for all agents.
 // All arrays are views into a single SharedArrayBuffer managed by JavaScript.
+// Placement of the shared columns is driven by AGENT_COLUMNS in agent_layout.h.
 struct AgentSoA {
   // Core physics
-  Point2* positions;
+  SplitPoint2 positions;
   Point2* last_coordinates;
-  Point2* velocities;
+  SplitPoint2 velocities;
   Point2* looks;
   AgentState* states;
   bool* is_alive;
@@ -66,7 +98,6 @@ struct AgentSoA {
   std::vector<int>* corridors;
   int* corridor_indices;
 
-  // Placed at the very end of the shared layout
   uint16_t* frame_ids;
 
   int capacity;
@@ -76,6 +107,8 @@ struct AgentGridData {
   std::vector<uint16_t> cell_data;
   std::vector<uint32_t> cell_offsets;
   std::vector<uint16_t> cell_counts;
+  int indexed_agents = -1;  // num_agents of the last reindex; -1 = stale
+  bool overflowed = false;  // a cell hit MAX_AGENTS_PER_CELL and dropped agents
 };
 
 struct BoundingBox {
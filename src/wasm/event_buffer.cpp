@@ -1,31 +1,82 @@
 ﻿#include "event_buffer.h"
 #include <emscripten/emscripten.h>
 #include "wasm_log.h"
+#include <algorithm>
 
-EventBuffer g_event_buffer;
+EventRing g_command_ring;
+EventRing g_event_ring;
 
-void EventBuffer::set(uint8_t* base, uint32_t cap_words_) {
-  uintptr_t addr = reinterpret_cast<uintptr_t>(base);
-  addr = (addr + 3) & ~static_cast<uintptr_t>(3);
-  u32_base = reinterpret_cast<uint32_t*>(addr);
-  f32_base = reinterpret_cast<float*>(addr);
-  cap_words = cap_words_;
-  cursor = 0u;
+bool EventRing::set(uint8_t* base, uint32_t capWords) {
+  const bool valid = base && capWords >= 2 && (capWords & (capWords - 1)) == 0;
+  if (!valid) {
+    if (base) wasm_console_error("[WASM] Event ring capacity must be a power of two");
+    header = nullptr;
+    u32_base = nullptr;
+    f32_base = nullptr;
+    cap_words = 0u;
+    return false;
+  }
+  header = reinterpret_cast<EventRingHeader*>(base);
+  header->write.store(0u, std::memory_order_relaxed);
+  header->read.store(0u, std::memory_order_relaxed);
+  header->cap_words = capWords;
+  header->dropped_events = 0u;
+  header->dropped_words = 0u;
+  header->peak_words = 0u;
+  u32_base = reinterpret_cast<uint32_t*>(base) + EVENT_RING_HEADER_WORDS;
+  f32_base = reinterpret_cast<float*>(u32_base);
+  cap_words = capWords;
+  pending_write = 0u;
+  read_pos = 0u;
+  return true;
 }
 
-void EventBuffer::begin_frame() {
-  cursor = 0u;
+uint32_t* EventRing::reserve(uint32_t type, uint32_t size_words) {
+  if (!header) return nullptr;
+  const uint32_t read = header->read.load(std::memory_order_acquire);
+  const uint32_t pos = pending_write & (cap_words - 1);
+  // Events never straddle the end; the words up to it are skipped instead.
+  const uint32_t skip = size_words > cap_words - pos ? cap_words - pos : 0u;
+  if (size_words < 2 || pending_write - read + skip + size_words > cap_words) {
+    if (header->dropped_events++ == 0) wasm_console_error("[WASM] Event ring full, dropping events");
+    header->dropped_words += size_words;
+    return nullptr;
+  }
+  if (skip) {
+    u32_base[pos] = 0u;
+    pending_write += skip;
+  }
+  uint32_t* event = u32_base + (pending_write & (cap_words - 1));
+  event[0] = size_words;
+  event[1] = type;
+  pending_write += size_words;
+  if (pending_write - read > header->peak_words) header->peak_words = pending_write - read;
+  return event;
 }
 
-void EventBuffer::commit_frame() {
-  if (u32_base && cursor < cap_words) u32_base[cursor] = 0u;
+uint32_t EventRing::room() const {
+  if (!header) return 0u;
+  const uint32_t free = cap_words - (pending_write - header->read.load(std::memory_order_acquire));
+  const uint32_t toEnd = cap_words - (pending_write & (cap_words - 1));
+  return free > toEnd ? std::max(toEnd, free - toEnd) : free;
 }
 
-void EventBuffer::write_header(uint16_t type, uint16_t size_words) {
-  if (cursor + size_words >= cap_words){
-    wasm_console_error("Event buffer full");
-    return;
+void EventRing::publish() {
+  if (header) header->write.store(pending_write, std::memory_order_release);
+}
+
+const uint32_t* EventRing::front() {
+  if (!header) return nullptr;
+  const uint32_t write = header->write.load(std::memory_order_acquire);
+  while (read_pos != write) {
+    const uint32_t pos = read_pos & (cap_words - 1);
+    if (u32_base[pos] != 0u) return u32_base + pos;
+    read_pos += cap_words - pos;  // wrap marker
   }
-  u32_base[cursor] = (static_cast<uint32_t>(size_words) << 16) | static_cast<uint32_t>(type);
-  cursor += size_words;
+  return nullptr;
+}
+
+void EventRing::pop() {
+  read_pos += u32_base[read_pos & (cap_words - 1)];
+  header->read.store(read_pos, std::memory_order_release);
 }
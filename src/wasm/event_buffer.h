@@ -1,23 +1,76 @@
 #ifndef EVENT_BUFFER_H
 #define EVENT_BUFFER_H
 
+#include <atomic>
 #include <cstdint>
 
-class EventBuffer {
+// Single-producer/single-consumer ring of events in shared memory; the TS
+// side (src/logic/EventBuffer.ts) uses the same layout through Atomics, so
+// either end may sit on either thread.
+//
+// Layout: EventRingHeader, then cap_words data words (a power of two). Each
+// event is [size_words][type][payload...], size_words counting the two header
+// words, and is contiguous: an event that does not fit before the end of the
+// data is preceded by a 0 word telling the consumer to continue at word 0.
+// read and write are free-running word counts, so read == write is empty.
+//
+// The producer fills reserved events in place and makes them visible with
+// publish(); the consumer reads front() and frees it with pop(). A reserve
+// that does not fit returns nullptr and is counted in dropped_events and
+// dropped_words; the event is lost.
+
+struct EventRingHeader {
+  std::atomic<uint32_t> write;   // producer
+  uint32_t pad0[15];
+  std::atomic<uint32_t> read;    // consumer
+  uint32_t pad1[15];
+  uint32_t cap_words;
+  uint32_t dropped_events;       // written by the producer only
+  uint32_t dropped_words;
+  uint32_t peak_words;           // highest fill seen by the producer
+  uint32_t pad2[12];
+};
+
+static_assert(sizeof(EventRingHeader) == 192, "EventRing.ts expects a 48-word header");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "ring indices must be plain words for Atomics");
+
+const uint32_t EVENT_RING_HEADER_WORDS = sizeof(EventRingHeader) / 4;
+
+class EventRing {
 public:
-  uint32_t  cursor = 0u;
-  uint32_t* u32_base = nullptr;
-  float*  f32_base = nullptr;
-  uint32_t  cap_words = 0u;
+  EventRingHeader* header = nullptr;
+  uint32_t* u32_base = nullptr;  // data words
+  float* f32_base = nullptr;
+  uint32_t cap_words = 0u;
+
+  // Bytes of a ring holding capWords data words.
+  static uint32_t bytes(uint32_t capWords) { return (EVENT_RING_HEADER_WORDS + capWords) * 4; }
+
+  // Attaches to base (4-byte aligned) and empties the ring. capWords must be
+  // a power of two; a null base detaches (every call is then a no-op).
+  bool set(uint8_t* base, uint32_t capWords);
+
+  // Producer. Returns the event's first word (payload from [2]), or nullptr
+  // if it does not fit.
+  uint32_t* reserve(uint32_t type, uint32_t size_words);
+  // Producer. Largest size_words reserve would accept now.
+  uint32_t room() const;
+  // Producer. Makes every reserved event visible to the consumer.
+  void publish();
 
-  void set(uint8_t* base, uint32_t cap_words);
-  void begin_frame();
-  void commit_frame();
+  // Consumer. Next event or nullptr if there is none.
+  const uint32_t* front();
+  // Consumer. Frees the event returned by front().
+  void pop();
 
-  // Emit header [type:int16 | size:int16]; returns false if insufficient capacity.
-  void write_header(uint16_t type, uint16_t size_words);
+private:
+  uint32_t pending_write = 0u;  // producer's unpublished write position
+  uint32_t read_pos = 0u;       // consumer's position, stored on pop
 };
 
-extern EventBuffer g_event_buffer;
+// TS -> WASM commands, read by process_events.
+extern EventRing g_command_ring;
+// WASM -> TS events, written by Model::emit_events.
+extern EventRing g_event_ring;
 
 #endif // EVENT_BUFFER_H
@@ -2,11 +2,17 @@
 #include "data_structures.h"
 #include "navmesh.h"
 #include "path_corners.h"
-#include "constants_layout.h"
-#include "wasm_log.h"
+#include "nav_constants.h"
+#include "trace_log.h"
+#include "profiler.h"
 #include "event_handler.h"
+#include "agent_nav_utils.h"
+#include "path_workers.h"
+#include "agent_init.h"
+#include "nav_utils.h"
+#include "sim_driver.h"
+#include "agent_watch.h"
 
-extern EventBuffer g_event_buffer;
 extern AgentSoA agent_data;
 extern Navmesh g_navmesh;
 
@@ -16,24 +22,24 @@ enum CorridorAction : uint32_t {
   SET_AND_RECALC_CORNERS = 3,
 };
 
-void process_events() {
-  if (!g_event_buffer.u32_base) return;
-  uint32_t p = 0u;
-  while (g_event_buffer.u32_base[p] != 0u) {
-    const uint32_t header = g_event_buffer.u32_base[p];
-    const uint16_t type = static_cast<uint16_t>(header & 0xffffu);
-    const uint16_t size = static_cast<uint16_t>((header >> 16) & 0xffffu);
+void process_events(const NavConstants& nc) {
+  PROFILE_SCOPE(PROFILE_PROCESS_EVENTS);
+  advance_path_batch();
+  while (const uint32_t* event = g_command_ring.front()) {
+    const uint32_t size = event[0];
+    const uint32_t type = event[1];
+    const uint32_t* payload = event + 2;
 
     switch (type) {
       case CMD_SET_CORRIDOR: {
-        const uint32_t agent_idx = g_event_buffer.u32_base[p + 1];
-        const uint32_t action = g_event_buffer.u32_base[p + 2];
-        const uint32_t count = static_cast<uint32_t>(size - 3);
+        const uint32_t agent_idx = payload[0];
+        const uint32_t action = payload[1];
+        const uint32_t count = size - 4;
 
         auto &corr = agent_data.corridors[agent_idx];
         corr.clear();
         for (uint32_t i = 0; i < count; ++i) {
-          corr.push_back(static_cast<int>(g_event_buffer.u32_base[p + 3 + i]));
+          corr.push_back(static_cast<int>(payload[2 + i]));
         }
         
         if (!corr.empty()) {
@@ -46,29 +52,114 @@ void process_events() {
             agent_data.last_visible_points_for_next_corner[agent_idx] = agent_data.positions[agent_idx];
           } else if (action == SET_AND_RECALC_CORNERS) {
             // Recompute corners from current position and TS-provided end target
-            DualCorner dc = find_next_corner(agent_data.positions[agent_idx], corr, agent_data.end_targets[agent_idx], CORNER_OFFSET);
-            if (dc.numValid > 0) {
-              agent_data.next_corners[agent_idx] = dc.corner1;
-              agent_data.next_corners2[agent_idx] = dc.corner2;
-              agent_data.next_corner_tris[agent_idx] = dc.tri1;
-              agent_data.next_corner_tris2[agent_idx] = dc.tri2;
-              agent_data.num_valid_corners[agent_idx] = static_cast<uint8_t>(dc.numValid);
-              agent_data.path_frustrations[agent_idx] = 0.0f;
-              agent_data.last_visible_points_for_next_corner[agent_idx] = agent_data.positions[agent_idx];
-            } else {
-              agent_data.num_valid_corners[agent_idx] = 0;
-            }
+            recalc_agent_corners(static_cast<int>(agent_idx), nc);
           } else {
             // SET_ONLY: do nothing else; TS may set state/corners
           }
         }
         break;
       }
+      case CMD_FIND_PATH: {
+        const float* f = reinterpret_cast<const float*>(payload + 3);
+        PathRequest request;
+        request.id = payload[0];
+        request.agent = static_cast<int32_t>(payload[1]);
+        request.flags = payload[2];
+        request.start = {f[0], f[1]};
+        request.end = {f[2], f[3]};
+        request.free_width = nc.path_free_width;
+        request.stray_mult = nc.path_width_penalty_mult;
+        request.congestion_mult = nc.congestion_cost_mult;
+        submit_path_request(request);
+        break;
+      }
+      case CMD_SET_TARGETS: {
+        if (size < 4 || payload[1] > (size - 4) / 4) {
+          TRACE_ERROR(TRACE_BAD_COMMAND, -1, type, size);
+          break;
+        }
+        const uint32_t flags = payload[0];
+        const uint32_t count = payload[1];
+        const uint32_t* entry = payload + 2;
+        for (uint32_t i = 0; i < count; ++i, entry += 4) {
+          const int idx = static_cast<int>(entry[0]);
+          if (idx < 0 || idx >= agent_data.capacity || !agent_data.is_alive[idx]) continue;
+          const float* f = reinterpret_cast<const float*>(entry + 1);
+          const Point2 target = {f[0], f[1]};
+          const int32_t tri = static_cast<int32_t>(entry[3]);
+          agent_data.end_targets[idx] = target;
+          agent_data.end_target_tris[idx] = tri >= 0 ? tri : is_point_in_navmesh(target, -1);
+          agent_data.predicament_ratings[idx] = 0;
+          agent_data.corridors[idx].clear();
+          agent_data.states[idx] = AgentState::Traveling;
+          if (flags & TARGETS_FIND_PATH) {
+            PathRequest request;
+            request.id = 0;
+            request.agent = idx;
+            request.flags = PATH_APPLY_TO_AGENT | PATH_NO_RESULT_EVENT;
+            request.start = agent_data.positions[idx];
+            request.end = target;
+            request.free_width = nc.path_free_width;
+            request.stray_mult = nc.path_width_penalty_mult;
+            request.congestion_mult = nc.congestion_cost_mult;
+            submit_path_request(request);
+          }
+        }
+        break;
+      }
+      case CMD_SET_PARAMS: {
+        if (size < 6) {
+          TRACE_ERROR(TRACE_BAD_COMMAND, -1, type, size);
+          break;
+        }
+        const int column = static_cast<int>(payload[0]);
+        const uint32_t words = static_cast<uint32_t>(agent_column_words(column));
+        const uint32_t count = payload[2];
+        const bool broadcast = payload[3] != 0;
+        const uint64_t needed = 6u + static_cast<uint64_t>(words) * (broadcast ? 1u : count);
+        if (words == 0 || needed > size || count > static_cast<uint32_t>(INT32_MAX) ||
+            !write_agent_column(column, static_cast<int>(payload[1]), static_cast<int>(count), payload + 4, broadcast)) {
+          TRACE_ERROR(TRACE_BAD_COMMAND, -1, type, size);
+        }
+        break;
+      }
+      case CMD_SPAWN_BATCH: {
+        if (size != 17) {
+          TRACE_ERROR(TRACE_BAD_COMMAND, -1, type, size);
+          break;
+        }
+        const float* f = reinterpret_cast<const float*>(payload + 3);
+        AgentSpawnParams params;
+        params.accel = f[4];
+        params.resistance = f[5];
+        params.intelligence = f[6];
+        params.maxFrustration = f[7];
+        params.arrivalDesiredSpeed = f[8];
+        params.arrivalThresholdSq = f[9];
+        params.lookSpeed = f[10];
+        params.frameId = static_cast<uint16_t>(payload[14]);
+        uint64_t seed = payload[2];
+        if (spawn_agent_batch(static_cast<int>(payload[0]), static_cast<int>(payload[1]), {f[0], f[1]}, {f[2], f[3]}, params, &seed) < 0) {
+          TRACE_ERROR(TRACE_BAD_COMMAND, -1, type, size);
+        }
+        break;
+      }
+      case CMD_WATCH_AGENTS: {
+        if (size < 4 || payload[1] > size - 4) {
+          TRACE_ERROR(TRACE_BAD_COMMAND, -1, type, size);
+          break;
+        }
+        const uint32_t count = payload[1];
+        for (uint32_t i = 0; i < count; ++i) {
+          watch_agent(static_cast<int>(payload[2 + i]), payload[0]);
+        }
+        break;
+      }
       default:
-        wasm_console_error("Unknown event type ", type);
+        TRACE_ERROR(TRACE_UNKNOWN_COMMAND, -1, type);
         break;
     }
 
-    p += size;
+    g_command_ring.pop();
   }
 }
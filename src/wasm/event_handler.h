@@ -1,14 +1,46 @@
 #pragma once
 #include <cstdint>
+#include "nav_constants.h"
 
-// Shared event type codes across JS<->WASM
-enum AgentEventType : uint16_t {
+// Shared event type codes across JS<->WASM (the type word of an EventRing
+// event, see event_buffer.h). Payload layouts below exclude the two header words.
+enum AgentEventType : uint32_t {
   EVT_NONE = 0,
   // JS -> WASM command: set agent corridor
   CMD_SET_CORRIDOR = 1,
-  // WASM -> JS event: selected agent's full corridor broadcast
-  EVT_SELECTED_CORRIDOR = 2,
+  // 2 was EVT_SELECTED_CORRIDOR, replaced by CMD_WATCH_AGENTS
+  // 3 and 4 were CMD_SET_TILE_VIEW and EVT_NAVMESH_TILES (tile residency, removed)
+  // JS -> WASM command: asynchronous A* (id, agent or -1, flags, f32 startX, startY, endX, endY)
+  CMD_FIND_PATH = 5,
+  // WASM -> JS event: CMD_FIND_PATH answered a frame later (id, agent, found, count, polys...)
+  EVT_PATH_RESULT = 6,
+  // JS -> WASM command: end targets for many agents (flags, count, then count x
+  // [agent, f32 x, f32 y, tri or -1 to look it up]); flags are SetTargetsFlags
+  CMD_SET_TARGETS = 7,
+  // JS -> WASM command: write one agent column over a range (column, first,
+  // count, broadcast, values...; see write_agent_column)
+  CMD_SET_PARAMS = 8,
+  // JS -> WASM command: spawn agents at random walkable points (first, count,
+  // seed, f32 minX, minY, maxX, maxY, f32 accel, resistance, intelligence,
+  // maxFrustration, arrivalDesiredSpeed, arrivalThresholdSq, lookSpeed, frame id)
+  CMD_SPAWN_BATCH = 9,
+  // JS -> WASM command: subscribe agents (fields, count, agents...); fields are
+  // AgentWatchFields and replace earlier ones, 0 unsubscribes (agent_watch.h)
+  CMD_WATCH_AGENTS = 10,
+  // WASM -> JS event: a watched corridor changed (agent, keep, polys...): trim
+  // the previous corridor to keep polygons, then append polys
+  EVT_CORRIDOR_DELTA = 11,
+  // WASM -> JS event: a watched state or corners changed (agent, state, corner
+  // count, f32 corner x, y, corner2 x, y)
+  EVT_AGENT_STATE = 12,
 };
 
-// Process inbound JS->WASM events from the shared event buffer.
-void process_events();
+enum SetTargetsFlags : uint32_t {
+  // Search each corridor on the path workers instead of on the agent's next
+  // update; the agents wait for it (no EVT_PATH_RESULT is sent).
+  TARGETS_FIND_PATH = 1,
+};
+
+// Process inbound JS->WASM events from g_command_ring. Path requests take
+// their search constants from nc, the same copy the following steps use.
+void process_events(const NavConstants& nc);
@@ -4,6 +4,11 @@
 #include "populate_polygon_index.h"
 #include "populate_building_index.h"
 #include "populate_blob_index.h"
+#include "navmesh_format.h"
+#include "path_workers.h"
+#include "agent_watch.h"
+#include "poly_congestion.h"
+#include "profiler.h"
 #include <iostream>
 #include "wasm_log.h"
 #include <cstring>
@@ -16,29 +21,21 @@
 // External reference to the global unified navmesh
 extern Navmesh g_navmesh;
 
-uint32_t init_navmesh_from_buffer(uint8_t* memoryStart, uint32_t binarySize, uint32_t totalMemorySize, float cellSize, bool enableLogging) {
-  if (memoryStart == nullptr) {
-    wasm_console_error("[WASM] Memory start is null. Cannot initialize navmesh.");
-    return 0;
-  }
-  
-  if (enableLogging) {
-    printf("[WASM] Initializing navmesh from buffer. Binary size: %d, Total memory: %d bytes\n", binarySize, totalMemorySize);
-  }
-  
-  // Parse the binary data first to understand its layout
-  uint8_t* navmeshBuffer = memoryStart;
+namespace {
+
+// v1: bbox, 13 header fields, then the raw arrays. Returns the bytes consumed.
+size_t parse_navmesh_v1(uint8_t* navmeshBuffer, Navmesh& navmesh) {
   size_t offset = 0;
 
   // Read BBOX (now includes both real and buffered bboxes - 8 floats total)
-  g_navmesh.bbox[0] = reinterpret_cast<float*>(navmeshBuffer + offset)[0]; // Real minX
-  g_navmesh.bbox[1] = reinterpret_cast<float*>(navmeshBuffer + offset)[1]; // Real minY
-  g_navmesh.bbox[2] = reinterpret_cast<float*>(navmeshBuffer + offset)[2]; // Real maxX
-  g_navmesh.bbox[3] = reinterpret_cast<float*>(navmeshBuffer + offset)[3]; // Real maxY
-  g_navmesh.buffered_bbox[0] = reinterpret_cast<float*>(navmeshBuffer + offset)[4]; // Buffered minX
-  g_navmesh.buffered_bbox[1] = reinterpret_cast<float*>(navmeshBuffer + offset)[5]; // Buffered minY
-  g_navmesh.buffered_bbox[2] = reinterpret_cast<float*>(navmeshBuffer + offset)[6]; // Buffered maxX
-  g_navmesh.buffered_bbox[3] = reinterpret_cast<float*>(navmeshBuffer + offset)[7]; // Buffered maxY
+  navmesh.bbox[0] = reinterpret_cast<float*>(navmeshBuffer + offset)[0]; // Real minX
+  navmesh.bbox[1] = reinterpret_cast<float*>(navmeshBuffer + offset)[1]; // Real minY
+  navmesh.bbox[2] = reinterpret_cast<float*>(navmeshBuffer + offset)[2]; // Real maxX
+  navmesh.bbox[3] = reinterpret_cast<float*>(navmeshBuffer + offset)[3]; // Real maxY
+  navmesh.buffered_bbox[0] = reinterpret_cast<float*>(navmeshBuffer + offset)[4]; // Buffered minX
+  navmesh.buffered_bbox[1] = reinterpret_cast<float*>(navmeshBuffer + offset)[5]; // Buffered minY
+  navmesh.buffered_bbox[2] = reinterpret_cast<float*>(navmeshBuffer + offset)[6]; // Buffered maxX
+  navmesh.buffered_bbox[3] = reinterpret_cast<float*>(navmeshBuffer + offset)[7]; // Buffered maxY
   offset += 8 * sizeof(float);
 
   // Read header with array lengths
@@ -56,75 +53,160 @@ uint32_t init_navmesh_from_buffer(uint8_t* memoryStart, uint32_t binarySize, uin
   const int buildings_len = header[8];
   const int building_verts_len = header[9];
   const int blob_buildings_len = header[10];
-  g_navmesh.walkable_triangle_count = header[11];
-  g_navmesh.walkable_polygon_count = header[12];
+  navmesh.walkable_triangle_count = header[11];
+  navmesh.walkable_polygon_count = header[12];
 
   // Store array counts in navmesh structure
-  g_navmesh.vertices_count = vertices_len;
-  g_navmesh.triangles_count = triangles_len;
-  g_navmesh.neighbors_count = neighbors_len;
-  g_navmesh.polygons_count = polygons_len;
-  g_navmesh.poly_centroids_count = poly_centroids_len;
-  g_navmesh.poly_verts_count = poly_verts_len;
-  g_navmesh.poly_tris_count = poly_tris_len;
-  g_navmesh.poly_neighbors_count = poly_neighbors_len;
-  g_navmesh.buildings_count = buildings_len;
-  g_navmesh.building_verts_count = building_verts_len;
-  g_navmesh.blob_buildings_count = blob_buildings_len;
+  navmesh.vertices_count = vertices_len;
+  navmesh.triangles_count = triangles_len;
+  navmesh.neighbors_count = neighbors_len;
+  navmesh.polygons_count = polygons_len;
+  navmesh.poly_centroids_count = poly_centroids_len;
+  navmesh.poly_verts_count = poly_verts_len;
+  navmesh.poly_tris_count = poly_tris_len;
+  navmesh.poly_neighbors_count = poly_neighbors_len;
+  navmesh.buildings_count = buildings_len;
+  navmesh.building_verts_count = building_verts_len;
+  navmesh.blob_buildings_count = blob_buildings_len;
 
   // Set up array pointers to navmesh buffer data
   
   // 1. Core navmesh arrays
-  g_navmesh.vertices = reinterpret_cast<Point2*>(navmeshBuffer + offset);
+  navmesh.vertices = reinterpret_cast<Point2*>(navmeshBuffer + offset);
   offset += vertices_len * sizeof(float);
 
-  g_navmesh.triangles = reinterpret_cast<int32_t*>(navmeshBuffer + offset);
+  navmesh.triangles = reinterpret_cast<int32_t*>(navmeshBuffer + offset);
   offset += triangles_len * sizeof(int32_t);
 
-  g_navmesh.neighbors = reinterpret_cast<int32_t*>(navmeshBuffer + offset);
+  navmesh.neighbors = reinterpret_cast<int32_t*>(navmeshBuffer + offset);
   offset += neighbors_len * sizeof(int32_t);
 
   // 2. Polygon arrays
-  g_navmesh.polygons = polygons_len > 0 ? reinterpret_cast<int32_t*>(navmeshBuffer + offset) : nullptr;
+  navmesh.polygons = polygons_len > 0 ? reinterpret_cast<int32_t*>(navmeshBuffer + offset) : nullptr;
   offset += polygons_len * sizeof(int32_t);
 
-  g_navmesh.poly_centroids = poly_centroids_len > 0 ? reinterpret_cast<Point2*>(navmeshBuffer + offset) : nullptr;
+  navmesh.poly_centroids = poly_centroids_len > 0 ? reinterpret_cast<Point2*>(navmeshBuffer + offset) : nullptr;
   offset += poly_centroids_len * sizeof(float);
 
-  g_navmesh.poly_verts = poly_verts_len > 0 ? reinterpret_cast<int32_t*>(navmeshBuffer + offset) : nullptr;
+  navmesh.poly_verts = poly_verts_len > 0 ? reinterpret_cast<int32_t*>(navmeshBuffer + offset) : nullptr;
   offset += poly_verts_len * sizeof(int32_t);
 
-  g_navmesh.poly_tris = poly_tris_len > 0 ? reinterpret_cast<int32_t*>(navmeshBuffer + offset) : nullptr;
+  navmesh.poly_tris = poly_tris_len > 0 ? reinterpret_cast<int32_t*>(navmeshBuffer + offset) : nullptr;
   offset += poly_tris_len * sizeof(int32_t);
 
-  g_navmesh.poly_neighbors = poly_neighbors_len > 0 ? reinterpret_cast<int32_t*>(navmeshBuffer + offset) : nullptr;
+  navmesh.poly_neighbors = poly_neighbors_len > 0 ? reinterpret_cast<int32_t*>(navmeshBuffer + offset) : nullptr;
   offset += poly_neighbors_len * sizeof(int32_t);
 
   // 3. Building arrays
-  g_navmesh.buildings = buildings_len > 0 ? reinterpret_cast<int32_t*>(navmeshBuffer + offset) : nullptr;
+  navmesh.buildings = buildings_len > 0 ? reinterpret_cast<int32_t*>(navmeshBuffer + offset) : nullptr;
   offset += buildings_len * sizeof(int32_t);
 
-  g_navmesh.building_verts = building_verts_len > 0 ? reinterpret_cast<int32_t*>(navmeshBuffer + offset) : nullptr;
+  navmesh.building_verts = building_verts_len > 0 ? reinterpret_cast<int32_t*>(navmeshBuffer + offset) : nullptr;
   offset += building_verts_len * sizeof(int32_t);
 
-  g_navmesh.blob_buildings = blob_buildings_len > 0 ? reinterpret_cast<int32_t*>(navmeshBuffer + offset) : nullptr;
+  navmesh.blob_buildings = blob_buildings_len > 0 ? reinterpret_cast<int32_t*>(navmeshBuffer + offset) : nullptr;
   offset += blob_buildings_len * sizeof(int32_t);
 
-  // Compute raw/binary section sizes for logging
-  const size_t bboxBytes = 8 * sizeof(float); // Now includes both real and buffered bboxes
-  const size_t headerBytes = 14 * sizeof(int32_t);
-  const size_t rawArraysBytes = (vertices_len * sizeof(float))
-    + (triangles_len * sizeof(int32_t))
-    + (neighbors_len * sizeof(int32_t))
-    + (polygons_len * sizeof(int32_t))
-    + (poly_centroids_len * sizeof(float))
-    + (poly_verts_len * sizeof(int32_t))
-    + (poly_tris_len * sizeof(int32_t))
-    + (poly_neighbors_len * sizeof(int32_t))
-    + (buildings_len * sizeof(int32_t))
-    + (building_verts_len * sizeof(int32_t))
-    + (blob_buildings_len * sizeof(int32_t));
-  const size_t rawNavmeshBytes = bboxBytes + headerBytes + rawArraysBytes; // should equal current offset
+  // Everything derived is computed by init_navmesh_from_buffer.
+  navmesh.triangle_centroids = nullptr;
+  navmesh.triangle_to_polygon = nullptr;
+  navmesh.building_to_blob = nullptr;
+  for (SpatialIndex* index : {&navmesh.triangle_index, &navmesh.polygon_index, &navmesh.building_index, &navmesh.blob_index}) {
+    index->cellOffsets = nullptr;
+    index->cellItems = nullptr;
+  }
+  return offset;
+}
+
+void set_index_grid(SpatialIndex& index, int gridWidth, int gridHeight, float cellSize,
+                    float minX, float minY, float maxX, float maxY) {
+  index.gridWidth = gridWidth;
+  index.gridHeight = gridHeight;
+  index.cellSize = cellSize;
+  index.minX = minX;
+  index.minY = minY;
+  index.maxX = maxX;
+  index.maxY = maxY;
+}
+
+} // namespace
+
+uint32_t navmesh_binary_bytes(const uint8_t* binary, uint32_t bytes) {
+  return read_navmesh_binary_info(binary, bytes).binary_bytes;
+}
+
+uint32_t navmesh_memory_bytes(const uint8_t* binary, uint32_t bytes, float cellSize) {
+  const NavmeshBinaryInfo info = read_navmesh_binary_info(binary, bytes);
+  if (info.version == 0) return 0;
+  const float* bbox = info.bbox;
+  const size_t binarySize = info.binary_bytes;
+
+  const int trianglesLen = info.triangles_len;
+  const int buildingsLen = info.buildings_len;
+  const int blobBuildingsLen = info.blob_buildings_len;
+  const int walkableTriangleCount = info.walkable_triangle_count;
+  const int walkablePolygonCount = info.walkable_polygon_count;
+
+  const float spatialIndexInflation = 50.0f;
+  const float width = (bbox[6] + spatialIndexInflation) - (bbox[4] - spatialIndexInflation);
+  const float height = (bbox[7] + spatialIndexInflation) - (bbox[5] - spatialIndexInflation);
+  const size_t totalCells = static_cast<size_t>(std::ceil(width / cellSize)) * static_cast<size_t>(std::ceil(height / cellSize));
+
+  size_t total = alignTo(binarySize, SIMD_ALIGNMENT);
+  if (!info.baked_aux) {
+    total += alignTo(walkableTriangleCount * 2 * 4, SIMD_ALIGNMENT); // triangle_centroids
+    total += alignTo((trianglesLen / 3) * 4, SIMD_ALIGNMENT);         // triangle_to_polygon
+    total += alignTo(buildingsLen * 4, SIMD_ALIGNMENT);               // building_to_blob
+  }
+  if (info.baked_indices && info.baked_cell_size == cellSize) return static_cast<uint32_t>(total);
+  total += alignTo((totalCells + 1) * 4, SIMD_ALIGNMENT);          // tri_cell_offsets
+  total += alignTo(walkableTriangleCount * 2 * 4, SIMD_ALIGNMENT); // tri_cell_triangles (2x average)
+  if (walkablePolygonCount > 0) {
+    total += alignTo((totalCells + 1) * 4, SIMD_ALIGNMENT);
+    total += alignTo(walkablePolygonCount * 3 * 4, SIMD_ALIGNMENT);
+  }
+  const int totalBuildings = buildingsLen > 0 ? buildingsLen - 1 : 0;
+  if (totalBuildings > 0) {
+    total += alignTo((totalCells + 1) * 4, SIMD_ALIGNMENT);
+    total += alignTo(totalBuildings * 2 * 4, SIMD_ALIGNMENT);
+  }
+  if (blobBuildingsLen > 0) {
+    total += alignTo((totalCells + 1) * 4, SIMD_ALIGNMENT);
+    total += alignTo(blobBuildingsLen * 2 * 4, SIMD_ALIGNMENT);
+  }
+  return static_cast<uint32_t>(total);
+}
+
+uint32_t init_navmesh_from_buffer(uint8_t* memoryStart, uint32_t binarySize, uint32_t totalMemorySize, float cellSize, bool enableLogging) {
+  PROFILE_SCOPE(PROFILE_NAVMESH_INIT);
+  if (memoryStart == nullptr) {
+    wasm_console_error("[WASM] Memory start is null. Cannot initialize navmesh.");
+    return 0;
+  }
+  // Path workers read the navmesh being replaced.
+  reset_path_requests();
+  reset_agent_watches();
+  
+  if (enableLogging) {
+    printf("[WASM] Initializing navmesh from buffer. Binary size: %d, Total memory: %d bytes\n", binarySize, totalMemorySize);
+  }
+  
+  // Parse the binary data first to understand its layout. v2 binaries are
+  // bound in place, including any derived sections baked into them.
+  size_t offset = 0;
+  const bool isV2 = is_navmesh_v2(memoryStart, binarySize);
+  if (isV2) {
+    if (!bind_navmesh_v2(memoryStart, binarySize, cellSize, g_navmesh)) {
+      wasm_console_error("[WASM] Invalid v2 navmesh binary.");
+      return 0;
+    }
+    offset = read_navmesh_binary_info(memoryStart, binarySize).binary_bytes;
+  } else {
+    offset = parse_navmesh_v1(memoryStart, g_navmesh);
+  }
+  g_navmesh.binary = memoryStart;
+  g_navmesh.binary_bytes = static_cast<uint32_t>(offset);
+  const size_t rawNavmeshBytes = offset;
 
   // Now we know exactly where the binary data ends (aligned start for auxiliary)
   size_t binaryDataEnd = alignTo(offset, SIMD_ALIGNMENT);
@@ -134,13 +216,16 @@ uint32_t init_navmesh_from_buffer(uint8_t* memoryStart, uint32_t binarySize, uin
   size_t auxiliaryMemorySize = totalMemorySize - binaryDataEnd;
 
   if (enableLogging) {
-    printf("[WASM MEM] Raw navmesh (bbox+header+arrays): %ld bytes\n", rawNavmeshBytes);
+    printf("[WASM MEM] Raw navmesh (v%d): %zu bytes\n", isV2 ? 2 : 1, rawNavmeshBytes);
     printf("[WASM] Binary data consumed: %zu bytes (aligned: %zu), Auxiliary memory: %zu bytes\n", offset, binaryDataEnd, auxiliaryMemorySize);
   }
 
   // 4. Now allocate and compute auxiliary structures in the remaining memory
   size_t auxOffset = 0;
-  const int32_t totalTriangles = triangles_len / 3;
+  const int32_t totalTriangles = g_navmesh.triangles_count / 3;
+  const int32_t polygons_len = g_navmesh.polygons_count;
+  const int32_t buildings_len = g_navmesh.buildings_count;
+  const int32_t blob_buildings_len = g_navmesh.blob_buildings_count;
 
   // Track allocated sizes for summary
   size_t aux_triangle_centroids_bytes = 0;
@@ -153,7 +238,9 @@ uint32_t init_navmesh_from_buffer(uint8_t* memoryStart, uint32_t binarySize, uin
   
   // Allocate triangle centroids
   g_navmesh.triangle_centroids_count = totalTriangles;
-  if (totalTriangles > 0) {
+  if (g_navmesh.triangle_centroids) {
+    if (enableLogging) { printf("[WASM] triangle_centroids baked into the binary\n"); }
+  } else if (totalTriangles > 0) {
     size_t centroidsSize = alignTo(totalTriangles * sizeof(Point2), SIMD_ALIGNMENT);
     if (auxOffset + centroidsSize <= auxiliaryMemorySize) {
       g_navmesh.triangle_centroids = reinterpret_cast<Point2*>(auxiliaryMemory + auxOffset);
@@ -187,7 +274,9 @@ uint32_t init_navmesh_from_buffer(uint8_t* memoryStart, uint32_t binarySize, uin
   
   // Allocate triangle_to_polygon mapping
   g_navmesh.triangle_to_polygon_count = totalTriangles;
-  if (totalTriangles > 0) {
+  if (g_navmesh.triangle_to_polygon) {
+    if (enableLogging) { printf("[WASM] triangle_to_polygon baked into the binary\n"); }
+  } else if (totalTriangles > 0) {
     size_t mappingSize = alignTo(totalTriangles * sizeof(int32_t), SIMD_ALIGNMENT);
     if (auxOffset + mappingSize <= auxiliaryMemorySize) {
       g_navmesh.triangle_to_polygon = reinterpret_cast<int32_t*>(auxiliaryMemory + auxOffset);
@@ -227,7 +316,9 @@ uint32_t init_navmesh_from_buffer(uint8_t* memoryStart, uint32_t binarySize, uin
   // Allocate building_to_blob mapping
   const int32_t totalBuildings = buildings_len > 0 ? buildings_len - 1 : 0;
   g_navmesh.building_to_blob_count = totalBuildings;
-  if (totalBuildings > 0) {
+  if (g_navmesh.building_to_blob) {
+    if (enableLogging) { printf("[WASM] building_to_blob baked into the binary\n"); }
+  } else if (totalBuildings > 0) {
     size_t mappingSize = alignTo(totalBuildings * sizeof(int32_t), SIMD_ALIGNMENT);
     if (auxOffset + mappingSize <= auxiliaryMemorySize) {
       g_navmesh.building_to_blob = reinterpret_cast<int32_t*>(auxiliaryMemory + auxOffset);
@@ -280,19 +371,30 @@ uint32_t init_navmesh_from_buffer(uint8_t* memoryStart, uint32_t binarySize, uin
   const int gridHeight = static_cast<int>(std::ceil(height / cellSize));
   const int totalCells = gridWidth * gridHeight;
   
-  g_navmesh.triangle_index.gridWidth = gridWidth;
-  g_navmesh.triangle_index.gridHeight = gridHeight;
-  g_navmesh.triangle_index.cellSize = cellSize;
-  g_navmesh.triangle_index.minX = spatialMinX;
-  g_navmesh.triangle_index.minY = spatialMinY;
-  g_navmesh.triangle_index.maxX = spatialMaxX;
-  g_navmesh.triangle_index.maxY = spatialMaxY;
+  SpatialIndex* const indices[] = {&g_navmesh.triangle_index, &g_navmesh.polygon_index, &g_navmesh.building_index, &g_navmesh.blob_index};
+  bool bakedIndices = true;
+  for (SpatialIndex* index : indices) {
+    set_index_grid(*index, gridWidth, gridHeight, cellSize, spatialMinX, spatialMinY, spatialMaxX, spatialMaxY);
+    bakedIndices = bakedIndices && index->cellOffsets && index->cellOffsetsCount == static_cast<uint32_t>(totalCells + 1);
+  }
+  if (!bakedIndices) {
+    for (SpatialIndex* index : indices) {
+      index->cellOffsets = nullptr;
+      index->cellItems = nullptr;
+      index->cellOffsetsCount = 0;
+      index->cellItemsCount = 0;
+    }
+  }
   
   // Allocate spatial index arrays from auxiliary memory
   size_t cellOffsetsSize = alignTo((totalCells + 1) * sizeof(uint32_t), SIMD_ALIGNMENT);
   
   // Triangle spatial index
-  if (auxOffset + cellOffsetsSize <= auxiliaryMemorySize) {
+  if (bakedIndices) {
+    if (enableLogging) {
+      printf("[WASM INIT] Spatial indices baked into the binary: cells=%d\n", totalCells);
+    }
+  } else if (auxOffset + cellOffsetsSize <= auxiliaryMemorySize) {
     g_navmesh.triangle_index.cellOffsetsCount = totalCells + 1;
     g_navmesh.triangle_index.cellOffsets = reinterpret_cast<uint32_t*>(auxiliaryMemory + auxOffset);
     auxOffset += cellOffsetsSize;
@@ -317,13 +419,9 @@ uint32_t init_navmesh_from_buffer(uint8_t* memoryStart, uint32_t binarySize, uin
     }
   }
   
-  // Copy grid parameters to other indices and allocate their cellOffsets
-  g_navmesh.polygon_index = g_navmesh.triangle_index;
-  g_navmesh.building_index = g_navmesh.triangle_index;
-  g_navmesh.blob_index = g_navmesh.triangle_index;
-  
   // Polygon spatial index
-  if (auxOffset + cellOffsetsSize <= auxiliaryMemorySize) {
+  if (!bakedIndices && auxOffset + cellOffsetsSize <= auxiliaryMemorySize) {
+    g_navmesh.polygon_index.cellOffsetsCount = totalCells + 1;
     g_navmesh.polygon_index.cellOffsets = reinterpret_cast<uint32_t*>(auxiliaryMemory + auxOffset);
     auxOffset += cellOffsetsSize;
     poly_index_offsets_bytes = cellOffsetsSize;
@@ -336,7 +434,8 @@ uint32_t init_navmesh_from_buffer(uint8_t* memoryStart, uint32_t binarySize, uin
   }
   
   // Building spatial index
-  if (auxOffset + cellOffsetsSize <= auxiliaryMemorySize) {
+  if (!bakedIndices && auxOffset + cellOffsetsSize <= auxiliaryMemorySize) {
+    g_navmesh.building_index.cellOffsetsCount = totalCells + 1;
     g_navmesh.building_index.cellOffsets = reinterpret_cast<uint32_t*>(auxiliaryMemory + auxOffset);
     auxOffset += cellOffsetsSize;
     bld_index_offsets_bytes = cellOffsetsSize;
@@ -349,7 +448,8 @@ uint32_t init_navmesh_from_buffer(uint8_t* memoryStart, uint32_t binarySize, uin
   }
   
   // Blob spatial index
-  if (auxOffset + cellOffsetsSize <= auxiliaryMemorySize) {
+  if (!bakedIndices && auxOffset + cellOffsetsSize <= auxiliaryMemorySize) {
+    g_navmesh.blob_index.cellOffsetsCount = totalCells + 1;
     g_navmesh.blob_index.cellOffsets = reinterpret_cast<uint32_t*>(auxiliaryMemory + auxOffset);
     auxOffset += cellOffsetsSize;
     blob_index_offsets_bytes = cellOffsetsSize;
@@ -362,6 +462,7 @@ uint32_t init_navmesh_from_buffer(uint8_t* memoryStart, uint32_t binarySize, uin
   }
 
   uint32_t totalUsed = static_cast<uint32_t>(binaryDataEnd + auxOffset);
+  reset_poly_congestion();
 
   if (enableLogging) {
     printf("[WASM] Navmesh initialization complete. Triangles: %d, Polygons: %d, Used auxiliary memory: %zu/%zu, Total used: %u/%u bytes\n",
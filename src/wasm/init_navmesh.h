@@ -3,6 +3,15 @@
 
 #include <cstdint>
 
+// Bytes of the binary itself (v1 or v2, see navmesh_format.h), 0 if it is
+// corrupt or longer than bytes.
+uint32_t navmesh_binary_bytes(const uint8_t* binary, uint32_t bytes);
+
+// Bytes init_navmesh_from_buffer needs for this binary (the binary itself plus
+// auxiliary arrays and spatial indices not baked into it). Mirrors
+// calculateNavmeshMemory in NavmeshInit.ts.
+uint32_t navmesh_memory_bytes(const uint8_t* binary, uint32_t bytes, float cellSize);
+
 uint32_t init_navmesh_from_buffer(uint8_t* memoryStart, uint32_t binarySize, uint32_t totalMemorySize, float cellSize, bool enableLogging);
 
 #endif // INIT_NAVMESH_H 
\ No newline at end of file
@@ -4,15 +4,24 @@
 #include <emscripten/emscripten.h>
 #include "data_structures.h"
 #include "agent_init.h"
+#include "agent_layout.h"
 #include "math_utils.h"
 #include "agent_grid.h"
 #include "constants_layout.h"
+#include "nav_constants.h"
 #include "init_navmesh.h"
 #include "navmesh.h"
+#include "nav_batch.h"
 #include <vector>
 #include "model.h"
 #include "event_buffer.h"
 #include "path_corridor.h"
+#include "render_snapshot.h"
+#include "sim_thread.h"
+#include "trace_log.h"
+#include "profiler.h"
+#include "nav_telemetry.h"
+#include "sim_snapshot.h"
 
 // Global state for our agent simulation
 AgentSoA agent_data;
@@ -25,6 +34,12 @@ uint8_t* g_constants_buffer = nullptr;
 
 bool g_init_logging_enabled = false;
 
+// Totals of the last update_simulation_steps call; TS reads them via get_sim_steps_stats_ptr.
+StepBatchStats g_step_batch_stats = {};
+
+// Last snapshot_simulation result; TS copies it out via get_sim_snapshot_ptr.
+std::vector<uint8_t> g_sim_snapshot;
+
 extern "C" {
 
 // Simple persistent allocators for JS to request linear memory blocks
@@ -44,6 +59,17 @@ EMSCRIPTEN_KEEPALIVE void set_rng_seed(uint32_t seed) {
 // Register constants buffer provided by JS/TS
 EMSCRIPTEN_KEEPALIVE void set_constants_buffer(uint8_t* buf, bool debug) {
   g_constants_buffer = buf;
+#ifdef NAV_CONSTANTS_BAKED
+  // Kernels use the compiled-in values; TS edits to NavConst would be ignored silently.
+  const RuntimeNavConstants fromTs = RuntimeNavConstants::from_buffer(buf);
+  const BakedNavConstants compiled;
+#define X(member, type, offset, baked) \
+  if (fromTs.member != compiled.member) { \
+    printf("[WASM] NavConst %s differs from baked value (%f vs %f)\n", #member, (double)fromTs.member, (double)compiled.member); \
+  }
+  NAV_ALL_CONSTANTS(X)
+#undef X
+#endif
   if (debug) {
     printf("--- C++ NavConst Values ---\n");
     printf("STUCK_PASSIVE_X1: %f\n", STUCK_PASSIVE_X1);
@@ -67,22 +93,20 @@ EMSCRIPTEN_KEEPALIVE void set_constants_buffer(uint8_t* buf, bool debug) {
     printf("CORNER_OFFSET_SQ: %f\n", CORNER_OFFSET_SQ);
     printf("PATH_FREE_WIDTH: %f\n", PATH_FREE_WIDTH);
     printf("PATH_WIDTH_PENALTY_MULT: %f\n", PATH_WIDTH_PENALTY_MULT);
+    printf("CONGESTION_COST_MULT: %f\n", CONGESTION_COST_MULT);
+    printf("CONGESTION_DECAY: %f\n", CONGESTION_DECAY);
+    printf("CONGESTION_UPDATE_FRAMES: %d\n", CONGESTION_UPDATE_FRAMES);
     printf("---------------------------\n");
   }
 }
 
-// Selected WASM agent index (controlled from TS); -1 means none
-int g_selected_wagent_idx = -1;
-
-EMSCRIPTEN_KEEPALIVE void set_selected_wagent_idx(int idx) {
-  g_selected_wagent_idx = idx;
-}
-
 /**
  * @brief Initialize the agent system with shared buffer.
  * @param sharedBuffer A pointer to the SharedArrayBuffer for agent SoA data.
  * @param maxAgents The maximum number of agents the sharedBuffer can hold.
  * @param seed Seed to initialize deterministic RNG.
+ * @param eventsBasePtr Two EventRings (event_buffer.h): TS->WASM commands, then WASM->TS events.
+ * @param eventsCapWords Data words of each ring, a power of two.
  */
 EMSCRIPTEN_KEEPALIVE void init_agents(uint8_t* sharedBuffer, int maxAgents, uint32_t seed, uint32_t eventsBasePtr, uint32_t eventsCapWords) {
   agent_data.capacity = maxAgents;
@@ -98,7 +122,9 @@ EMSCRIPTEN_KEEPALIVE void init_agents(uint8_t* sharedBuffer, int maxAgents, uint
   // Initialize AgentSoA from the shared buffer
   initialize_shared_buffer_layout(sharedBuffer, maxAgents);
 
-  g_event_buffer.set(reinterpret_cast<uint8_t*>(eventsBasePtr), eventsCapWords);
+  uint8_t* rings = reinterpret_cast<uint8_t*>(eventsBasePtr);
+  g_command_ring.set(rings, eventsCapWords);
+  g_event_ring.set(rings ? rings + EventRing::bytes(eventsCapWords) : nullptr, eventsCapWords);
   
   // Allocate dynamic data arrays
   agent_data.corridors = new std::vector<int>[maxAgents];
@@ -107,6 +133,7 @@ EMSCRIPTEN_KEEPALIVE void init_agents(uint8_t* sharedBuffer, int maxAgents, uint
   g_wall_contact.assign(maxAgents, 0);
 
   initialize_agent_grid(maxAgents);
+  g_render_snapshot.init(maxAgents);
 }
 
 /**
@@ -129,7 +156,150 @@ EMSCRIPTEN_KEEPALIVE void finalize_init() {
  * @param dt Delta time for this frame.
  */
 EMSCRIPTEN_KEEPALIVE void update_simulation(float dt, int active_agents) {
+  if (is_simulation_threaded()) {
+    wasm_console_error("[WASM] update_simulation called while the simulation thread is running");
+    return;
+  }
   g_model.update_simulation(dt, active_agents);
+  g_render_snapshot.publish(active_agents, g_model.sim_time);
+}
+
+/**
+ * @brief Run several simulation ticks in one call (warm-up, precomputation, faster than real time).
+ * Inbound events are processed once, before the first tick; outbound events are emitted after the
+ * last tick unless emitEveryStep is set. Aggregates are published at get_sim_steps_stats_ptr.
+ * @param dt Delta time of each tick.
+ * @param steps Number of ticks to run.
+ * @param active_agents Number of agent slots to simulate.
+ * @param emitEveryStep Emit outbound events after every tick instead of only the last.
+ * @return Number of ticks run.
+ */
+EMSCRIPTEN_KEEPALIVE int update_simulation_steps(float dt, int steps, int active_agents, bool emitEveryStep) {
+  if (is_simulation_threaded()) {
+    wasm_console_error("[WASM] update_simulation_steps called while the simulation thread is running");
+    return 0;
+  }
+  if (steps <= 0) return 0;
+  g_model.update_simulation_steps(dt, steps, active_agents, emitEveryStep, &g_step_batch_stats);
+  g_render_snapshot.publish(active_agents, g_model.sim_time);
+  return steps;
+}
+
+/**
+ * @brief Get pointer to the StepBatchStats of the last update_simulation_steps call (see model.h):
+ * u32 steps, alive_agents, repaths, astar_calls, then f32 sim_time, wall_ms, max_step_ms.
+ */
+EMSCRIPTEN_KEEPALIVE uint32_t get_sim_steps_stats_ptr() {
+  return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&g_step_batch_stats));
+}
+
+/**
+ * @brief Move the simulation onto a dedicated thread ticking at a fixed rate.
+ * After this, TS drives it with sim_thread_post_frame instead of update_simulation.
+ * @param tickDt Fixed simulation step in seconds.
+ * @param maxTicksPerWake Upper bound of catch-up ticks before budget is dropped.
+ * @return 1 if the thread runs, 0 if this build has no threads (make THREADS=1).
+ */
+EMSCRIPTEN_KEEPALIVE int sim_thread_start(float tickDt, int maxTicksPerWake) {
+  return start_simulation_thread(tickDt, maxTicksPerWake) ? 1 : 0;
+}
+
+EMSCRIPTEN_KEEPALIVE void sim_thread_stop() {
+  stop_simulation_thread();
+}
+
+/**
+ * @brief Hand a frame of simulated time to the sim thread.
+ * Call after publishing the frame's commands; needs no lock.
+ */
+EMSCRIPTEN_KEEPALIVE void sim_thread_post_frame(float dt, int active_agents) {
+  post_simulation_frame(dt, active_agents);
+}
+
+// Held by TS around whole-state operations such as snapshots.
+EMSCRIPTEN_KEEPALIVE void sim_thread_lock() {
+  g_sim_mutex.lock();
+}
+
+EMSCRIPTEN_KEEPALIVE void sim_thread_unlock() {
+  g_sim_mutex.unlock();
+}
+
+/**
+ * @brief Capture the simulation state into a versioned snapshot (see sim_snapshot.h).
+ * Call with the simulation thread stopped or between sim_thread_lock and sim_thread_unlock.
+ * @param activeAgents Number of agent slots to capture.
+ * @param basePtr Optional keyframe snapshot to delta-encode against (0 for a keyframe).
+ * @param baseBytes Size of the keyframe in bytes.
+ * @return Snapshot size in bytes (data at get_sim_snapshot_ptr), or 0 on failure.
+ */
+EMSCRIPTEN_KEEPALIVE uint32_t snapshot_simulation(int activeAgents, const uint8_t* basePtr, uint32_t baseBytes) {
+  if (!capture_simulation_snapshot(activeAgents, g_sim_snapshot, basePtr, baseBytes)) {
+    g_sim_snapshot.clear();
+    return 0;
+  }
+  return static_cast<uint32_t>(g_sim_snapshot.size());
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t get_sim_snapshot_ptr() {
+  return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(g_sim_snapshot.data()));
+}
+
+/**
+ * @brief Restore a snapshot taken by snapshot_simulation; bit-exact, so stepping afterwards
+ * reproduces the original run.
+ * @param dataPtr Snapshot bytes in WASM memory.
+ * @param bytes Snapshot size.
+ * @param basePtr The keyframe a delta snapshot was taken against (0 for keyframes).
+ * @param baseBytes Size of the keyframe in bytes.
+ * @return Active agent count of the snapshot, or -1 if it was rejected (state untouched).
+ */
+EMSCRIPTEN_KEEPALIVE int restore_simulation(const uint8_t* dataPtr, uint32_t bytes, const uint8_t* basePtr, uint32_t baseBytes) {
+  return restore_simulation_snapshot(dataPtr, bytes, basePtr, baseBytes);
+}
+
+/**
+ * @brief Get pointer to the binary trace ring (see trace_log.h for layout).
+ */
+EMSCRIPTEN_KEEPALIVE uint32_t get_trace_log_ptr() {
+  return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(trace_log_header()));
+}
+
+/**
+ * @brief Get pointer to the per-stage profiler stats page (see profiler.h for layout).
+ * Read it with the seqlock protocol: retry while word 0 is odd or changed during the copy.
+ */
+EMSCRIPTEN_KEEPALIVE uint32_t get_profiler_stats_ptr() {
+  return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(profiler_stats_page()));
+}
+
+/**
+ * @brief Get pointer to the pathfinding telemetry page (see nav_telemetry.h for layout).
+ */
+EMSCRIPTEN_KEEPALIVE uint32_t get_nav_telemetry_ptr() {
+  return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(nav_telemetry_page()));
+}
+
+/**
+ * @brief Bytes of shared agent columns for maxAgents (buffer start must be 16-byte aligned).
+ * TS calls this before allocating, init_agents then lays the columns out.
+ */
+EMSCRIPTEN_KEEPALIVE uint32_t get_agent_layout_bytes(int maxAgents) {
+  return static_cast<uint32_t>(agent_layout_bytes(maxAgents));
+}
+
+/**
+ * @brief Get pointer to the agent column descriptor filled by init_agents (see agent_layout.h).
+ */
+EMSCRIPTEN_KEEPALIVE uint32_t get_agent_layout_ptr() {
+  return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(agent_layout_descriptor()));
+}
+
+/**
+ * @brief Get pointer to the render snapshot descriptor (see render_snapshot.h for layout).
+ */
+EMSCRIPTEN_KEEPALIVE uint32_t get_render_snapshot_ptr() {
+  return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(g_render_snapshot.header));
 }
 
 /**
@@ -332,7 +502,7 @@ EMSCRIPTEN_KEEPALIVE int test_find_corridor(float startX, float startY, float en
   Point2 endPoint = {endX, endY};
   std::vector<int> corridor;
   
-  bool success = findCorridor(g_navmesh, pathFreeWidth, pathWidthPenaltyMult, startPoint, endPoint, corridor, -1, -1);
+  bool success = findCorridor(g_navmesh, pathFreeWidth, pathWidthPenaltyMult, 0.0f, startPoint, endPoint, corridor, -1, -1);
   
   if (!success || corridor.empty()) {
     return 0;
@@ -366,4 +536,50 @@ EMSCRIPTEN_KEEPALIVE int get_agent_corridor(uint32_t agent_idx, uint32_t* result
   return copyLength;
 }
 
+/**
+ * @brief Locate many points at once (see nav_batch.h for the packed layout).
+ * Safe while the simulation thread runs; not while a navmesh is loading.
+ * @param pointsPtr count x (f32 x, y).
+ * @param hintsPtr count x i32 last known triangle, or 0 for no hints.
+ * @param count Number of points.
+ * @param outPtr count x (i32 triangle, polygon); -1 outside the walkable mesh.
+ * @return Number of points located.
+ */
+EMSCRIPTEN_KEEPALIVE int nav_locate_batch(const float* pointsPtr, const int32_t* hintsPtr, int count, int32_t* outPtr) {
+  if (!pointsPtr || !outPtr || count <= 0) return 0;
+  return nav_batch_locate(pointsPtr, hintsPtr, count, outPtr);
+}
+
+/**
+ * @brief Raycast many segments at once (see nav_batch.h for the packed layout).
+ * Safe while the simulation thread runs; not while a navmesh is loading.
+ * @param segmentsPtr count x (f32 startX, startY, endX, endY).
+ * @param hintsPtr count x (i32 startTri, endTri), -1 for unknown, or 0 for no hints.
+ * @param count Number of rays.
+ * @param outPtr count x (i32 hitV1, hitV2, hitTri, corridorOffset, corridorLength), then corridors.
+ * @param outWords Capacity of outPtr in words.
+ * @return Number of rays answered; fewer than count if the corridors ran out of room.
+ */
+EMSCRIPTEN_KEEPALIVE int nav_raycast_batch(const float* segmentsPtr, const int32_t* hintsPtr, int count, int32_t* outPtr, int outWords) {
+  if (!segmentsPtr || !outPtr || count <= 0) return 0;
+  return nav_batch_raycast(segmentsPtr, hintsPtr, count, outPtr, outWords);
+}
+
+/**
+ * @brief Find polygon corridors for many start/end pairs at once (see nav_batch.h).
+ * Safe while the simulation thread runs; not while a navmesh is loading.
+ * @param segmentsPtr count x (f32 startX, startY, endX, endY).
+ * @param hintsPtr count x (i32 startPoly, endPoly), -1 for unknown, or 0 for no hints.
+ * @param count Number of paths.
+ * @param pathFreeWidth Free path width parameter.
+ * @param pathWidthPenaltyMult Width penalty multiplier.
+ * @param outPtr count x (i32 corridorOffset, corridorLength), then corridors; length 0 = no path.
+ * @param outWords Capacity of outPtr in words.
+ * @return Number of paths answered; fewer than count if the corridors ran out of room.
+ */
+EMSCRIPTEN_KEEPALIVE int nav_corridor_batch(const float* segmentsPtr, const int32_t* hintsPtr, int count, float pathFreeWidth, float pathWidthPenaltyMult, int32_t* outPtr, int outWords) {
+  if (!segmentsPtr || !outPtr || count <= 0) return 0;
+  return nav_batch_corridors(segmentsPtr, hintsPtr, count, pathFreeWidth, pathWidthPenaltyMult, outPtr, outWords);
+}
+
 }
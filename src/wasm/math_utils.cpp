@@ -41,6 +41,16 @@ void set_rng_seed(uint64_t seed) {
   g_pcg_inc = PCG_INCREMENT; // fixed stream, matches TS
 }
 
+void get_rng_state(uint64_t* state, uint64_t* inc) {
+  *state = g_pcg_state;
+  *inc = g_pcg_inc;
+}
+
+void set_rng_state(uint64_t state, uint64_t inc) {
+  g_pcg_state = state;
+  g_pcg_inc = inc;
+}
+
 static inline uint32_t rotr32(uint32_t x, uint32_t r) {
   return (x >> r) | (x << ((32 - r) & 31));
 }
@@ -171,16 +181,17 @@ Point2 lineLineIntersection(const Point2& lineP1, const Point2& lineDir1, const
   };
 }
 
-static bool triangleAABBIntersectionDetailed(const std::vector<Point2>& triPoints, const Point2& cellMin, const Point2& cellMax) {
+static bool triangleAABBIntersectionDetailed(const Point2 triPoints[3], const Point2& cellMin, const Point2& cellMax) {
   // Check 1: Any triangle vertex inside the rectangle
-  for (const Point2& p : triPoints) {
+  for (int i = 0; i < 3; i++) {
+    const Point2& p = triPoints[i];
     if (p.x >= cellMin.x && p.x <= cellMax.x && p.y >= cellMin.y && p.y <= cellMax.y) {
       return true;
     }
   }
 
   // Check 2: Any rectangle corner inside the triangle
-  std::vector<Point2> cellCorners = {
+  const Point2 cellCorners[4] = {
     cellMin,
     {cellMax.x, cellMin.y},
     cellMax,
@@ -194,22 +205,10 @@ static bool triangleAABBIntersectionDetailed(const std::vector<Point2>& triPoint
   }
 
   // Check 3: Triangle edges intersecting rectangle edges
-  std::vector<std::pair<Point2, Point2>> triEdges = {
-    {triPoints[0], triPoints[1]},
-    {triPoints[1], triPoints[2]},
-    {triPoints[2], triPoints[0]}
-  };
-  
-  std::vector<std::pair<Point2, Point2>> cellEdges = {
-    {cellCorners[0], cellCorners[1]}, // bottom edge
-    {cellCorners[1], cellCorners[2]}, // right edge
-    {cellCorners[2], cellCorners[3]}, // top edge
-    {cellCorners[3], cellCorners[0]}  // left edge
-  };
-
-  for (const auto& triEdge : triEdges) {
-    for (const auto& cellEdge : cellEdges) {
-      if (lineSegmentIntersectionTest(triEdge.first, triEdge.second, cellEdge.first, cellEdge.second)) {
+  // (cell edges: bottom, right, top, left)
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 4; j++) {
+      if (lineSegmentIntersectionTest(triPoints[i], triPoints[(i + 1) % 3], cellCorners[j], cellCorners[(j + 1) % 4])) {
         return true;
       }
     }
@@ -223,8 +222,8 @@ static bool triangleAABBIntersectionDetailed(const std::vector<Point2>& triPoint
     // Project triangle onto this axis
     float triMin = std::numeric_limits<float>::max();
     float triMax = std::numeric_limits<float>::lowest();
-    for (const Point2& p : triPoints) {
-      float proj = p.x * normal.x + p.y * normal.y;
+    for (int k = 0; k < 3; k++) {
+      float proj = triPoints[k].x * normal.x + triPoints[k].y * normal.y;
       triMin = std::min(triMin, proj);
       triMax = std::max(triMax, proj);
     }
@@ -247,9 +246,7 @@ static bool triangleAABBIntersectionDetailed(const std::vector<Point2>& triPoint
   return true;
 }
 
-bool triangleAABBIntersection(const std::vector<Point2>& triPoints, const Point2& cellMin, const Point2& cellMax) {
-  if (triPoints.size() != 3) return false;
-  
+bool triangleAABBIntersection(const Point2 triPoints[3], const Point2& cellMin, const Point2& cellMax) {
   // Calculate triangle bounding box
   float triMinX = triPoints[0].x, triMinY = triPoints[0].y;
   float triMaxX = triPoints[0].x, triMaxY = triPoints[0].y;
@@ -270,7 +267,7 @@ bool triangleAABBIntersection(const std::vector<Point2>& triPoints, const Point2
   return triangleAABBIntersectionDetailed(triPoints, cellMin, cellMax);
 }
 
-bool triangleAABBIntersectionWithBounds(const std::vector<Point2>& triPoints, const Point2& triMin, const Point2& triMax, const Point2& cellMin, const Point2& cellMax) {
+bool triangleAABBIntersectionWithBounds(const Point2 triPoints[3], const Point2& triMin, const Point2& triMax, const Point2& cellMin, const Point2& cellMax) {
   // Broad phase: Quick AABB vs AABB test using pre-calculated bounds
   if (!aabbIntersection(triMin, triMax, cellMin, cellMax)) {
     return false;
@@ -281,9 +278,8 @@ bool triangleAABBIntersectionWithBounds(const std::vector<Point2>& triPoints, co
 }
 
 // Check if point is inside polygon using winding number algorithm
-static bool isPointInPolygon(const Point2& point, const std::vector<Point2>& polygon) {
+static bool isPointInPolygon(const Point2& point, const Point2* polygon, int n) {
   int wn = 0; // winding number
-  int n = polygon.size();
   
   for (int i = 0; i < n; i++) {
     int j = (i + 1) % n;
@@ -305,16 +301,17 @@ static bool isPointInPolygon(const Point2& point, const std::vector<Point2>& pol
 }
 
 // Detailed polygon-AABB intersection test
-static bool polygonAABBIntersectionDetailed(const std::vector<Point2>& polyPoints, const Point2& cellMin, const Point2& cellMax) {
+static bool polygonAABBIntersectionDetailed(const Point2* polyPoints, int n, const Point2& cellMin, const Point2& cellMax) {
   // Check 1: Any polygon vertex inside the rectangle
-  for (const Point2& p : polyPoints) {
+  for (int i = 0; i < n; i++) {
+    const Point2& p = polyPoints[i];
     if (p.x >= cellMin.x && p.x <= cellMax.x && p.y >= cellMin.y && p.y <= cellMax.y) {
       return true;
     }
   }
 
   // Check 2: Any rectangle corner inside the polygon
-  std::vector<Point2> cellCorners = {
+  const Point2 cellCorners[4] = {
     cellMin,
     {cellMax.x, cellMin.y},
     cellMax,
@@ -322,28 +319,16 @@ static bool polygonAABBIntersectionDetailed(const std::vector<Point2>& polyPoint
   };
   
   for (const Point2& corner : cellCorners) {
-    if (isPointInPolygon(corner, polyPoints)) {
+    if (isPointInPolygon(corner, polyPoints, n)) {
       return true;
     }
   }
 
   // Check 3: Polygon edges intersecting rectangle edges
-  int n = polyPoints.size();
-  std::vector<std::pair<Point2, Point2>> polyEdges;
+  // (cell edges: bottom, right, top, left)
   for (int i = 0; i < n; i++) {
-    polyEdges.push_back({polyPoints[i], polyPoints[(i + 1) % n]});
-  }
-  
-  std::vector<std::pair<Point2, Point2>> cellEdges = {
-    {cellCorners[0], cellCorners[1]}, // bottom edge
-    {cellCorners[1], cellCorners[2]}, // right edge
-    {cellCorners[2], cellCorners[3]}, // top edge
-    {cellCorners[3], cellCorners[0]}  // left edge
-  };
-
-  for (const auto& polyEdge : polyEdges) {
-    for (const auto& cellEdge : cellEdges) {
-      if (lineSegmentIntersectionTest(polyEdge.first, polyEdge.second, cellEdge.first, cellEdge.second)) {
+    for (int j = 0; j < 4; j++) {
+      if (lineSegmentIntersectionTest(polyPoints[i], polyPoints[(i + 1) % n], cellCorners[j], cellCorners[(j + 1) % 4])) {
         return true;
       }
     }
@@ -358,8 +343,8 @@ static bool polygonAABBIntersectionDetailed(const std::vector<Point2>& polyPoint
     // Project polygon onto this axis
     float polyMin = std::numeric_limits<float>::max();
     float polyMax = std::numeric_limits<float>::lowest();
-    for (const Point2& p : polyPoints) {
-      float proj = p.x * normal.x + p.y * normal.y;
+    for (int k = 0; k < n; k++) {
+      float proj = polyPoints[k].x * normal.x + polyPoints[k].y * normal.y;
       polyMin = std::min(polyMin, proj);
       polyMax = std::max(polyMax, proj);
     }
@@ -382,14 +367,14 @@ static bool polygonAABBIntersectionDetailed(const std::vector<Point2>& polyPoint
   return true;
 }
 
-bool polygonAABBIntersection(const std::vector<Point2>& polyPoints, const Point2& cellMin, const Point2& cellMax) {
-  if (polyPoints.size() < 3) return false;
+bool polygonAABBIntersection(const Point2* polyPoints, int count, const Point2& cellMin, const Point2& cellMax) {
+  if (count < 3) return false;
   
   // Calculate polygon bounding box
   float polyMinX = polyPoints[0].x, polyMinY = polyPoints[0].y;
   float polyMaxX = polyPoints[0].x, polyMaxY = polyPoints[0].y;
   
-  for (size_t i = 1; i < polyPoints.size(); i++) {
+  for (int i = 1; i < count; i++) {
     const Point2& p = polyPoints[i];
     if (p.x < polyMinX) polyMinX = p.x;
     if (p.y < polyMinY) polyMinY = p.y;
@@ -402,17 +387,17 @@ bool polygonAABBIntersection(const std::vector<Point2>& polyPoints, const Point2
     return false;
   }
   
-  return polygonAABBIntersectionDetailed(polyPoints, cellMin, cellMax);
+  return polygonAABBIntersectionDetailed(polyPoints, count, cellMin, cellMax);
 }
 
-bool polygonAABBIntersectionWithBounds(const std::vector<Point2>& polyPoints, const Point2& polyMin, const Point2& polyMax, const Point2& cellMin, const Point2& cellMax) {
+bool polygonAABBIntersectionWithBounds(const Point2* polyPoints, int count, const Point2& polyMin, const Point2& polyMax, const Point2& cellMin, const Point2& cellMax) {
   // Broad phase: Quick AABB vs AABB test using pre-calculated bounds
   if (!aabbIntersection(polyMin, polyMax, cellMin, cellMax)) {
     return false;
   }
   
   // If bounding boxes overlap, we need detailed intersection tests
-  return polygonAABBIntersectionDetailed(polyPoints, cellMin, cellMax);
+  return polygonAABBIntersectionDetailed(polyPoints, count, cellMin, cellMax);
 }
 
 
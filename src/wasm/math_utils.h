@@ -20,6 +20,9 @@ namespace math {
 
   // Deterministic PCG32 RNG API
   void set_rng_seed(uint64_t seed);
+  // Raw PCG32 state, for simulation snapshots.
+  void get_rng_state(uint64_t* state, uint64_t* inc);
+  void set_rng_state(uint64_t state, uint64_t inc);
   uint32_t pcg32();
   float random_float01();
   int random_int(int min_inclusive, int max_inclusive);
@@ -194,12 +197,12 @@ namespace math {
   Point2 lineLineIntersection(const Point2& lineP1, const Point2& lineDir1, const Point2& lineP2, const Point2& lineDir2);
   
   // Triangle-AABB intersection functions
-  bool triangleAABBIntersection(const std::vector<Point2>& triPoints, const Point2& cellMin, const Point2& cellMax);
-  bool triangleAABBIntersectionWithBounds(const std::vector<Point2>& triPoints, const Point2& triMin, const Point2& triMax, const Point2& cellMin, const Point2& cellMax);
+  bool triangleAABBIntersection(const Point2 triPoints[3], const Point2& cellMin, const Point2& cellMax);
+  bool triangleAABBIntersectionWithBounds(const Point2 triPoints[3], const Point2& triMin, const Point2& triMax, const Point2& cellMin, const Point2& cellMax);
 
   // Polygon-AABB intersection functions
-  bool polygonAABBIntersection(const std::vector<Point2>& polyPoints, const Point2& cellMin, const Point2& cellMax);
-  bool polygonAABBIntersectionWithBounds(const std::vector<Point2>& polyPoints, const Point2& polyMin, const Point2& polyMax, const Point2& cellMin, const Point2& cellMax);
+  bool polygonAABBIntersection(const Point2* polyPoints, int count, const Point2& cellMin, const Point2& cellMax);
+  bool polygonAABBIntersectionWithBounds(const Point2* polyPoints, int count, const Point2& polyMin, const Point2& polyMax, const Point2& cellMin, const Point2& cellMax);
 
 } // namespace math
 
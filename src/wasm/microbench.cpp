@@ -0,0 +1,119 @@
+#include "microbench.h"
+#include "math_utils.h"
+#include "nav_utils.h"
+#include "navmesh.h"
+#include "sim_driver.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+extern Navmesh g_navmesh;
+
+namespace {
+
+// Function-local so registrations from other translation units' static
+// initializers never see it unconstructed.
+std::vector<MicrobenchCase>& registry() {
+  static std::vector<MicrobenchCase> cases;
+  return cases;
+}
+
+float next_random(uint64_t* seed) {
+  const auto r = math::seededRandom(*seed);
+  *seed = r.newSeed;
+  return r.value;
+}
+
+float percentile_of_sorted(const std::vector<double>& sorted, float q) {
+  return static_cast<float>(sorted[static_cast<size_t>(q * (sorted.size() - 1) + 0.5f)]);
+}
+
+} // namespace
+
+bool microbench_register(const MicrobenchCase& c) {
+  registry().push_back(c);
+  return true;
+}
+
+int microbench_run(const MicrobenchOptions& options) {
+  if (!g_navmesh.triangle_centroids || g_navmesh.walkable_triangle_count <= 0) {
+    printf("[WASM] microbench: navmesh is not loaded\n");
+    return 0;
+  }
+  const int repetitions = std::max(1, options.repetitions);
+
+  printf("\n%-28s %10s %12s %12s %12s\n", "microbench", "ops/rep", "median ns", "p95 ns", "min ns");
+  int ran = 0;
+  for (const MicrobenchCase& c : registry()) {
+    if (options.filter && !strstr(c.name, options.filter)) continue;
+    if (!c.setup(options.seed)) {
+      printf("%-28s skipped\n", c.name);
+      if (c.teardown) c.teardown();
+      continue;
+    }
+
+    uint32_t ops = 0;
+    for (int i = 0; i < options.warmup; ++i) ops = c.run();
+
+    std::vector<double> nsPerOp;
+    nsPerOp.reserve(repetitions);
+    for (int i = 0; i < repetitions; ++i) {
+      const auto t0 = std::chrono::steady_clock::now();
+      ops = c.run();
+      const auto t1 = std::chrono::steady_clock::now();
+      const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+      nsPerOp.push_back(ns / std::max<uint32_t>(ops, 1));
+    }
+    if (c.teardown) c.teardown();
+
+    std::sort(nsPerOp.begin(), nsPerOp.end());
+    printf("%-28s %10u %12.1f %12.1f %12.1f\n", c.name, ops, percentile_of_sorted(nsPerOp, 0.5f),
+           percentile_of_sorted(nsPerOp, 0.95f), nsPerOp.front());
+    ran++;
+  }
+  return ran;
+}
+
+void microbench_suite() {
+  microbench_run(MicrobenchOptions());
+}
+
+void sample_walkable_points(int count, uint64_t seed, std::vector<Point2>& points, std::vector<int>& tris) {
+  points.resize(count);
+  tris.resize(count);
+  const int walkable = g_navmesh.walkable_triangle_count;
+  for (int i = 0; i < count; ++i) {
+    const int tri = std::min(static_cast<int>(next_random(&seed) * walkable), walkable - 1);
+    tris[i] = tri;
+    points[i] = random_point_in_triangle(tri, &seed);
+  }
+}
+
+std::vector<Point2> sample_bbox_points(int count, uint64_t seed) {
+  const float* bbox = g_navmesh.bbox;
+  std::vector<Point2> points(count);
+  for (int i = 0; i < count; ++i) {
+    const float rx = next_random(&seed);
+    const float ry = next_random(&seed);
+    points[i] = {bbox[0] + rx * (bbox[2] - bbox[0]), bbox[1] + ry * (bbox[3] - bbox[1])};
+  }
+  return points;
+}
+
+std::vector<MicrobenchRay> sample_rays(int count, float maxLength, uint64_t seed) {
+  std::vector<Point2> starts;
+  std::vector<int> startTris;
+  sample_walkable_points(count, seed, starts, startTris);
+  seed += 7919; // separate stream for directions and lengths
+
+  std::vector<MicrobenchRay> rays(count);
+  for (int i = 0; i < count; ++i) {
+    const float angle = next_random(&seed) * 6.2831853f;
+    const float length = next_random(&seed) * maxLength;
+    const Point2 end = starts[i] + Point2(std::cos(angle), std::sin(angle)) * length;
+    rays[i] = {starts[i], end, startTris[i], getTriangleFromPoint(end)};
+  }
+  return rays;
+}
@@ -0,0 +1,64 @@
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+#include <cstdint>
+#include <vector>
+#include "data_structures.h"
+
+// Small microbenchmark framework for navmesh kernels. A case registers a setup
+// that builds fixed-seed inputs once, a run that performs one repetition over
+// them, and an optional teardown. The runner does warmup repetitions, then
+// times each repetition and reports median/p95/min nanoseconds per operation.
+//
+//   static bool setup_foo(uint64_t seed) { ...fill inputs...; return true; }
+//   static uint32_t run_foo() { for (...) do_not_optimize(foo(x)); return count; }
+//   MICROBENCH(foo, setup_foo, run_foo, nullptr);
+
+struct MicrobenchCase {
+  const char* name;
+  bool (*setup)(uint64_t seed);  // false skips the case (e.g. nothing to sample)
+  uint32_t (*run)();             // one repetition, returns the operations it did
+  void (*teardown)();            // may be nullptr
+};
+
+struct MicrobenchOptions {
+  const char* filter = nullptr;  // substring of case names, nullptr runs all
+  int warmup = 3;
+  int repetitions = 30;
+  uint64_t seed = 4242;
+};
+
+bool microbench_register(const MicrobenchCase& c);
+// Returns the number of cases that ran.
+int microbench_run(const MicrobenchOptions& options);
+// Every registered case with default options (WasmImpulse::MICROBENCH_SUITE).
+void microbench_suite();
+
+#define MICROBENCH(name, setup, run, teardown) \
+  static const bool microbench_registered_##name = microbench_register({#name, setup, run, teardown})
+
+// Keeps value (and everything it depends on) from being optimized away.
+template<typename T>
+inline void do_not_optimize(const T& value) {
+  asm volatile("" : : "r"(&value) : "memory");
+}
+
+// Fixed-seed inputs sampled from the loaded navmesh.
+
+// Uniform points inside walkable triangles (triangle chosen uniformly), with their triangles.
+void sample_walkable_points(int count, uint64_t seed, std::vector<Point2>& points, std::vector<int>& tris);
+
+// Uniform points over the navmesh bbox, walkable or not.
+std::vector<Point2> sample_bbox_points(int count, uint64_t seed);
+
+struct MicrobenchRay {
+  Point2 start;
+  Point2 end;
+  int startTri;
+  int endTri;  // -1 when the end lies off the walkable area
+};
+
+// Rays from walkable points in random directions, up to maxLength long.
+std::vector<MicrobenchRay> sample_rays(int count, float maxLength, uint64_t seed);
+
+#endif // MICROBENCH_H
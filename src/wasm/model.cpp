@@ -6,44 +6,116 @@
 #include "agent_grid.h"
 #include "agent_collision.h"
 #include <cstdint>
+#include <algorithm>
 #include "event_handler.h"
 #include "event_buffer.h"
 #include "navmesh.h"
+#include "agent_watch.h"
+#include "nav_constants.h"
+#include "trace_log.h"
+#include "profiler.h"
+#include "nav_telemetry.h"
 #include "event_handler.h"
+#include "path_workers.h"
+#include "poly_congestion.h"
 
 extern AgentSoA agent_data;
 extern Navmesh g_navmesh;
-extern EventBuffer g_event_buffer;
-extern int g_selected_wagent_idx; // declared in main.cpp
 
 void Model::update_simulation(float dt, int active_agents) {
-  process_events();
-  g_event_buffer.begin_frame();
+  const NavConstants nc = load_nav_constants();
+  process_events(nc);
+  step(dt, active_agents, nc);
+  emit_events(active_agents);
+}
 
+void Model::update_simulation_steps(float dt, int steps, int active_agents, bool emit_every_step, StepBatchStats* stats) {
+  const auto batchStart = ProfileClock::now();
+  const NavCounters& totals = nav_telemetry_totals();
+  uint32_t repathsBefore = 0;
+  for (int r = 0; r < static_cast<int>(REPATH_REASON_COUNT); ++r) repathsBefore += totals.repaths[r];
+  const uint32_t astarBefore = totals.astar_calls;
+  float maxStepMs = 0.0f;
+
+  const NavConstants nc = load_nav_constants();
+  process_events(nc);
+  for (int s = 0; s < steps; ++s) {
+    const auto stepStart = ProfileClock::now();
+    step(dt, active_agents, nc);
+    if (emit_every_step || s == steps - 1) emit_events(active_agents);
+    maxStepMs = std::max(maxStepMs, std::chrono::duration<float, std::milli>(ProfileClock::now() - stepStart).count());
+  }
+
+  if (!stats) return;
+  uint32_t repathsAfter = 0;
+  for (int r = 0; r < static_cast<int>(REPATH_REASON_COUNT); ++r) repathsAfter += totals.repaths[r];
+  uint32_t alive = 0;
+  for (int i = 0; i < active_agents; ++i) alive += agent_data.is_alive[i] ? 1 : 0;
+  stats->steps = static_cast<uint32_t>(steps > 0 ? steps : 0);
+  stats->alive_agents = alive;
+  stats->repaths = repathsAfter - repathsBefore;
+  stats->astar_calls = totals.astar_calls - astarBefore;
+  stats->sim_time = sim_time;
+  stats->wall_ms = std::chrono::duration<float, std::milli>(ProfileClock::now() - batchStart).count();
+  stats->max_step_ms = maxStepMs;
+}
+
+void Model::step(float dt, int active_agents) {
+  step(dt, active_agents, load_nav_constants());
+}
+
+void Model::step(float dt, int active_agents, const NavConstants& nc) {
+  PROFILE_SCOPE(PROFILE_STEP);
   sim_time += dt;
+  trace_set_time(sim_time);
+  deliver_path_results(active_agents, nc);
 
-  for (int i = 0; i < active_agents; ++i) {
-    if (agent_data.is_alive[i]) {
-      update_agent_navigation(i, dt, &rng_seed);
-      update_agent_phys(i, dt);
-      update_agent_statistic(i, dt);
+  // Agents only touch their own SoA slots here, so running the stages as
+  // separate passes gives the same result as the per-agent interleaving.
+  {
+    PROFILE_SCOPE(PROFILE_NAVIGATION);
+    for (int i = 0; i < active_agents; ++i) {
+      if (agent_data.is_alive[i]) {
+        update_agent_navigation(i, dt, &rng_seed, nc);
+      }
     }
   }
-  clear_and_reindex_grid(active_agents);
-  update_agent_collisions(active_agents);
-
-  // Emit selected agent's corridor event at end of simulation
-  if (g_selected_wagent_idx >= 0 && g_selected_wagent_idx < active_agents) {
-    const auto &corr = agent_data.corridors[g_selected_wagent_idx];
-    const uint16_t type = EVT_SELECTED_CORRIDOR;
-    const uint16_t size_words = static_cast<uint16_t>(2 + corr.size());
-    const uint32_t start = g_event_buffer.cursor;
-    g_event_buffer.write_header(type, size_words);
-    g_event_buffer.u32_base[start + 1] = static_cast<uint32_t>(g_selected_wagent_idx);
-    for (size_t i = 0; i < corr.size(); ++i) {
-      g_event_buffer.u32_base[start + 2 + i] = static_cast<uint32_t>(corr[i]);
+  {
+    PROFILE_SCOPE(PROFILE_PHYSICS);
+    integrate_agent_velocities(0, active_agents, dt, nc);
+    for (int i = 0; i < active_agents; ++i) {
+      if (agent_data.is_alive[i]) {
+        update_agent_move(i, dt, nc);
+      }
     }
   }
+  {
+    PROFILE_SCOPE(PROFILE_STATISTICS);
+    for (int i = 0; i < active_agents; ++i) {
+      if (agent_data.is_alive[i]) {
+        update_agent_statistic(i, dt, nc);
+      }
+    }
+  }
+  {
+    PROFILE_SCOPE(PROFILE_GRID_REINDEX);
+    clear_and_reindex_grid(active_agents);
+  }
+  {
+    PROFILE_SCOPE(PROFILE_CONGESTION);
+    update_poly_congestion(active_agents, dt, nc);
+  }
+  {
+    PROFILE_SCOPE(PROFILE_COLLISIONS);
+    update_agent_collisions(active_agents);
+  }
+  nav_telemetry_end_frame();
+}
+
+void Model::emit_events(int active_agents) {
+  PROFILE_SCOPE(PROFILE_EMIT_EVENTS);
+  emit_agent_watch_events(active_agents);
+  emit_path_result_events();
+  g_event_ring.publish();
+}
 
-  g_event_buffer.commit_frame();
-} 
@@ -2,13 +2,36 @@
 #define MODEL_H
 
 #include <cstdint>
+#include "nav_constants.h"
+
+// Totals of one update_simulation_steps batch.
+struct StepBatchStats {
+  uint32_t steps;
+  uint32_t alive_agents;  // after the last step
+  uint32_t repaths;       // findPathToDestination calls, all reasons
+  uint32_t astar_calls;
+  float sim_time;         // after the last step
+  float wall_ms;          // whole batch
+  float max_step_ms;
+};
 
 class Model {
 public:
   uint64_t rng_seed = 12345;
   float sim_time = 0.0f;
 
+  // One full tick: consume inbound events, advance the simulation and emit outbound events.
   void update_simulation(float dt, int active_agents);
+  // Advance the simulation by one tick without touching the event buffer.
+  void step(float dt, int active_agents);
+  // Same, with constants the caller took (or overrode) instead of this tick's buffer.
+  void step(float dt, int active_agents, const NavConstants& nc);
+  // Fast-forward: consume inbound events once, then run `steps` ticks. Outbound
+  // events are emitted after the last tick only, or after every tick with
+  // emit_every_step (all into the same event frame).
+  void update_simulation_steps(float dt, int steps, int active_agents, bool emit_every_step, StepBatchStats* stats);
+  // Write per-frame outbound events (selected corridor, etc.) into g_event_ring and publish them.
+  void emit_events(int active_agents);
 };
 
-#endif // MODEL_H 
\ No newline at end of file
+#endif // MODEL_H 
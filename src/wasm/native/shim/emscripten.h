@@ -0,0 +1,16 @@
+#ifndef NATIVE_SHIM_EMSCRIPTEN_H
+#define NATIVE_SHIM_EMSCRIPTEN_H
+
+// Host stand-in for <emscripten.h> so the simulation core builds natively.
+// Only what the core uses is provided; JS interop compiles to nothing.
+
+#include <chrono>
+
+#define EMSCRIPTEN_KEEPALIVE
+#define EM_ASM(...) ((void)0)
+
+inline double emscripten_get_now() {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // NATIVE_SHIM_EMSCRIPTEN_H
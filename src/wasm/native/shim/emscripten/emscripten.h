@@ -0,0 +1 @@
+#include "../emscripten.h"
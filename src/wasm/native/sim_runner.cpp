@@ -0,0 +1,563 @@
+// Headless native simulation runner. Drives the same core sources as the wasm
+// build, in the order WasmModule.ts initializes them, without a browser:
+// constants -> navmesh -> agents -> spawn -> per-frame random journeys + step.
+//
+//   sim_runner [--navmesh file.bin] [--write-navmesh out.bin] [--bake-navmesh out.bin]
+//              [--agents N] [--frames M] [--dt S] [--seed S] [--trace out.json] [--warmup-steps K]
+//   sim_runner --scenarios all|name,... [--baseline file] [--save-baseline file]
+//              [--threshold 1.25]
+//   sim_runner --microbench all|filter [--microbench-reps N]
+//   sim_runner [--load-snapshot in.snap] [--save-snapshot out.snap] [--check-snapshot 1]
+//   sim_runner [--check-phys-simd 1]
+//
+// Without --navmesh a synthetic grid navmesh (synthetic_navmesh.h) is used.
+// Scenario mode runs the scenario_bench.h suite instead of the random-journey
+// loop; with --baseline it exits with 2 if any scenario regressed past
+// threshold x baseline. Microbench mode runs the microbench.h cases whose
+// name contains filter. --load-snapshot starts from a sim_snapshot.h state
+// instead of fresh spawns; --check-snapshot replays the second half of the run
+// from a mid-run snapshot and fails unless it ends bit-identical.
+// --check-phys-simd replays the agents as they stand after the run with the
+// scalar and the SIMD velocity pass and fails if their trajectories drift
+// apart by more than PHYS_SIMD_TOLERANCE; with a fixed --seed the trajectory
+// is the same on every run.
+// --warmup-steps fast-forwards K ticks through update_simulation_steps before
+// the timed frames (no journey updates in between, like a WASM-side warm-up).
+// --bake-navmesh writes the loaded navmesh as a navmesh_format.h v2 binary
+// with its derived sections, which loads without rebuilding anything.
+
+#include "synthetic_navmesh.h"
+#include "../benchmarks.h"
+#include "../event_buffer.h"
+#include "../init_navmesh.h"
+#include "../microbench.h"
+#include "../model.h"
+#include "../navmesh.h"
+#include "../navmesh_format.h"
+#include "../nav_constants.h"
+#include "../nav_telemetry.h"
+#include "../profiler.h"
+#include "../scenario_bench.h"
+#include "../sim_snapshot.h"
+#include "../sim_driver.h"
+#include "../math_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+extern "C" {
+void set_constants_buffer(uint8_t* buf, bool debug);
+void init_agents(uint8_t* sharedBuffer, int maxAgents, uint32_t seed, uint32_t eventsBasePtr, uint32_t eventsCapWords);
+void update_simulation(float dt, int active_agents);
+int update_simulation_steps(float dt, int steps, int active_agents, bool emitEveryStep);
+uint32_t get_agent_layout_bytes(int maxAgents);
+}
+
+extern Navmesh g_navmesh;
+extern StepBatchStats g_step_batch_stats;
+
+namespace {
+
+// Same values WasmModule.ts passes.
+const float SPATIAL_INDEX_CELL_SIZE = 64.0f;
+const uint32_t EVENT_BUFFER_WORDS = 65536;  // per ring
+
+struct RunnerOptions {
+  std::string navmeshPath;
+  std::string writeNavmeshPath;
+  std::string bakeNavmeshPath;
+  std::string tracePath;
+  std::string scenarios;
+  std::string baselinePath;
+  std::string saveBaselinePath;
+  std::string microbench;
+  std::string loadSnapshotPath;
+  std::string saveSnapshotPath;
+  bool checkSnapshot = false;
+  bool checkPhysSimd = false;
+  int microbenchReps = 30;
+  int warmupSteps = 0;
+  float threshold = 1.25f;
+  int agents = 1000;
+  int frames = 600;
+  float dt = 1.0f / 60.0f;
+  uint32_t seed = 12345;
+};
+
+void print_usage() {
+  std::printf("usage: sim_runner [--navmesh file.bin] [--write-navmesh out.bin] [--bake-navmesh out.bin]\n"
+              "                  [--agents N] [--frames M] [--dt S] [--seed S] [--trace out.json] [--warmup-steps K]\n"
+              "       sim_runner --scenarios all|name,... [--baseline file] [--save-baseline file]\n"
+              "                  [--threshold 1.25]\n"
+              "       sim_runner --microbench all|filter [--microbench-reps N]\n"
+              "       sim_runner [--load-snapshot in.snap] [--save-snapshot out.snap] [--check-snapshot 1]\n"
+              "       sim_runner [--check-phys-simd 1]\n"
+              "scenarios:");
+  for (int i = 0; i < SCENARIO_COUNT; ++i) std::printf(" %s", scenario_name(static_cast<ScenarioId>(i)));
+  std::printf("\n");
+}
+
+bool parse_options(int argc, char** argv, RunnerOptions& opt) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") return false;
+    if (i + 1 >= argc) {
+      std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+      return false;
+    }
+    const char* value = argv[++i];
+    if (arg == "--navmesh") opt.navmeshPath = value;
+    else if (arg == "--write-navmesh") opt.writeNavmeshPath = value;
+    else if (arg == "--bake-navmesh") opt.bakeNavmeshPath = value;
+    else if (arg == "--trace") opt.tracePath = value;
+    else if (arg == "--agents") opt.agents = std::atoi(value);
+    else if (arg == "--frames") opt.frames = std::atoi(value);
+    else if (arg == "--dt") opt.dt = static_cast<float>(std::atof(value));
+    else if (arg == "--seed") opt.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+    else if (arg == "--scenarios") opt.scenarios = value;
+    else if (arg == "--baseline") opt.baselinePath = value;
+    else if (arg == "--save-baseline") opt.saveBaselinePath = value;
+    else if (arg == "--threshold") opt.threshold = static_cast<float>(std::atof(value));
+    else if (arg == "--microbench") opt.microbench = value;
+    else if (arg == "--microbench-reps") opt.microbenchReps = std::atoi(value);
+    else if (arg == "--warmup-steps") opt.warmupSteps = std::atoi(value);
+    else if (arg == "--load-snapshot") opt.loadSnapshotPath = value;
+    else if (arg == "--save-snapshot") opt.saveSnapshotPath = value;
+    else if (arg == "--check-snapshot") opt.checkSnapshot = std::atoi(value) != 0;
+    else if (arg == "--check-phys-simd") opt.checkPhysSimd = std::atoi(value) != 0;
+    else {
+      std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+      return false;
+    }
+  }
+  return opt.agents > 0 && opt.frames > 0 && opt.dt > 0.0f && opt.threshold >= 1.0f && opt.microbenchReps > 0 && opt.warmupSteps >= 0;
+}
+
+bool read_file(const std::string& path, std::vector<uint8_t>& out) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return false;
+  out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  return !out.empty();
+}
+
+bool write_file(const std::string& path, const std::vector<uint8_t>& bytes) {
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+  return static_cast<bool>(out);
+}
+
+// 16-byte aligned, zeroed block; the wasm side gets these from wasm_alloc.
+// Plays the TS side of the event ring so outbound events never back up.
+void discard_events() {
+  while (g_event_ring.front()) g_event_ring.pop();
+}
+
+uint8_t* alloc_aligned(size_t bytes) {
+  const size_t rounded = alignTo(bytes, SIMD_ALIGNMENT);
+  uint8_t* p = static_cast<uint8_t*>(std::aligned_alloc(SIMD_ALIGNMENT, rounded));
+  if (p) std::memset(p, 0, rounded);
+  return p;
+}
+
+// Copies a navmesh binary into freshly allocated navmesh memory and makes it
+// current. Returns the memory (owned by the caller) or nullptr.
+uint8_t* load_navmesh(const std::vector<uint8_t>& bin, uint32_t* memoryBytes) {
+  *memoryBytes = navmesh_memory_bytes(bin.data(), static_cast<uint32_t>(bin.size()), SPATIAL_INDEX_CELL_SIZE);
+  if (*memoryBytes == 0) return nullptr;
+  uint8_t* memory = alloc_aligned(*memoryBytes);
+  std::memcpy(memory, bin.data(), bin.size());
+  if (init_navmesh_from_buffer(memory, static_cast<uint32_t>(bin.size()), *memoryBytes,
+                               SPATIAL_INDEX_CELL_SIZE, false) == 0) {
+    std::free(memory);
+    return nullptr;
+  }
+  return memory;
+}
+
+float percentile(std::vector<float> sorted, float q) {
+  if (sorted.empty()) return 0.0f;
+  std::sort(sorted.begin(), sorted.end());
+  const size_t idx = std::min(sorted.size() - 1, static_cast<size_t>(q * (sorted.size() - 1) + 0.5f));
+  return sorted[idx];
+}
+
+void print_profiler_page() {
+  static const char* const names[] = {
+#define X(id, name) name,
+    PROFILE_STAGES(X)
+#undef X
+  };
+  const uint32_t* page = profiler_stats_page();
+  const uint32_t stageCount = page[1];
+  const uint32_t stageWords = page[2];
+  std::printf("\n%-24s %8s %10s %10s %10s %10s\n", "stage", "samples", "min us", "mean us", "p99 us", "max us");
+  for (uint32_t s = 0; s < stageCount; ++s) {
+    const uint32_t* st = page + PROFILE_HEADER_WORDS + s * stageWords;
+    if (st[1] == 0) continue;
+    float v[5];
+    std::memcpy(v, st + 2, sizeof(v)); // last, min, mean, p99, max
+    std::printf("%-24s %8u %10.1f %10.1f %10.1f %10.1f\n", names[s], st[1], v[1], v[2], v[3], v[4]);
+  }
+}
+
+void print_nav_telemetry() {
+  static const char* const names[] = {
+#define X(member) #member,
+    NAV_COUNTERS(X)
+#undef X
+  };
+  static const char* const reasons[] = {"from start", "from stuck", "after path recovery", "after escaping"};
+  const uint32_t* page = nav_telemetry_page();
+  const uint32_t* total = page + NAV_TELEMETRY_HEADER_WORDS + NAV_COUNTER_WORDS;
+  const uint32_t* peak = total + NAV_COUNTER_WORDS;
+  std::printf("\nnav telemetry over %u frames\n%-24s %12s %12s\n", page[1], "counter", "total", "peak frame");
+  const size_t counterCount = sizeof(names) / sizeof(names[0]);
+  for (size_t i = 0; i < counterCount; ++i) {
+    std::printf("%-24s %12u %12u\n", names[i], total[i], peak[i]);
+  }
+  for (int r = 0; r < static_cast<int>(REPATH_REASON_COUNT); ++r) {
+    std::printf("repath %-17s %12u %12u  failures %u\n", reasons[r], total[counterCount + r],
+                peak[counterCount + r], total[counterCount + REPATH_REASON_COUNT + r]);
+  }
+}
+
+// One line per scenario: name p99_ms repaths_per_s mem_kb
+struct ScenarioBaseline {
+  bool present = false;
+  float p99_ms = 0.0f;
+  float repaths_per_sec = 0.0f;
+  float mem_kb = 0.0f;
+};
+
+bool read_baselines(const std::string& path, ScenarioBaseline* out) {
+  std::ifstream in(path);
+  if (!in) return false;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream fields(line);
+    std::string name;
+    ScenarioBaseline b;
+    if (!(fields >> name >> b.p99_ms >> b.repaths_per_sec >> b.mem_kb)) {
+      std::fprintf(stderr, "bad baseline line: %s\n", line.c_str());
+      return false;
+    }
+    const int id = scenario_from_name(name.c_str());
+    if (id == -1) {
+      std::fprintf(stderr, "unknown scenario in baseline: %s\n", name.c_str());
+      continue;
+    }
+    b.present = true;
+    out[id] = b;
+  }
+  return true;
+}
+
+bool write_baselines(const std::string& path, const ScenarioResult* results, const bool* ran) {
+  std::ofstream out(path);
+  out << "# sim_runner scenario baselines: name p99_ms repaths_per_s mem_kb\n";
+  for (int i = 0; i < SCENARIO_COUNT; ++i) {
+    if (!ran[i]) continue;
+    char line[160];
+    std::snprintf(line, sizeof(line), "%s %.3f %.1f %llu\n", scenario_name(static_cast<ScenarioId>(i)),
+                  results[i].p99_ms, results[i].repaths_per_sec,
+                  static_cast<unsigned long long>(results[i].memory_high_water / 1024));
+    out << line;
+  }
+  return static_cast<bool>(out);
+}
+
+// A metric regresses when it exceeds threshold x baseline and also moves by more
+// than an absolute slack, so near-zero baselines do not fail on noise.
+bool regressed(const char* scenario, const char* metric, float value, float baseline, float threshold, float slack) {
+  if (value <= baseline * threshold || value - baseline <= slack) return false;
+  std::printf("FAIL %s: %s %.3f > %.2f x baseline %.3f\n", scenario, metric, value, threshold, baseline);
+  return true;
+}
+
+// Returns 0 when every selected scenario ran and stayed within its baseline,
+// 2 on a regression, 1 on errors.
+int run_scenarios(const RunnerOptions& opt) {
+  bool selected[SCENARIO_COUNT] = {};
+  std::istringstream names(opt.scenarios);
+  std::string name;
+  while (std::getline(names, name, ',')) {
+    if (name == "all") {
+      std::fill(selected, selected + SCENARIO_COUNT, true);
+      continue;
+    }
+    const int id = scenario_from_name(name.c_str());
+    if (id == -1) {
+      std::fprintf(stderr, "unknown scenario %s\n", name.c_str());
+      return 1;
+    }
+    selected[id] = true;
+  }
+
+  ScenarioBaseline baselines[SCENARIO_COUNT];
+  if (!opt.baselinePath.empty() && !read_baselines(opt.baselinePath, baselines)) {
+    std::fprintf(stderr, "failed to read baselines %s\n", opt.baselinePath.c_str());
+    return 1;
+  }
+
+  ScenarioResult results[SCENARIO_COUNT];
+  bool ran[SCENARIO_COUNT] = {};
+  bool failed = false;
+  print_scenario_header();
+  for (int i = 0; i < SCENARIO_COUNT; ++i) {
+    if (!selected[i]) continue;
+    const ScenarioId id = static_cast<ScenarioId>(i);
+
+    // Without a real map the bottleneck runs on a grid whose middle wall has a
+    // 3-cell gap, the split crossings on one with two such gaps.
+    const Navmesh mainNavmesh = g_navmesh;
+    uint8_t* bottleneckMemory = nullptr;
+    const bool split = id == SCENARIO_SPLIT_CROSSING || id == SCENARIO_SPLIT_CONGESTION;
+    if ((id == SCENARIO_BOTTLENECK || split) && opt.navmeshPath.empty()) {
+      SyntheticNavmeshParams params;
+      params.wallGapCells = 3;
+      if (split) params.wallGapSpacing = 20;
+      uint32_t bytes = 0;
+      bottleneckMemory = load_navmesh(build_synthetic_navmesh(params), &bytes);
+    }
+
+    ran[i] = run_scenario(id, results[i]);
+    if (ran[i]) print_scenario_result(id, results[i]);
+    else failed = true;
+
+    if (bottleneckMemory) {
+      g_navmesh = mainNavmesh;
+      std::free(bottleneckMemory);
+    }
+  }
+  if (failed) return 1;
+
+  if (!opt.saveBaselinePath.empty()) {
+    if (!write_baselines(opt.saveBaselinePath, results, ran)) {
+      std::fprintf(stderr, "failed to write baselines %s\n", opt.saveBaselinePath.c_str());
+      return 1;
+    }
+    std::printf("\nwrote baselines to %s\n", opt.saveBaselinePath.c_str());
+  }
+  if (opt.baselinePath.empty()) return 0;
+
+  bool regression = false;
+  std::printf("\nchecking against %s (threshold %.2f)\n", opt.baselinePath.c_str(), opt.threshold);
+  for (int i = 0; i < SCENARIO_COUNT; ++i) {
+    if (!ran[i]) continue;
+    const char* name = scenario_name(static_cast<ScenarioId>(i));
+    const ScenarioBaseline& b = baselines[i];
+    if (!b.present) {
+      std::printf("SKIP %s: no baseline\n", name);
+      continue;
+    }
+    const ScenarioResult& r = results[i];
+    bool bad = regressed(name, "p99 ms", r.p99_ms, b.p99_ms, opt.threshold, 0.05f);
+    bad |= regressed(name, "repaths/s", r.repaths_per_sec, b.repaths_per_sec, opt.threshold, 1.0f);
+    bad |= regressed(name, "mem KB", static_cast<float>(r.memory_high_water / 1024), b.mem_kb, opt.threshold, 64.0f);
+    if (!bad) std::printf("PASS %s\n", name);
+    regression |= bad;
+  }
+  return regression ? 2 : 0;
+}
+
+// Restores the mid-run snapshot, replays the remaining frames and requires the
+// result to match the original run byte for byte, directly and via a delta.
+bool check_snapshot_replay(const RunnerOptions& opt, int activeAgents, const std::vector<uint8_t>& mid,
+                           uint64_t midSeed, const std::vector<uint8_t>& expected) {
+  std::vector<uint8_t> delta;
+  std::vector<uint8_t> replayed;
+  if (!capture_simulation_snapshot(activeAgents, delta, mid.data(), static_cast<uint32_t>(mid.size()))) return false;
+  if (restore_simulation_snapshot(mid.data(), static_cast<uint32_t>(mid.size())) != activeAgents) return false;
+  uint64_t seed = midSeed;
+  for (int f = opt.frames / 2; f < opt.frames; ++f) {
+    update_random_journeys(activeAgents, &seed);
+    update_simulation(opt.dt, activeAgents);
+    discard_events();
+  }
+  capture_simulation_snapshot(activeAgents, replayed);
+  if (replayed != expected) {
+    std::printf("\nsnapshot check FAILED: replay from frame %d diverged\n", opt.frames / 2);
+    return false;
+  }
+  if (restore_simulation_snapshot(delta.data(), static_cast<uint32_t>(delta.size()), mid.data(),
+                                  static_cast<uint32_t>(mid.size())) != activeAgents) {
+    return false;
+  }
+  capture_simulation_snapshot(activeAgents, replayed);
+  if (replayed != expected) {
+    std::printf("\nsnapshot check FAILED: delta restore differs\n");
+    return false;
+  }
+  std::printf("\nsnapshot check ok: replay from frame %d is bit-identical (keyframe %zu bytes, delta %zu bytes)\n",
+              opt.frames / 2, expected.size(), delta.size());
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  RunnerOptions opt;
+  if (!parse_options(argc, argv, opt)) {
+    print_usage();
+    return 1;
+  }
+
+  std::vector<uint8_t> bin;
+  if (!opt.navmeshPath.empty()) {
+    if (!read_file(opt.navmeshPath, bin)) {
+      std::fprintf(stderr, "failed to read navmesh %s\n", opt.navmeshPath.c_str());
+      return 1;
+    }
+  } else {
+    bin = build_synthetic_navmesh(SyntheticNavmeshParams());
+  }
+  if (!opt.writeNavmeshPath.empty() && !write_file(opt.writeNavmeshPath, bin)) {
+    std::fprintf(stderr, "failed to write navmesh %s\n", opt.writeNavmeshPath.c_str());
+    return 1;
+  }
+  if (!opt.tracePath.empty()) profiler_set_trace_capture(true);
+
+  // 1. Constants
+  uint8_t* constants = alloc_aligned(NAV_CONSTANTS_BUFFER_BYTES);
+  write_default_nav_constants(constants);
+  set_constants_buffer(constants, false);
+
+  // 2. Navmesh. init_navmesh_from_bin takes a wasm32 offset, so go through the buffer entry point.
+  uint32_t navmeshBytes = 0;
+  const auto navmeshStart = std::chrono::steady_clock::now();
+  if (!load_navmesh(bin, &navmeshBytes)) {
+    std::fprintf(stderr, "navmesh initialization failed\n");
+    return 1;
+  }
+  const double navmeshMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - navmeshStart).count();
+  if (!opt.bakeNavmeshPath.empty()) {
+    std::vector<uint8_t> baked;
+    write_navmesh_v2(g_navmesh, true, baked);
+    if (!write_file(opt.bakeNavmeshPath, baked)) {
+      std::fprintf(stderr, "failed to write navmesh %s\n", opt.bakeNavmeshPath.c_str());
+      return 1;
+    }
+  }
+
+  // 3. Agents. The events pointer is wasm32-sized as well, so it is attached afterwards.
+  uint8_t* agentMemory = alloc_aligned(get_agent_layout_bytes(opt.agents));
+  uint8_t* eventMemory = alloc_aligned(EventRing::bytes(EVENT_BUFFER_WORDS) * 2);
+  init_agents(agentMemory, opt.agents, opt.seed, 0, 0);
+  g_command_ring.set(eventMemory, EVENT_BUFFER_WORDS);
+  g_event_ring.set(eventMemory + EventRing::bytes(EVENT_BUFFER_WORDS), EVENT_BUFFER_WORDS);
+
+  if (!opt.scenarios.empty()) return run_scenarios(opt);
+  if (!opt.microbench.empty()) {
+    MicrobenchOptions mb;
+    if (opt.microbench != "all") mb.filter = opt.microbench.c_str();
+    mb.repetitions = opt.microbenchReps;
+    if (microbench_run(mb) == 0) {
+      std::fprintf(stderr, "no microbench matched %s\n", opt.microbench.c_str());
+      return 1;
+    }
+    return 0;
+  }
+
+  uint64_t seed = opt.seed;
+  int activeAgents = opt.agents;
+  if (!opt.loadSnapshotPath.empty()) {
+    std::vector<uint8_t> snapshot;
+    if (!read_file(opt.loadSnapshotPath, snapshot)) {
+      std::fprintf(stderr, "failed to read snapshot %s\n", opt.loadSnapshotPath.c_str());
+      return 1;
+    }
+    activeAgents = restore_simulation_snapshot(snapshot.data(), static_cast<uint32_t>(snapshot.size()));
+    if (activeAgents < 0) return 1;
+  } else {
+    const AgentSpawnParams smart;
+    const AgentSpawnParams stupid = benchmarker_stupid_params();
+    for (int i = 0; i < opt.agents; ++i) {
+      const int tri = random_triangle_in_area({0.0f, 0.0f}, 30.0f, &seed);
+      if (tri == -1) {
+        std::fprintf(stderr, "navmesh has no walkable triangles\n");
+        return 1;
+      }
+      spawn_agent(i, g_navmesh.triangle_centroids[tri], (i & 1) ? stupid : smart);
+    }
+  }
+
+  std::printf("navmesh: %d walkable triangles, %d walkable polygons, %u bytes, loaded in %.2f ms\n",
+              g_navmesh.walkable_triangle_count, g_navmesh.walkable_polygon_count, navmeshBytes, navmeshMs);
+  std::printf("running %d agents for %d frames (dt %.4f)\n", activeAgents, opt.frames, opt.dt);
+
+  if (opt.warmupSteps > 0) {
+    update_random_journeys(activeAgents, &seed);
+    update_simulation_steps(opt.dt, opt.warmupSteps, activeAgents, false);
+    discard_events();
+    const StepBatchStats& warm = g_step_batch_stats;
+    std::printf("warm-up: %u steps in %.1f ms (max step %.3f ms), %u repaths, %u alive\n", warm.steps,
+                warm.wall_ms, warm.max_step_ms, warm.repaths, warm.alive_agents);
+  }
+
+  const int checkFrame = opt.checkSnapshot ? opt.frames / 2 : -1;
+  std::vector<uint8_t> midSnapshot;
+  uint64_t midSeed = 0;
+  std::vector<float> frameMs;
+  frameMs.reserve(opt.frames);
+  float totalMs = 0.0f;
+  for (int f = 0; f < opt.frames; ++f) {
+    if (f == checkFrame) {
+      capture_simulation_snapshot(activeAgents, midSnapshot);
+      midSeed = seed;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    update_random_journeys(activeAgents, &seed);
+    update_simulation(opt.dt, activeAgents);
+    discard_events();
+    const auto end = std::chrono::steady_clock::now();
+    frameMs.push_back(std::chrono::duration<float, std::milli>(end - start).count());
+    totalMs += frameMs.back();
+  }
+
+  std::printf("\nframe ms: p50 %.3f  p99 %.3f  max %.3f  (total %.1f ms, %.1f frames/s)\n",
+              percentile(frameMs, 0.5f), percentile(frameMs, 0.99f),
+              *std::max_element(frameMs.begin(), frameMs.end()), totalMs, opt.frames * 1000.0f / totalMs);
+  print_profiler_page();
+  print_nav_telemetry();
+
+  if (opt.checkPhysSimd) {
+    const int PHYS_CHECK_STEPS = 120;
+    const PhysSimdComparison r = compare_phys_simd_trajectory(activeAgents, PHYS_CHECK_STEPS, opt.dt);
+    if (r.max_deviation > PHYS_SIMD_TOLERANCE) {
+      std::printf("\nphysics SIMD check FAILED: agent %d deviates by %f within one of %d steps (tolerance %f)\n",
+                  r.worst_agent, r.max_deviation, r.steps, PHYS_SIMD_TOLERANCE);
+      return 1;
+    }
+    std::printf("\nphysics SIMD check ok: %d agents x %d steps, max deviation %g\n", r.agents, r.steps, r.max_deviation);
+  }
+
+  if (!opt.saveSnapshotPath.empty() || opt.checkSnapshot) {
+    std::vector<uint8_t> finalSnapshot;
+    if (!capture_simulation_snapshot(activeAgents, finalSnapshot)) return 1;
+    if (!opt.saveSnapshotPath.empty()) {
+      if (!write_file(opt.saveSnapshotPath, finalSnapshot)) {
+        std::fprintf(stderr, "failed to write snapshot %s\n", opt.saveSnapshotPath.c_str());
+        return 1;
+      }
+      std::printf("\nwrote %zu byte snapshot to %s\n", finalSnapshot.size(), opt.saveSnapshotPath.c_str());
+    }
+    if (opt.checkSnapshot && !check_snapshot_replay(opt, activeAgents, midSnapshot, midSeed, finalSnapshot)) return 1;
+  }
+
+  if (!opt.tracePath.empty()) {
+    if (!profiler_write_chrome_trace(opt.tracePath.c_str())) {
+      std::fprintf(stderr, "failed to write trace %s\n", opt.tracePath.c_str());
+      return 1;
+    }
+    std::printf("\nwrote Chrome trace to %s\n", opt.tracePath.c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,157 @@
+#include "synthetic_navmesh.h"
+#include "math_utils.h"
+#include <cstring>
+
+namespace {
+
+struct BinWriter {
+  std::vector<uint8_t> bytes;
+
+  void f32(float v) { append(&v, sizeof(v)); }
+  void i32(int32_t v) { append(&v, sizeof(v)); }
+  void i32s(const std::vector<int32_t>& v) { append(v.data(), v.size() * sizeof(int32_t)); }
+  void f32s(const std::vector<float>& v) { append(v.data(), v.size() * sizeof(float)); }
+  void append(const void* p, size_t n) {
+    const size_t at = bytes.size();
+    bytes.resize(at + n);
+    std::memcpy(bytes.data() + at, p, n);
+  }
+};
+
+} // namespace
+
+std::vector<uint8_t> build_synthetic_navmesh(const SyntheticNavmeshParams& params) {
+  const int W = params.cellsX;
+  const int H = params.cellsY;
+  const float s = params.cellSize;
+  const float minX = -0.5f * W * s;
+  const float minY = -0.5f * H * s;
+
+  // Decide blocked cells; the border is always blocked so walkable edges never face -1.
+  std::vector<uint8_t> blocked(W * H, 0);
+  uint64_t seed = params.seed;
+  const int gapStart = (H - params.wallGapCells) / 2;
+  const int gapOffset = params.wallGapSpacing / 2;
+  auto inGap = [&](int cy, int offset) {
+    return cy >= gapStart + offset && cy < gapStart + offset + params.wallGapCells;
+  };
+  for (int cy = 0; cy < H; ++cy) {
+    for (int cx = 0; cx < W; ++cx) {
+      const bool border = cx == 0 || cy == 0 || cx == W - 1 || cy == H - 1;
+      const bool wallColumn = params.wallGapCells > 0 && cx == W / 2;
+      const bool gap = wallColumn && (params.wallGapSpacing > 0 ? inGap(cy, -gapOffset) || inGap(cy, gapOffset)
+                                                                : inGap(cy, 0));
+      const auto r = math::seededRandom(seed);
+      seed = r.newSeed;
+      blocked[cy * W + cx] = border || (wallColumn && !gap) || (!gap && r.value < params.pillarRatio);
+    }
+  }
+
+  // Walkable polygons first, then blobs, as the navmesh pipeline orders them.
+  std::vector<int32_t> polyOfCell(W * H, -1);
+  int walkable = 0;
+  for (int c = 0; c < W * H; ++c) {
+    if (!blocked[c]) polyOfCell[c] = walkable++;
+  }
+  int next = walkable;
+  for (int c = 0; c < W * H; ++c) {
+    if (blocked[c]) polyOfCell[c] = next++;
+  }
+  const int polyCount = next;
+  const int blobCount = polyCount - walkable;
+
+  std::vector<int32_t> cellOfPoly(polyCount);
+  for (int c = 0; c < W * H; ++c) cellOfPoly[polyOfCell[c]] = c;
+
+  auto vertexId = [W](int vx, int vy) { return vy * (W + 1) + vx; };
+  auto polyAt = [&](int cx, int cy) -> int32_t {
+    if (cx < 0 || cy < 0 || cx >= W || cy >= H) return -1;
+    return polyOfCell[cy * W + cx];
+  };
+  // Triangle 0 of a cell owns its bottom and right edges, triangle 1 its top and left edges.
+  auto triAt = [&](int cx, int cy, int which) -> int32_t {
+    const int32_t p = polyAt(cx, cy);
+    return p < 0 ? -1 : p * 2 + which;
+  };
+
+  std::vector<float> vertices;
+  vertices.reserve((W + 1) * (H + 1) * 2);
+  for (int vy = 0; vy <= H; ++vy) {
+    for (int vx = 0; vx <= W; ++vx) {
+      vertices.push_back(minX + vx * s);
+      vertices.push_back(minY + vy * s);
+    }
+  }
+
+  std::vector<int32_t> triangles, neighbors, polygons, polyVerts, polyTris, polyNeighbors;
+  std::vector<float> polyCentroids;
+  for (int p = 0; p < polyCount; ++p) {
+    const int cx = cellOfPoly[p] % W;
+    const int cy = cellOfPoly[p] / W;
+    const int32_t a = vertexId(cx, cy);
+    const int32_t b = vertexId(cx + 1, cy);
+    const int32_t c = vertexId(cx + 1, cy + 1);
+    const int32_t d = vertexId(cx, cy + 1);
+
+    // Counter-clockwise; neighbor i is across edge (v_i, v_i+1).
+    triangles.insert(triangles.end(), {a, b, c, a, c, d});
+    neighbors.insert(neighbors.end(), {triAt(cx, cy - 1, 1), triAt(cx + 1, cy, 1), p * 2 + 1});
+    neighbors.insert(neighbors.end(), {p * 2, triAt(cx, cy + 1, 0), triAt(cx - 1, cy, 0)});
+
+    polygons.push_back(static_cast<int32_t>(polyVerts.size()));
+    polyVerts.insert(polyVerts.end(), {a, b, c, d});
+    polyNeighbors.insert(polyNeighbors.end(), {polyAt(cx, cy - 1), polyAt(cx + 1, cy), polyAt(cx, cy + 1), polyAt(cx - 1, cy)});
+    polyTris.push_back(p * 2);
+    polyCentroids.push_back(minX + (cx + 0.5f) * s);
+    polyCentroids.push_back(minY + (cy + 0.5f) * s);
+  }
+  polygons.push_back(static_cast<int32_t>(polyVerts.size()));
+  polyVerts.push_back(-1);
+  polyNeighbors.push_back(-1);
+  polyTris.push_back(polyCount * 2);
+
+  // One building per blob, with the blob's own outline as its detailed geometry.
+  std::vector<int32_t> buildings, buildingVerts, blobBuildings;
+  for (int b = 0; b < blobCount; ++b) {
+    const int32_t p = walkable + b;
+    buildings.push_back(static_cast<int32_t>(buildingVerts.size()));
+    for (int k = 0; k < 4; ++k) buildingVerts.push_back(polyVerts[polygons[p] + k]);
+    blobBuildings.push_back(b);
+  }
+  buildings.push_back(static_cast<int32_t>(buildingVerts.size()));
+  buildingVerts.push_back(-1);
+  blobBuildings.push_back(blobCount);
+
+  BinWriter w;
+  const float maxX = minX + W * s;
+  const float maxY = minY + H * s;
+  for (int k = 0; k < 2; ++k) { // real bbox, then buffered bbox
+    w.f32(minX); w.f32(minY); w.f32(maxX); w.f32(maxY);
+  }
+  w.i32(static_cast<int32_t>(vertices.size()));
+  w.i32(static_cast<int32_t>(triangles.size()));
+  w.i32(static_cast<int32_t>(neighbors.size()));
+  w.i32(static_cast<int32_t>(polygons.size()));
+  w.i32(static_cast<int32_t>(polyCentroids.size()));
+  w.i32(static_cast<int32_t>(polyVerts.size()));
+  w.i32(static_cast<int32_t>(polyTris.size()));
+  w.i32(static_cast<int32_t>(polyNeighbors.size()));
+  w.i32(static_cast<int32_t>(buildings.size()));
+  w.i32(static_cast<int32_t>(buildingVerts.size()));
+  w.i32(static_cast<int32_t>(blobBuildings.size()));
+  w.i32(walkable * 2);
+  w.i32(walkable);
+
+  w.f32s(vertices);
+  w.i32s(triangles);
+  w.i32s(neighbors);
+  w.i32s(polygons);
+  w.f32s(polyCentroids);
+  w.i32s(polyVerts);
+  w.i32s(polyTris);
+  w.i32s(polyNeighbors);
+  w.i32s(buildings);
+  w.i32s(buildingVerts);
+  w.i32s(blobBuildings);
+  return w.bytes;
+}
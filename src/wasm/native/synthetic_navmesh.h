@@ -0,0 +1,23 @@
+#ifndef SYNTHETIC_NAVMESH_H
+#define SYNTHETIC_NAVMESH_H
+
+#include <cstdint>
+#include <vector>
+
+// Square-grid navmesh in the navmesh.bin format parsed by init_navmesh_from_buffer.
+// Every cell is one quad polygon split into two CCW triangles. Border cells and
+// randomly chosen pillar cells are blobs (impassable polygons), the rest is walkable.
+// The grid is centered on the origin, like the city maps RandomJourney targets.
+struct SyntheticNavmeshParams {
+  int cellsX = 200;
+  int cellsY = 200;
+  float cellSize = 8.0f;
+  float pillarRatio = 0.08f; // chance of an interior cell being blocked
+  int wallGapCells = 0;      // > 0: wall along the middle column with a centered gap this many cells tall
+  int wallGapSpacing = 0;    // > 0: two such gaps instead, their centers this many cells apart
+  uint64_t seed = 777;
+};
+
+std::vector<uint8_t> build_synthetic_navmesh(const SyntheticNavmeshParams& params);
+
+#endif // SYNTHETIC_NAVMESH_H
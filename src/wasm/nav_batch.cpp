@@ -0,0 +1,78 @@
+#include "nav_batch.h"
+#include "nav_utils.h"
+#include "navmesh.h"
+#include "path_corridor.h"
+#include "raycasting.h"
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Batches run on the JS thread, so they get their own A* scratch and counters
+// like a path worker instead of the simulation thread's.
+struct BatchSearch {
+  NavCounters counters;
+  PathSearchContext ctx;
+  BatchSearch() {
+    ctx.counters = &counters;
+    ctx.sim_thread = false;
+  }
+};
+
+BatchSearch g_batch_search;
+
+// Appends corridor at *cursor; false if it does not fit.
+bool append_corridor(const std::vector<int>& corridor, int32_t* out, int outWords, int& cursor, int32_t* record) {
+  const int length = static_cast<int>(corridor.size());
+  if (cursor + length > outWords) return false;
+  if (length > 0) std::memcpy(out + cursor, corridor.data(), length * sizeof(int32_t));
+  record[0] = cursor;
+  record[1] = length;
+  cursor += length;
+  return true;
+}
+
+} // namespace
+
+int nav_batch_locate(const float* points, const int32_t* hints, int count, int32_t* out) {
+  for (int i = 0; i < count; ++i) {
+    const Point2 p = {points[i * 2], points[i * 2 + 1]};
+    const int32_t tri = is_point_in_navmesh(p, hints ? hints[i] : -1);
+    out[i * NAV_BATCH_LOCATE_WORDS] = tri;
+    out[i * NAV_BATCH_LOCATE_WORDS + 1] = tri >= 0 ? g_navmesh.triangle_to_polygon[tri] : -1;
+  }
+  return count;
+}
+
+int nav_batch_raycast(const float* segments, const int32_t* hints, int count, int32_t* out, int outWords) {
+  int cursor = count * NAV_BATCH_RAY_WORDS;
+  if (cursor > outWords) return 0;
+  for (int i = 0; i < count; ++i) {
+    const float* s = segments + i * 4;
+    const RaycastCorridorResult rc = raycastCorridor({s[0], s[1]}, {s[2], s[3]},
+                                                     hints ? hints[i * 2] : -1, hints ? hints[i * 2 + 1] : -1);
+    int32_t* record = out + i * NAV_BATCH_RAY_WORDS;
+    record[0] = rc.hitV1_idx;
+    record[1] = rc.hitV2_idx;
+    record[2] = rc.hitTri_idx;
+    if (!append_corridor(rc.corridor, out, outWords, cursor, record + 3)) return i;
+  }
+  return count;
+}
+
+int nav_batch_corridors(const float* segments, const int32_t* hints, int count, float freeWidth, float strayMult,
+                        int32_t* out, int outWords) {
+  int cursor = count * NAV_BATCH_PATH_WORDS;
+  if (cursor > outWords) return 0;
+  std::vector<int> corridor;
+  for (int i = 0; i < count; ++i) {
+    const float* s = segments + i * 4;
+    corridor.clear();
+    if (!findCorridor(g_batch_search.ctx, g_navmesh, freeWidth, strayMult, 0.0f, {s[0], s[1]}, {s[2], s[3]}, corridor,
+                      hints ? hints[i * 2] : -1, hints ? hints[i * 2 + 1] : -1)) {
+      corridor.clear();
+    }
+    if (!append_corridor(corridor, out, outWords, cursor, out + i * NAV_BATCH_PATH_WORDS)) return i;
+  }
+  return count;
+}
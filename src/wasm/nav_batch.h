@@ -0,0 +1,37 @@
+#ifndef NAV_BATCH_H
+#define NAV_BATCH_H
+
+#include <cstdint>
+
+// Batched navmesh queries for JS: one call answers a whole array of queries
+// and writes packed int32 records into a single output buffer.
+//
+//   out[0 .. count * RECORD_WORDS)  one fixed-size record per query
+//   out[count * RECORD_WORDS .. )   corridors, back to back
+//
+// Corridor fields are a word offset from out and a length. Queries are
+// answered in order; when the next corridor does not fit in outWords the call
+// stops and returns how many queries were answered, so the caller can grow
+// the buffer or resubmit the rest. Hint arrays may be null (no hints).
+//
+// Like the path workers, batches only read the navmesh and search with their
+// own state, so they may run while the simulation thread does. They must not
+// overlap loading a navmesh, and only one batch may run at a time.
+
+const int NAV_BATCH_LOCATE_WORDS = 2;  // triangle, polygon (-1, -1 outside the walkable mesh)
+const int NAV_BATCH_RAY_WORDS = 5;     // hitV1, hitV2, hitTri (-1 if clear), corridor offset, length
+const int NAV_BATCH_PATH_WORDS = 2;    // corridor offset, length (0 = no path)
+
+// points: x, y per query; hints: last known triangle per query.
+int nav_batch_locate(const float* points, const int32_t* hints, int count, int32_t* out);
+
+// segments: startX, startY, endX, endY per query; hints: startTri, endTri per
+// query. Records and corridors as raycastCorridor (triangles).
+int nav_batch_raycast(const float* segments, const int32_t* hints, int count, int32_t* out, int outWords);
+
+// segments as for nav_batch_raycast; hints: startPoly, endPoly per query.
+// Corridors are polygons, as findCorridor.
+int nav_batch_corridors(const float* segments, const int32_t* hints, int count, float freeWidth, float strayMult,
+                        int32_t* out, int outWords);
+
+#endif // NAV_BATCH_H
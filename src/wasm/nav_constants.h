@@ -0,0 +1,98 @@
+#ifndef NAV_CONSTANTS_H
+#define NAV_CONSTANTS_H
+
+#include <cstdint>
+#include "constants_layout.h"
+
+// X(member, type, offset, baked value)
+// Baked values MUST match the defaults in src/logic/agents/NavConst.ts.
+#define NAV_CONSTANTS(X) \
+  X(stuck_passive_x1, float, OFFSET_STUCK_PASSIVE_X1, 14.0f) \
+  X(stuck_dst_x2, float, OFFSET_STUCK_DST_X2, 18.0f) \
+  X(stuck_corridor_x3, float, OFFSET_STUCK_CORRIDOR_X3, 40.0f) \
+  X(stuck_decay, float, OFFSET_STUCK_DECAY, 0.8f) \
+  X(stuck_danger_1, float, OFFSET_STUCK_DANGER_1, 35.0f) \
+  X(stuck_danger_2, float, OFFSET_STUCK_DANGER_2, 45.0f) \
+  X(stuck_danger_3, float, OFFSET_STUCK_DANGER_3, 75.0f) \
+  X(stuck_hit_wall, float, OFFSET_STUCK_HIT_WALL, 10.0f) \
+  X(path_log_rate, int32_t, OFFSET_PATH_LOG_RATE, 3) \
+  X(look_rot_speed_rad_s, float, OFFSET_LOOK_ROT_SPEED_RAD_S, 6.0f) \
+  X(corridor_expected_jump, float, OFFSET_CORRIDOR_EXPECTED_JUMP, 120.0f) \
+  X(arrival_threshold_sq_default, float, OFFSET_ARRIVAL_THRESHOLD_SQ_DEFAULT, 4.0f) \
+  X(arrival_desired_speed_default, float, OFFSET_ARRIVAL_DESIRED_SPEED_DEFAULT, 1.0f) \
+  X(max_speed_default, float, OFFSET_MAX_SPEED_DEFAULT, 3.0f) \
+  X(accel_default, float, OFFSET_ACCEL_DEFAULT, 20.0f) \
+  X(resistance_default, float, OFFSET_RESISTANCE_DEFAULT, 0.1f) \
+  X(max_frustration_default, float, OFFSET_MAX_FRUSTRATION_DEFAULT, 10.0f) \
+  X(corner_offset, float, OFFSET_CORNER_OFFSET, 2.1f) \
+  X(corner_offset_sq, float, OFFSET_CORNER_OFFSET_SQ, 4.41f) \
+  X(path_free_width, float, OFFSET_PATH_FREE_WIDTH, 70.0f) \
+  X(path_width_penalty_mult, float, OFFSET_PATH_WIDTH_PENALTY_MULT, 3.0f) \
+  X(congestion_decay, float, OFFSET_CONGESTION_DECAY, 0.3f) \
+  X(congestion_update_frames, int32_t, OFFSET_CONGESTION_UPDATE_FRAMES, 4)
+
+// Per-run knobs: plain members in both structs, so a native caller (the
+// scenario bench) can override them for one run even when the rest is baked.
+// Read once per search or per fold, so folding them would buy nothing.
+#define NAV_TUNABLES(X) \
+  X(congestion_cost_mult, float, OFFSET_CONGESTION_COST_MULT, 0.0f)
+
+#define NAV_ALL_CONSTANTS(X) NAV_CONSTANTS(X) NAV_TUNABLES(X)
+
+// Compile-time copy of the TS defaults. Kernels see the same member names as
+// RuntimeNavConstants, so they can be specialized by swapping the type.
+struct BakedNavConstants {
+#define X(member, type, offset, baked) static constexpr type member = baked;
+  NAV_CONSTANTS(X)
+#undef X
+#define X(member, type, offset, baked) type member = baked;
+  NAV_TUNABLES(X)
+#undef X
+};
+
+// Plain copy of g_constants_buffer. Taken once per tick so the agent loops
+// read locals the compiler can keep in registers instead of reloading the
+// buffer through a pointer after every store.
+struct RuntimeNavConstants {
+#define X(member, type, offset, baked) type member;
+  NAV_ALL_CONSTANTS(X)
+#undef X
+
+  static RuntimeNavConstants from_buffer(const uint8_t* buffer) {
+    RuntimeNavConstants c;
+#define X(member, type, offset, baked) c.member = *reinterpret_cast<const type*>(buffer + (offset));
+    NAV_ALL_CONSTANTS(X)
+#undef X
+    return c;
+  }
+};
+
+// Build with -DNAV_CONSTANTS_BAKED (make NAV_CONSTANTS=baked) to fold the
+// constants into the kernels; values written by TS are then only checked.
+#ifdef NAV_CONSTANTS_BAKED
+typedef BakedNavConstants NavConstants;
+#else
+typedef RuntimeNavConstants NavConstants;
+#endif
+
+// Bytes of the constants buffer (ConstantsLayout.ts).
+const int NAV_CONSTANTS_BUFFER_BYTES = OFFSET_CONGESTION_UPDATE_FRAMES + 4;
+
+// Fills a constants buffer with the NavConst.ts defaults, for headless runs
+// that have no TS side to write g_constants_buffer.
+inline void write_default_nav_constants(uint8_t* buffer) {
+#define X(member, type, offset, baked) *reinterpret_cast<type*>(buffer + (offset)) = baked;
+  NAV_ALL_CONSTANTS(X)
+#undef X
+}
+
+// Snapshot of the constants for one simulation step.
+inline NavConstants load_nav_constants() {
+#ifdef NAV_CONSTANTS_BAKED
+  return NavConstants{};
+#else
+  return RuntimeNavConstants::from_buffer(g_constants_buffer);
+#endif
+}
+
+#endif // NAV_CONSTANTS_H
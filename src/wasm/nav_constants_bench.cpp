@@ -0,0 +1,123 @@
+#include "benchmarks.h"
+#include "nav_constants.h"
+#include "constants_layout.h"
+#include "math_utils.h"
+#include <stdio.h>
+#include <vector>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+// Three ways a kernel can see the constants, behind the same accessors.
+struct BufferAccess {
+  float passive() const { return STUCK_PASSIVE_X1; }
+  float dst() const { return STUCK_DST_X2; }
+  float decay() const { return STUCK_DECAY; }
+  float danger() const { return STUCK_DANGER_2; }
+  float hit_wall() const { return STUCK_HIT_WALL; }
+};
+
+struct SnapshotAccess {
+  const RuntimeNavConstants& nc;
+  float passive() const { return nc.stuck_passive_x1; }
+  float dst() const { return nc.stuck_dst_x2; }
+  float decay() const { return nc.stuck_decay; }
+  float danger() const { return nc.stuck_danger_2; }
+  float hit_wall() const { return nc.stuck_hit_wall; }
+};
+
+struct BakedAccess {
+  float passive() const { return BakedNavConstants::stuck_passive_x1; }
+  float dst() const { return BakedNavConstants::stuck_dst_x2; }
+  float decay() const { return BakedNavConstants::stuck_decay; }
+  float danger() const { return BakedNavConstants::stuck_danger_2; }
+  float hit_wall() const { return BakedNavConstants::stuck_hit_wall; }
+};
+
+struct StuckData {
+  std::vector<float> stuck, speed, max_speed, dist_decrease, out_factor;
+  std::vector<uint8_t> wall;
+};
+
+// Mirrors the constant-heavy parts of update_agent_statistic / update_agent_move.
+// Writes go through float*, so with BufferAccess the compiler must assume they
+// may alias the constants buffer and reload it every iteration.
+template<typename C>
+void stuck_kernel(const C& c, StuckData& d, int n, float dt) {
+  float* stuck = d.stuck.data();
+  float* outFactor = d.out_factor.data();
+  for (int i = 0; i < n; ++i) {
+    const float velocityFactor = d.speed[i] / d.max_speed[i];
+    const float velocityMult = math::lerp(2.0f, 0.4f, velocityFactor * velocityFactor * velocityFactor);
+    stuck[i] += c.passive() * dt * velocityMult;
+    stuck[i] -= d.dist_decrease[i] / (d.speed[i] * dt) * c.dst() / d.max_speed[i];
+    if (d.wall[i]) stuck[i] += c.hit_wall();
+    stuck[i] *= std::pow(c.decay(), dt);
+    if (stuck[i] < 0) stuck[i] = 0;
+    const float f = stuck[i] / c.danger();
+    outFactor[i] = math::cvt(f * f, 0.0f, 1.0f, 1.0f, 0.5f);
+  }
+}
+
+template<typename C>
+double time_kernel(const C& c, StuckData& d, int n, int reps, float dt, float& checksum) {
+  auto t0 = std::chrono::high_resolution_clock::now();
+  for (int r = 0; r < reps; ++r) stuck_kernel(c, d, n, dt);
+  auto t1 = std::chrono::high_resolution_clock::now();
+  checksum = 0.0f;
+  for (int i = 0; i < n; ++i) checksum += d.out_factor[i];
+  return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+} // namespace
+
+// Compares reading nav constants through g_constants_buffer, from a per-step
+// snapshot, and as compile-time values on a statistic-like agent kernel.
+void nav_constants_bench() {
+  if (!g_constants_buffer) {
+    printf("[WASM] nav_constants_bench: constants buffer is not set\n");
+    return;
+  }
+  const int N = 32768;
+  const int REPS = 200;
+  const float DT = 1.0f / 60.0f;
+
+  StuckData base;
+  base.stuck.resize(N);
+  base.speed.resize(N);
+  base.max_speed.resize(N);
+  base.dist_decrease.resize(N);
+  base.out_factor.resize(N);
+  base.wall.resize(N);
+  uint64_t seed = 4242;
+  for (int i = 0; i < N; ++i) {
+    auto r = math::seededRandom(seed);
+    seed = r.newSeed;
+    base.stuck[i] = r.value * 60.0f;
+    base.speed[i] = 1.0f + r.value * 2.0f;
+    base.max_speed[i] = 3.0f;
+    base.dist_decrease[i] = (r.value - 0.5f) * 0.05f;
+    base.wall[i] = r.value > 0.9f ? 1 : 0;
+  }
+
+  const RuntimeNavConstants snapshot = RuntimeNavConstants::from_buffer(g_constants_buffer);
+  float sumBuffer = 0.0f, sumSnapshot = 0.0f, sumBaked = 0.0f;
+
+  StuckData d = base;
+  const double bufferMs = time_kernel(BufferAccess{}, d, N, REPS, DT, sumBuffer);
+  d = base;
+  const double snapshotMs = time_kernel(SnapshotAccess{snapshot}, d, N, REPS, DT, sumSnapshot);
+  d = base;
+  const double bakedMs = time_kernel(BakedAccess{}, d, N, REPS, DT, sumBaked);
+
+  printf("\nNav constants access over %d agents x %d reps\n", N, REPS);
+  printf("- %-30s: t=%.2f\tsum=%f\n", "g_constants_buffer", bufferMs, sumBuffer);
+  printf("- %-30s: t=%.2f\tsum=%f\n", "per-step snapshot", snapshotMs, sumSnapshot);
+  printf("- %-30s: t=%.2f\tsum=%f\n", "baked constexpr", bakedMs, sumBaked);
+#ifdef NAV_CONSTANTS_BAKED
+  printf("Simulation profile: baked\n");
+#else
+  printf("Simulation profile: snapshot\n");
+#endif
+}
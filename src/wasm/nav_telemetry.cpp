@@ -0,0 +1,55 @@
+#include "nav_telemetry.h"
+#include <atomic>
+#include <cstring>
+
+NavCounters g_nav_frame = {};
+
+namespace {
+
+struct NavTelemetryPage {
+  uint32_t header[NAV_TELEMETRY_HEADER_WORDS];
+  NavCounters last;
+  NavCounters total;
+  NavCounters peak;
+};
+
+NavTelemetryPage g_page = {
+  {0, 0, NAV_COUNTER_WORDS, REPATH_REASON_COUNT},
+  {}, {}, {},
+};
+
+} // namespace
+
+void nav_telemetry_end_frame() {
+#if NAV_TELEMETRY_ENABLED
+  __atomic_fetch_add(&g_page.header[0], 1u, __ATOMIC_RELAXED);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  g_page.last = g_nav_frame;
+  const uint32_t* frame = reinterpret_cast<const uint32_t*>(&g_nav_frame);
+  uint32_t* total = reinterpret_cast<uint32_t*>(&g_page.total);
+  uint32_t* peak = reinterpret_cast<uint32_t*>(&g_page.peak);
+  for (int i = 0; i < NAV_COUNTER_WORDS; ++i) {
+    total[i] += frame[i];
+    if (frame[i] > peak[i]) peak[i] = frame[i];
+  }
+  g_page.header[1]++;
+
+  __atomic_fetch_add(&g_page.header[0], 1u, __ATOMIC_RELEASE);
+  std::memset(&g_nav_frame, 0, sizeof(g_nav_frame));
+#endif
+}
+
+void nav_counters_add(NavCounters& into, const NavCounters& from) {
+  uint32_t* dst = reinterpret_cast<uint32_t*>(&into);
+  const uint32_t* src = reinterpret_cast<const uint32_t*>(&from);
+  for (int i = 0; i < NAV_COUNTER_WORDS; ++i) dst[i] += src[i];
+}
+
+const uint32_t* nav_telemetry_page() {
+  return g_page.header;
+}
+
+const NavCounters& nav_telemetry_totals() {
+  return g_page.total;
+}
@@ -0,0 +1,75 @@
+#ifndef NAV_TELEMETRY_H
+#define NAV_TELEMETRY_H
+
+#include <cstdint>
+
+// Pathfinding counters, accumulated during a step and published once per
+// frame (nav_telemetry_end_frame) into a page TS reads through a seqlock
+// (src/logic/NavTelemetry.ts).
+
+// Build with -DNAV_TELEMETRY_ENABLED=0 to compile the counters out.
+#ifndef NAV_TELEMETRY_ENABLED
+#define NAV_TELEMETRY_ENABLED 1
+#endif
+
+// Why findPathToDestination was called. Order MUST match RepathReason in NavTelemetry.ts.
+enum RepathReason : uint32_t {
+  REPATH_FROM_START = 0,          // traveling agent with an empty corridor
+  REPATH_FROM_STUCK = 1,          // stuck rating over the danger threshold
+  REPATH_AFTER_PATH_RECOVERY = 2, // left the corridor more often than max frustration allows
+  REPATH_AFTER_ESCAPING = 3,      // back on the navmesh after escaping
+  REPATH_REASON_COUNT
+};
+
+// X(member). Order MUST match NAV_COUNTERS in NavTelemetry.ts.
+#define NAV_COUNTERS(X) \
+  X(astar_calls) \
+  X(astar_nodes_expanded) \
+  X(astar_iteration_cap) \
+  X(astar_no_path) \
+  X(astar_invalid_polys) \
+  X(patch_direct_ok) \
+  X(patch_miter_ok) \
+  X(patch_miter_fail) \
+  X(patch_intersection_ok) \
+  X(patch_intersection_fail) \
+  X(corner_recomputes) \
+  X(corner_recompute_empty)
+
+struct NavCounters {
+#define X(member) uint32_t member;
+  NAV_COUNTERS(X)
+#undef X
+  uint32_t repaths[REPATH_REASON_COUNT];
+  uint32_t repath_failures[REPATH_REASON_COUNT];
+};
+
+const int NAV_COUNTER_WORDS = sizeof(NavCounters) / 4;
+
+// Page exported via get_nav_telemetry_ptr (u32 words):
+//   [0] seq (odd while publishing), [1] frames published, [2] words per counter block,
+//   [3] repath reason count
+//   then three NavCounters blocks: last frame, totals since start, per-field peak of any frame.
+const int NAV_TELEMETRY_HEADER_WORDS = 4;
+
+// Counters of the step in progress. Only the simulation thread writes them.
+extern NavCounters g_nav_frame;
+
+void nav_telemetry_end_frame();
+const uint32_t* nav_telemetry_page();
+// Totals since start, as published by the last nav_telemetry_end_frame.
+const NavCounters& nav_telemetry_totals();
+
+// Adds every counter of from into into; path workers count into their own
+// block, which the simulation thread merges into g_nav_frame.
+void nav_counters_add(NavCounters& into, const NavCounters& from);
+
+#if NAV_TELEMETRY_ENABLED
+#define NAV_COUNT_ADD_TO(counters, member, n) ((counters).member += static_cast<uint32_t>(n))
+#else
+#define NAV_COUNT_ADD_TO(counters, member, n) ((void)0)
+#endif
+#define NAV_COUNT_ADD(member, n) NAV_COUNT_ADD_TO(g_nav_frame, member, n)
+#define NAV_COUNT(member) NAV_COUNT_ADD(member, 1)
+
+#endif // NAV_TELEMETRY_H
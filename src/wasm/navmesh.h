@@ -52,6 +52,10 @@ struct Navmesh {
   int32_t triangle_to_polygon_count;
   int32_t building_to_blob_count;
   
+  // Binary the arrays were parsed from (start of the navmesh memory)
+  const uint8_t* binary;
+  uint32_t binary_bytes;
+  
   // Four spatial indices for fast queries
   SpatialIndex triangle_index;   // For triangle queries
   SpatialIndex polygon_index;  // For polygon queries  
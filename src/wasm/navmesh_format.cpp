@@ -0,0 +1,191 @@
+#include "navmesh_format.h"
+#include "wasm_log.h"
+#include <stdio.h>
+#include <cstring>
+
+namespace {
+
+const size_t V1_BBOX_BYTES = 8 * sizeof(float);
+const size_t V1_HEADER_FIELDS = 13;
+
+uint32_t fnv1a(const uint8_t* data, size_t bytes, uint32_t hash = 2166136261u) {
+  for (size_t i = 0; i < bytes; ++i) {
+    hash ^= data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+const NavmeshV2Section* v2_directory(const uint8_t* binary) {
+  return reinterpret_cast<const NavmeshV2Section*>(binary + sizeof(NavmeshV2Header));
+}
+
+uint32_t v2_checksum(const uint8_t* binary, uint32_t sectionCount) {
+  NavmeshV2Header header;
+  std::memcpy(&header, binary, sizeof(header));
+  header.checksum = 0;
+  const uint32_t hash = fnv1a(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+  return fnv1a(binary + sizeof(header), sectionCount * sizeof(NavmeshV2Section), hash);
+}
+
+// Validates header, checksum and section bounds; fills sections[id] (nullptr if absent).
+bool read_v2_sections(const uint8_t* binary, uint32_t bytes, const NavmeshV2Section* sections[NAV_SECTION_COUNT]) {
+  const NavmeshV2Header* header = reinterpret_cast<const NavmeshV2Header*>(binary);
+  if (header->version != NAVMESH_V2_VERSION || header->header_bytes != sizeof(NavmeshV2Header)) {
+    printf("[WASM] navmesh v2: unsupported version %u\n", header->version);
+    return false;
+  }
+  const uint64_t directoryEnd = sizeof(NavmeshV2Header) + static_cast<uint64_t>(header->section_count) * sizeof(NavmeshV2Section);
+  if (header->file_bytes > bytes || directoryEnd > header->file_bytes) {
+    printf("[WASM] navmesh v2: truncated file (%u of %u bytes)\n", bytes, header->file_bytes);
+    return false;
+  }
+  if (v2_checksum(binary, header->section_count) != header->checksum) {
+    printf("[WASM] navmesh v2: header checksum mismatch\n");
+    return false;
+  }
+
+  for (int i = 0; i < static_cast<int>(NAV_SECTION_COUNT); ++i) sections[i] = nullptr;
+  const NavmeshV2Section* directory = v2_directory(binary);
+  for (uint32_t i = 0; i < header->section_count; ++i) {
+    const NavmeshV2Section& s = directory[i];
+    if ((s.offset & (SIMD_ALIGNMENT - 1)) || (s.bytes & 3) || s.offset < directoryEnd ||
+        static_cast<uint64_t>(s.offset) + s.bytes > header->file_bytes) {
+      printf("[WASM] navmesh v2: section %u has a bad range\n", s.id);
+      return false;
+    }
+    if (s.id < NAV_SECTION_COUNT) sections[s.id] = &s; // newer sections are skipped
+  }
+#define X(id, member, count, words) \
+  if (!sections[id]) { printf("[WASM] navmesh v2: missing section " #member "\n"); return false; }
+  NAVMESH_RAW_SECTIONS(X)
+#undef X
+  return true;
+}
+
+} // namespace
+
+bool is_navmesh_v2(const uint8_t* binary, uint32_t bytes) {
+  uint32_t magic = 0;
+  if (bytes >= sizeof(NavmeshV2Header)) std::memcpy(&magic, binary, sizeof(magic));
+  return magic == NAVMESH_V2_MAGIC;
+}
+
+NavmeshBinaryInfo read_navmesh_binary_info(const uint8_t* binary, uint32_t bytes) {
+  NavmeshBinaryInfo info;
+  if (is_navmesh_v2(binary, bytes)) {
+    const NavmeshV2Section* sections[NAV_SECTION_COUNT];
+    if (!read_v2_sections(binary, bytes, sections)) return info;
+    const NavmeshV2Header* header = reinterpret_cast<const NavmeshV2Header*>(binary);
+    info.version = 2;
+    info.binary_bytes = header->file_bytes;
+    std::memcpy(info.bbox, header->bbox, sizeof(info.bbox));
+    info.triangles_len = static_cast<int32_t>(sections[NAV_SECTION_TRIANGLES]->bytes / 4);
+    info.buildings_len = static_cast<int32_t>(sections[NAV_SECTION_BUILDINGS]->bytes / 4);
+    info.blob_buildings_len = static_cast<int32_t>(sections[NAV_SECTION_BLOB_BUILDINGS]->bytes / 4);
+    info.walkable_triangle_count = header->walkable_triangle_count;
+    info.walkable_polygon_count = header->walkable_polygon_count;
+    info.baked_aux = true;
+#define X(id, member, count, words) info.baked_aux = info.baked_aux && sections[id];
+    NAVMESH_AUX_SECTIONS(X)
+#undef X
+    info.baked_indices = header->cell_size > 0.0f;
+#define X(id, member, count, words) info.baked_indices = info.baked_indices && sections[id];
+    NAVMESH_INDEX_SECTIONS(X)
+#undef X
+    info.baked_cell_size = info.baked_indices ? header->cell_size : 0.0f;
+    return info;
+  }
+
+  if (bytes < V1_BBOX_BYTES + V1_HEADER_FIELDS * sizeof(int32_t)) return info;
+  const int32_t* header = reinterpret_cast<const int32_t*>(binary + V1_BBOX_BYTES);
+  uint64_t binaryBytes = V1_BBOX_BYTES + V1_HEADER_FIELDS * sizeof(int32_t);
+  for (size_t i = 0; i <= 10; ++i) binaryBytes += static_cast<uint64_t>(static_cast<uint32_t>(header[i])) * 4;
+  if (binaryBytes > bytes) return info;
+  info.version = 1;
+  info.binary_bytes = static_cast<uint32_t>(binaryBytes);
+  std::memcpy(info.bbox, binary, sizeof(info.bbox));
+  info.triangles_len = header[1];
+  info.buildings_len = header[8];
+  info.blob_buildings_len = header[10];
+  info.walkable_triangle_count = header[11];
+  info.walkable_polygon_count = header[12];
+  return info;
+}
+
+bool bind_navmesh_v2(uint8_t* binary, uint32_t bytes, float cellSize, Navmesh& navmesh) {
+  const NavmeshV2Section* sections[NAV_SECTION_COUNT];
+  if (!is_navmesh_v2(binary, bytes) || !read_v2_sections(binary, bytes, sections)) return false;
+  const NavmeshV2Header* header = reinterpret_cast<const NavmeshV2Header*>(binary);
+
+  std::memcpy(navmesh.bbox, header->bbox, sizeof(navmesh.bbox));
+  std::memcpy(navmesh.buffered_bbox, header->bbox + 4, sizeof(navmesh.buffered_bbox));
+  navmesh.walkable_triangle_count = header->walkable_triangle_count;
+  navmesh.walkable_polygon_count = header->walkable_polygon_count;
+
+#define BIND(id, member, count, words) \
+  if (sections[id] && sections[id]->bytes > 0) { \
+    navmesh.member = reinterpret_cast<decltype(navmesh.member)>(binary + sections[id]->offset); \
+    navmesh.count = static_cast<decltype(navmesh.count)>(sections[id]->bytes / (4 * (words))); \
+  } else { \
+    navmesh.member = nullptr; \
+    navmesh.count = 0; \
+  }
+#define CLEAR(id, member, count, words) navmesh.member = nullptr; navmesh.count = 0;
+  NAVMESH_RAW_SECTIONS(BIND)
+  NAVMESH_AUX_SECTIONS(BIND)
+  if (header->cell_size > 0.0f && header->cell_size == cellSize) {
+    NAVMESH_INDEX_SECTIONS(BIND)
+  } else {
+    // Rebuilt by the caller; drop whatever a previous navmesh left behind.
+    NAVMESH_INDEX_SECTIONS(CLEAR)
+  }
+#undef CLEAR
+#undef BIND
+  return true;
+}
+
+void write_navmesh_v2(const Navmesh& navmesh, bool withDerived, std::vector<uint8_t>& out) {
+  struct Pending {
+    uint32_t id;
+    const void* data;
+    uint32_t bytes;
+  };
+  std::vector<Pending> pending;
+#define X(id, member, count, words) \
+  pending.push_back({id, navmesh.member, static_cast<uint32_t>(navmesh.count) * 4u * (words)});
+  NAVMESH_RAW_SECTIONS(X)
+  if (withDerived) {
+    NAVMESH_AUX_SECTIONS(X)
+    NAVMESH_INDEX_SECTIONS(X)
+  }
+#undef X
+
+  NavmeshV2Header header = {};
+  header.magic = NAVMESH_V2_MAGIC;
+  header.version = NAVMESH_V2_VERSION;
+  header.header_bytes = sizeof(NavmeshV2Header);
+  header.section_count = static_cast<uint32_t>(pending.size());
+  header.cell_size = withDerived ? navmesh.triangle_index.cellSize : 0.0f;
+  header.walkable_triangle_count = navmesh.walkable_triangle_count;
+  header.walkable_polygon_count = navmesh.walkable_polygon_count;
+  std::memcpy(header.bbox, navmesh.bbox, sizeof(navmesh.bbox));
+  std::memcpy(header.bbox + 4, navmesh.buffered_bbox, sizeof(navmesh.buffered_bbox));
+
+  std::vector<NavmeshV2Section> directory(pending.size());
+  size_t offset = alignTo(sizeof(header) + directory.size() * sizeof(NavmeshV2Section), SIMD_ALIGNMENT);
+  for (size_t i = 0; i < pending.size(); ++i) {
+    directory[i] = {pending[i].id, static_cast<uint32_t>(offset), pending[i].data ? pending[i].bytes : 0u, 0u};
+    offset = alignTo(offset + directory[i].bytes, SIMD_ALIGNMENT);
+  }
+  header.file_bytes = static_cast<uint32_t>(offset);
+
+  out.assign(offset, 0);
+  std::memcpy(out.data(), &header, sizeof(header));
+  std::memcpy(out.data() + sizeof(header), directory.data(), directory.size() * sizeof(NavmeshV2Section));
+  for (size_t i = 0; i < pending.size(); ++i) {
+    if (directory[i].bytes) std::memcpy(out.data() + directory[i].offset, pending[i].data, directory[i].bytes);
+  }
+  header.checksum = v2_checksum(out.data(), header.section_count);
+  std::memcpy(out.data(), &header, sizeof(header));
+}
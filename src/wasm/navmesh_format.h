@@ -0,0 +1,118 @@
+#ifndef NAVMESH_FORMAT_H
+#define NAVMESH_FORMAT_H
+
+#include <cstdint>
+#include <vector>
+#include "navmesh.h"
+
+// navmesh.bin formats.
+//
+// v1 (mapgen output): bbox (8 f32), 13 i32 header fields, then the raw arrays
+// back to back. Everything derived is rebuilt by init_navmesh_from_buffer.
+//
+// v2: NavmeshV2Header, a directory of section_count NavmeshV2Section entries,
+// then one 16-byte aligned section per array. The WASM side points straight
+// into the sections, so a file that carries the derived sections (centroids,
+// lookup maps and all four spatial indices, baked for cell_size) needs no
+// rebuild at startup. Missing derived sections, or indices baked for another
+// cell size, are rebuilt as for v1. All section elements are 4 bytes.
+
+const uint32_t NAVMESH_V2_MAGIC = 0x3256414E; // "NAV2"
+const uint32_t NAVMESH_V2_VERSION = 2;
+
+// X(id, member, count, words_per_item)
+//   member - Navmesh pointer the section binds to
+//   count  - Navmesh count field, in items of words_per_item 4-byte words
+// Ids are stored in files: append new sections, never reorder.
+#define NAVMESH_RAW_SECTIONS(X) \
+  X(NAV_SECTION_VERTICES, vertices, vertices_count, 1) \
+  X(NAV_SECTION_TRIANGLES, triangles, triangles_count, 1) \
+  X(NAV_SECTION_NEIGHBORS, neighbors, neighbors_count, 1) \
+  X(NAV_SECTION_POLYGONS, polygons, polygons_count, 1) \
+  X(NAV_SECTION_POLY_CENTROIDS, poly_centroids, poly_centroids_count, 1) \
+  X(NAV_SECTION_POLY_VERTS, poly_verts, poly_verts_count, 1) \
+  X(NAV_SECTION_POLY_TRIS, poly_tris, poly_tris_count, 1) \
+  X(NAV_SECTION_POLY_NEIGHBORS, poly_neighbors, poly_neighbors_count, 1) \
+  X(NAV_SECTION_BUILDINGS, buildings, buildings_count, 1) \
+  X(NAV_SECTION_BUILDING_VERTS, building_verts, building_verts_count, 1) \
+  X(NAV_SECTION_BLOB_BUILDINGS, blob_buildings, blob_buildings_count, 1)
+
+// Independent of the spatial index cell size.
+#define NAVMESH_AUX_SECTIONS(X) \
+  X(NAV_SECTION_TRIANGLE_CENTROIDS, triangle_centroids, triangle_centroids_count, 2) \
+  X(NAV_SECTION_TRIANGLE_TO_POLYGON, triangle_to_polygon, triangle_to_polygon_count, 1) \
+  X(NAV_SECTION_BUILDING_TO_BLOB, building_to_blob, building_to_blob_count, 1)
+
+// Valid only for NavmeshV2Header::cell_size.
+#define NAVMESH_INDEX_SECTIONS(X) \
+  X(NAV_SECTION_TRI_INDEX_OFFSETS, triangle_index.cellOffsets, triangle_index.cellOffsetsCount, 1) \
+  X(NAV_SECTION_TRI_INDEX_ITEMS, triangle_index.cellItems, triangle_index.cellItemsCount, 1) \
+  X(NAV_SECTION_POLY_INDEX_OFFSETS, polygon_index.cellOffsets, polygon_index.cellOffsetsCount, 1) \
+  X(NAV_SECTION_POLY_INDEX_ITEMS, polygon_index.cellItems, polygon_index.cellItemsCount, 1) \
+  X(NAV_SECTION_BUILDING_INDEX_OFFSETS, building_index.cellOffsets, building_index.cellOffsetsCount, 1) \
+  X(NAV_SECTION_BUILDING_INDEX_ITEMS, building_index.cellItems, building_index.cellItemsCount, 1) \
+  X(NAV_SECTION_BLOB_INDEX_OFFSETS, blob_index.cellOffsets, blob_index.cellOffsetsCount, 1) \
+  X(NAV_SECTION_BLOB_INDEX_ITEMS, blob_index.cellItems, blob_index.cellItemsCount, 1)
+
+#define NAVMESH_SECTIONS(X) \
+  NAVMESH_RAW_SECTIONS(X) \
+  NAVMESH_AUX_SECTIONS(X) \
+  NAVMESH_INDEX_SECTIONS(X)
+
+enum NavmeshSectionId : uint32_t {
+#define X(id, member, count, words) id,
+  NAVMESH_SECTIONS(X)
+#undef X
+  NAV_SECTION_COUNT
+};
+
+struct NavmeshV2Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t header_bytes;     // sizeof(NavmeshV2Header)
+  uint32_t section_count;
+  uint32_t file_bytes;
+  uint32_t checksum;         // FNV-1a of header (this field zeroed) + directory
+  float cell_size;           // cell size the index sections were built for, 0 if none
+  int32_t walkable_triangle_count;
+  int32_t walkable_polygon_count;
+  float bbox[8];             // real minX, minY, maxX, maxY, then the buffered bbox
+  uint32_t reserved[3];
+};
+
+struct NavmeshV2Section {
+  uint32_t id;               // NavmeshSectionId
+  uint32_t offset;           // from the file start, multiple of 16
+  uint32_t bytes;
+  uint32_t reserved;
+};
+
+// What init_navmesh_from_buffer needs to size its memory, for either format.
+struct NavmeshBinaryInfo {
+  int version = 0;           // 0 if unrecognized/corrupt
+  uint32_t binary_bytes = 0;
+  float bbox[8] = {};
+  int32_t triangles_len = 0;
+  int32_t buildings_len = 0;
+  int32_t blob_buildings_len = 0;
+  int32_t walkable_triangle_count = 0;
+  int32_t walkable_polygon_count = 0;
+  bool baked_aux = false;    // all NAVMESH_AUX_SECTIONS present
+  bool baked_indices = false; // all NAVMESH_INDEX_SECTIONS present
+  float baked_cell_size = 0.0f;
+};
+
+bool is_navmesh_v2(const uint8_t* binary, uint32_t bytes);
+
+// Parses and validates the header (and for v2 the directory and checksum).
+NavmeshBinaryInfo read_navmesh_binary_info(const uint8_t* binary, uint32_t bytes);
+
+// Points navmesh at the sections of a validated v2 binary. Raw sections are
+// required; derived ones that are absent are left nullptr for the caller to
+// build. Index sections are bound only if cellSize matches the baked one.
+bool bind_navmesh_v2(uint8_t* binary, uint32_t bytes, float cellSize, Navmesh& navmesh);
+
+// Serializes navmesh as v2. withDerived adds the aux and index sections.
+void write_navmesh_v2(const Navmesh& navmesh, bool withDerived, std::vector<uint8_t>& out);
+
+#endif // NAVMESH_FORMAT_H
@@ -0,0 +1,393 @@
+#include "microbench.h"
+#include "agent_collision.h"
+#include "agent_grid.h"
+#include "constants_layout.h"
+#include "nav_constants.h"
+#include "nav_utils.h"
+#include "navmesh.h"
+#include "path_corners.h"
+#include "path_corridor.h"
+#include "raycasting.h"
+#include "sim_driver.h"
+#include "sprite_instances.h"
+#include <stdio.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <tuple>
+
+extern Navmesh g_navmesh;
+extern AgentSoA agent_data;
+extern AgentGridData agent_grid;
+
+// Microbenchmarks for the navmesh kernels the simulation spends its time in.
+// Run with WasmImpulse::MICROBENCH_SUITE or `sim_runner --microbench all`.
+
+namespace {
+
+const int POINT_COUNT = 65536;
+const int RAY_COUNT = 8192;
+const int PATH_COUNT = 128;
+const int COLLISION_AGENTS = 20000;
+const int SPRITE_AGENTS = 36100;  // MAX_AGENTS in Agents.ts
+const int SPRITE_FRAMES = 24;
+const int CULL_AGENTS = 50000;
+const float CULL_FIELD = 8192.0f;
+
+std::vector<Point2> g_points;
+std::vector<int> g_tris;
+std::vector<MicrobenchRay> g_rays;
+std::vector<std::vector<int>> g_corridors;
+std::vector<int> g_scratch_corridor;
+NavConstants g_nc;
+
+bool constants_ready() {
+#ifdef NAV_CONSTANTS_BAKED
+  return true;
+#else
+  return g_constants_buffer != nullptr;
+#endif
+}
+
+void release_inputs() {
+  std::vector<Point2>().swap(g_points);
+  std::vector<int>().swap(g_tris);
+  std::vector<MicrobenchRay>().swap(g_rays);
+  std::vector<std::vector<int>>().swap(g_corridors);
+  std::vector<int>().swap(g_scratch_corridor);
+}
+
+// SpatialIndex::query over the whole bbox, including cells with no triangles.
+bool setup_spatial_query(uint64_t seed) {
+  g_points = sample_bbox_points(POINT_COUNT, seed);
+  return true;
+}
+
+uint32_t run_spatial_query() {
+  size_t found = 0;
+  for (const Point2& p : g_points) found += g_navmesh.triangle_index.query(p).size();
+  do_not_optimize(found);
+  return static_cast<uint32_t>(g_points.size());
+}
+
+MICROBENCH(spatial_index_query, setup_spatial_query, run_spatial_query, release_inputs);
+
+// is_point_in_navmesh without a hint, over walkable and blocked points alike.
+uint32_t run_point_in_navmesh_cold() {
+  uint32_t hits = 0;
+  for (const Point2& p : g_points) hits += is_point_in_navmesh(p, -1) != -1;
+  do_not_optimize(hits);
+  return static_cast<uint32_t>(g_points.size());
+}
+
+MICROBENCH(is_point_in_navmesh_cold, setup_spatial_query, run_point_in_navmesh_cold, release_inputs);
+
+// is_point_in_navmesh with the previous triangle as hint, like moving agents.
+bool setup_point_in_navmesh_hinted(uint64_t seed) {
+  sample_walkable_points(POINT_COUNT, seed, g_points, g_tris);
+  return true;
+}
+
+uint32_t run_point_in_navmesh_hinted() {
+  uint32_t sum = 0;
+  for (size_t i = 0; i < g_points.size(); ++i) sum += is_point_in_navmesh(g_points[i], g_tris[i]);
+  do_not_optimize(sum);
+  return static_cast<uint32_t>(g_points.size());
+}
+
+MICROBENCH(is_point_in_navmesh_hinted, setup_point_in_navmesh_hinted, run_point_in_navmesh_hinted, release_inputs);
+
+bool setup_rays(uint64_t seed) {
+  g_rays = sample_rays(RAY_COUNT, 4.0f * g_navmesh.triangle_index.cellSize, seed);
+  return true;
+}
+
+uint32_t run_raycast_point() {
+  uint32_t visible = 0;
+  for (const MicrobenchRay& r : g_rays) {
+    const auto hit = raycastPoint(r.start, r.end, r.startTri, r.endTri);
+    visible += std::get<2>(hit);
+    do_not_optimize(hit);
+  }
+  do_not_optimize(visible);
+  return static_cast<uint32_t>(g_rays.size());
+}
+
+MICROBENCH(raycast_point, setup_rays, run_raycast_point, release_inputs);
+
+uint32_t run_raycast_corridor() {
+  size_t tris = 0;
+  for (const MicrobenchRay& r : g_rays) tris += raycastCorridor(r.start, r.end, r.startTri, r.endTri).corridor.size();
+  do_not_optimize(tris);
+  return static_cast<uint32_t>(g_rays.size());
+}
+
+MICROBENCH(raycast_corridor, setup_rays, run_raycast_corridor, release_inputs);
+
+// Start/end pairs anywhere on the walkable area; g_points holds them interleaved.
+bool setup_paths(uint64_t seed) {
+  if (!constants_ready()) return false;
+  g_nc = load_nav_constants();
+  sample_walkable_points(PATH_COUNT * 2, seed, g_points, g_tris);
+  return true;
+}
+
+uint32_t run_find_corridor() {
+  size_t polys = 0;
+  for (int i = 0; i < PATH_COUNT; ++i) {
+    const int startPoly = g_navmesh.triangle_to_polygon[g_tris[i * 2]];
+    const int endPoly = g_navmesh.triangle_to_polygon[g_tris[i * 2 + 1]];
+    findCorridor(g_navmesh, g_nc.path_free_width, g_nc.path_width_penalty_mult, g_nc.congestion_cost_mult, g_points[i * 2], g_points[i * 2 + 1],
+                 g_scratch_corridor, startPoly, endPoly);
+    polys += g_scratch_corridor.size();
+  }
+  do_not_optimize(polys);
+  return PATH_COUNT;
+}
+
+MICROBENCH(find_corridor, setup_paths, run_find_corridor, release_inputs);
+
+// find_next_corner from the start of precomputed corridors.
+bool setup_next_corner(uint64_t seed) {
+  if (!setup_paths(seed)) return false;
+  g_corridors.assign(PATH_COUNT, std::vector<int>());
+  for (int i = 0; i < PATH_COUNT; ++i) {
+    findCorridor(g_navmesh, g_nc.path_free_width, g_nc.path_width_penalty_mult, g_nc.congestion_cost_mult, g_points[i * 2], g_points[i * 2 + 1],
+                 g_corridors[i]);
+  }
+  return true;
+}
+
+uint32_t run_next_corner() {
+  uint32_t corners = 0;
+  for (int i = 0; i < PATH_COUNT; ++i) {
+    if (g_corridors[i].empty()) continue;
+    const DualCorner c = find_next_corner(g_points[i * 2], g_corridors[i], g_points[i * 2 + 1], g_nc.corner_offset);
+    corners += c.numValid;
+    do_not_optimize(c);
+  }
+  do_not_optimize(corners);
+  return PATH_COUNT;
+}
+
+MICROBENCH(find_next_corner, setup_next_corner, run_next_corner, release_inputs);
+
+// One update_agent_collisions pass over a dense crowd indexed once in setup.
+// Only velocities change between repetitions, so every pass sees the same pairs.
+ScopedAgentSet* g_collision_agents = nullptr;
+
+bool setup_collisions(uint64_t seed) {
+  if (agent_grid.cell_counts.empty()) return false;
+  g_collision_agents = new ScopedAgentSet(COLLISION_AGENTS);
+  const AgentSpawnParams params;
+  for (int i = 0; i < COLLISION_AGENTS; ++i) {
+    const int tri = random_triangle_in_area({0.0f, 0.0f}, 8.0f, &seed);
+    if (tri == -1) return false;
+    spawn_agent(i, random_point_in_triangle(tri, &seed), params);
+  }
+  clear_and_reindex_grid(COLLISION_AGENTS);
+  return true;
+}
+
+uint32_t run_collisions() {
+  update_agent_collisions(COLLISION_AGENTS);
+  return COLLISION_AGENTS;
+}
+
+void teardown_collisions() {
+  delete g_collision_agents;
+  g_collision_agents = nullptr;
+}
+
+MICROBENCH(agent_collisions, setup_collisions, run_collisions, teardown_collisions);
+
+// The renderer's CPU stage over a full crowd with mixed frame ids and ~10%
+// dead agents. Setup also checks the ordering the single draw relies on.
+std::vector<float> g_sprite_xy;
+std::vector<Point2> g_sprite_looks;
+std::vector<uint16_t> g_sprite_frames;
+std::vector<uint8_t> g_sprite_alive;
+SpriteInstanceBuilder* g_sprite_builder = nullptr;
+
+SpriteSource sprite_source() {
+  return {g_sprite_xy.data(), g_sprite_xy.data() + SPRITE_AGENTS, g_sprite_looks.data(), g_sprite_frames.data(),
+          g_sprite_alive.data(), SPRITE_AGENTS};
+}
+
+bool setup_sprite_instances(uint64_t seed) {
+  const std::vector<Point2> points = sample_bbox_points(SPRITE_AGENTS, seed);
+  g_sprite_xy.resize(SPRITE_AGENTS * 2);
+  g_sprite_looks.resize(SPRITE_AGENTS);
+  g_sprite_frames.resize(SPRITE_AGENTS);
+  g_sprite_alive.resize(SPRITE_AGENTS);
+  int alive = 0;
+  for (int i = 0; i < SPRITE_AGENTS; ++i) {
+    g_sprite_xy[i] = points[i].x;
+    g_sprite_xy[SPRITE_AGENTS + i] = points[i].y;
+    g_sprite_looks[i] = {std::cos(i * 0.37f), std::sin(i * 0.37f)};
+    g_sprite_frames[i] = static_cast<uint16_t>((i * 7919u) % SPRITE_FRAMES);
+    g_sprite_alive[i] = (i % 10) != 3;
+    alive += g_sprite_alive[i];
+  }
+  g_sprite_builder = new SpriteInstanceBuilder();
+  const int count = g_sprite_builder->build(sprite_source(), SPRITE_FRAMES);
+  const SpriteInstance* inst = g_sprite_builder->instances();
+  bool ordered = count == alive;
+  for (int i = 1; i < count && ordered; ++i) ordered = inst[i - 1].frame <= inst[i].frame;
+  for (int f = 0; f < SPRITE_FRAMES && ordered; ++f) {
+    const uint32_t start = g_sprite_builder->frame_start(f);
+    ordered = start == g_sprite_builder->frame_start(f + 1) || inst[start].frame == static_cast<uint32_t>(f);
+  }
+  if (!ordered) printf("[WASM] microbench: sprite instances are not sorted by frame id\n");
+  return ordered;
+}
+
+uint32_t run_sprite_instances() {
+  const int count = g_sprite_builder->build(sprite_source(), SPRITE_FRAMES);
+  do_not_optimize(count);
+  return SPRITE_AGENTS;
+}
+
+void teardown_sprite_instances() {
+  delete g_sprite_builder;
+  g_sprite_builder = nullptr;
+  std::vector<float>().swap(g_sprite_xy);
+  std::vector<Point2>().swap(g_sprite_looks);
+  std::vector<uint16_t>().swap(g_sprite_frames);
+  std::vector<uint8_t>().swap(g_sprite_alive);
+}
+
+MICROBENCH(sprite_instances, setup_sprite_instances, run_sprite_instances, teardown_sprite_instances);
+
+// The packing kernel alone over the same crowd's alive agents, in agent
+// order as the builder packs them before sorting. Setup checks the simd4 kernel against the
+// scalar reference; *_scalar times the reference.
+std::vector<int> g_pack_order;
+std::vector<SpriteInstance> g_pack_out;
+SpriteQuantization g_pack_quantization;
+
+bool setup_sprite_pack(uint64_t seed) {
+  if (!setup_sprite_instances(seed)) return false;
+  for (int i = 0; i < SPRITE_AGENTS; ++i) {
+    if (g_sprite_alive[i]) g_pack_order.push_back(i);
+  }
+  const float* bbox = g_navmesh.bbox;
+  g_pack_quantization = sprite_quantization({bbox[0], bbox[1], bbox[2], bbox[3]});
+  const int count = static_cast<int>(g_pack_order.size());
+  std::vector<SpriteInstance> reference(count);
+  g_pack_out.resize(count);
+  pack_sprite_instances(sprite_source(), g_pack_order.data(), count, g_pack_quantization, g_pack_out.data());
+  pack_sprite_instances_scalar(sprite_source(), g_pack_order.data(), count, g_pack_quantization, reference.data());
+  // -ffast-math may round the two versions' rotation differently by one step
+  // when it lands on a half; everything else must match exactly.
+  int mismatches = 0;
+  for (int k = 0; k < count; ++k) {
+    const SpriteInstance& a = g_pack_out[k];
+    const SpriteInstance& b = reference[k];
+    mismatches += a.x != b.x || a.y != b.y || a.frame != b.frame || std::abs(a.cosv - b.cosv) > 1 || std::abs(a.sinv - b.sinv) > 1;
+  }
+  if (mismatches > 0) printf("[WASM] microbench: %d of %d packed sprites differ from the scalar reference\n", mismatches, count);
+  return mismatches == 0;
+}
+
+uint32_t run_sprite_pack() {
+  pack_sprite_instances(sprite_source(), g_pack_order.data(), static_cast<int>(g_pack_order.size()), g_pack_quantization, g_pack_out.data());
+  do_not_optimize(g_pack_out[0]);
+  return static_cast<uint32_t>(g_pack_order.size());
+}
+
+uint32_t run_sprite_pack_scalar() {
+  pack_sprite_instances_scalar(sprite_source(), g_pack_order.data(), static_cast<int>(g_pack_order.size()), g_pack_quantization, g_pack_out.data());
+  do_not_optimize(g_pack_out[0]);
+  return static_cast<uint32_t>(g_pack_order.size());
+}
+
+void teardown_sprite_pack() {
+  teardown_sprite_instances();
+  std::vector<int>().swap(g_pack_order);
+  std::vector<SpriteInstance>().swap(g_pack_out);
+}
+
+MICROBENCH(sprite_pack, setup_sprite_pack, run_sprite_pack, teardown_sprite_pack);
+MICROBENCH(sprite_pack_scalar, setup_sprite_pack, run_sprite_pack_scalar, teardown_sprite_pack);
+
+// The culled build at 50k agents spread over a CULL_FIELD-wide square (the
+// synthetic navmesh is too small to hold them within the per-cell cap), with
+// the view centred and zoomed in 1x, 4x and 16x. Culling only reads
+// positions, so the agents are written straight into a scoped agent set for
+// agent_grid to index; the *_scan variant skips the grid to show what it
+// saves. Setup checks the grid and the plain rect test pick the same agents.
+ScopedAgentSet* g_cull_agents = nullptr;
+SpriteInstanceBuilder* g_cull_builder = nullptr;
+
+SpriteSource cull_source() {
+  return {agent_data.positions.x, agent_data.positions.y, agent_data.looks, agent_data.frame_ids,
+          reinterpret_cast<const uint8_t*>(agent_data.is_alive), CULL_AGENTS};
+}
+
+// The rect render() derives from a camera centred on the origin.
+BoundingBox cull_view(float zoom) {
+  const float s = 2.0f * zoom / CULL_FIELD;
+  const float m3x3[9] = {s, 0.0f, 0.0f, 0.0f, s, 0.0f, 0.0f, 0.0f, 1.0f};
+  BoundingBox view = {0.0f, 0.0f, 0.0f, 0.0f};
+  sprite_view_rect(m3x3, 2.0f * 2.5f, &view);
+  return view;
+}
+
+bool setup_sprite_cull(uint64_t seed) {
+  if (agent_grid.cell_counts.empty()) return false;
+  const std::vector<Point2> points = sample_bbox_points(CULL_AGENTS, seed);
+  const float* bbox = g_navmesh.bbox;
+  const float sx = CULL_FIELD / (bbox[2] - bbox[0]);
+  const float sy = CULL_FIELD / (bbox[3] - bbox[1]);
+  g_cull_agents = new ScopedAgentSet(CULL_AGENTS);
+  for (int i = 0; i < CULL_AGENTS; ++i) {
+    agent_data.positions[i] = {(points[i].x - bbox[0]) * sx - 0.5f * CULL_FIELD, (points[i].y - bbox[1]) * sy - 0.5f * CULL_FIELD};
+    agent_data.looks[i] = {std::cos(i * 0.37f), std::sin(i * 0.37f)};
+    agent_data.frame_ids[i] = static_cast<uint16_t>((i * 7919u) % SPRITE_FRAMES);
+    agent_data.is_alive[i] = (i % 10) != 3;
+  }
+  clear_and_reindex_grid(CULL_AGENTS);
+  if (agent_grid.overflowed) {
+    printf("[WASM] microbench: sprite cull crowd overflows agent_grid cells\n");
+    return false;
+  }
+  g_cull_builder = new SpriteInstanceBuilder();
+  SpriteInstanceBuilder scan;
+  for (float zoom : {1.0f, 4.0f, 16.0f}) {
+    const BoundingBox view = cull_view(zoom);
+    const int viaGrid = g_cull_builder->build(cull_source(), SPRITE_FRAMES, &view, &agent_grid);
+    const int viaScan = scan.build(cull_source(), SPRITE_FRAMES, &view, nullptr);
+    if (viaGrid != viaScan) {
+      printf("[WASM] microbench: sprite cull at zoom %.0f keeps %d agents via the grid, %d via the scan\n", zoom, viaGrid, viaScan);
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t run_sprite_cull(float zoom, bool useGrid) {
+  const BoundingBox view = cull_view(zoom);
+  const int count = g_cull_builder->build(cull_source(), SPRITE_FRAMES, &view, useGrid ? &agent_grid : nullptr);
+  do_not_optimize(count);
+  return CULL_AGENTS;
+}
+
+uint32_t run_sprite_cull_zoom1() { return run_sprite_cull(1.0f, true); }
+uint32_t run_sprite_cull_zoom4() { return run_sprite_cull(4.0f, true); }
+uint32_t run_sprite_cull_zoom16() { return run_sprite_cull(16.0f, true); }
+uint32_t run_sprite_cull_zoom16_scan() { return run_sprite_cull(16.0f, false); }
+
+void teardown_sprite_cull() {
+  delete g_cull_builder;
+  g_cull_builder = nullptr;
+  delete g_cull_agents;
+  g_cull_agents = nullptr;
+}
+
+MICROBENCH(sprite_cull_zoom1, setup_sprite_cull, run_sprite_cull_zoom1, teardown_sprite_cull);
+MICROBENCH(sprite_cull_zoom4, setup_sprite_cull, run_sprite_cull_zoom4, teardown_sprite_cull);
+MICROBENCH(sprite_cull_zoom16, setup_sprite_cull, run_sprite_cull_zoom16, teardown_sprite_cull);
+MICROBENCH(sprite_cull_zoom16_scan, setup_sprite_cull, run_sprite_cull_zoom16_scan, teardown_sprite_cull);
+
+} // namespace
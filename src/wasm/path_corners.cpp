@@ -2,6 +2,8 @@
 #include "math_utils.h"
 #include "navmesh.h"
 #include "nav_utils.h"
+#include "trace_log.h"
+#include "nav_telemetry.h"
 #include <vector>
 #include <algorithm>
 
@@ -92,6 +94,7 @@ std::vector<Corner> findCorners(const std::vector<int>& corridor, const Point2&
 
 DualCorner find_next_corner(Point2 pos, const std::vector<int>& corridor, Point2 end_pos, float offset) {
   DualCorner result = {{0,0}, -1, -1, {0,0}, -1, -1, 0};
+  NAV_COUNT(corner_recomputes);
   
   if (corridor.empty()) {
     result.corner1 = end_pos;
@@ -376,14 +379,9 @@ static void apply_offset_to_point(Point2& point, int vIdx, int tri, const Point2
   
   // Add grid corner check and warning if blob not found
   if (!foundBlob) {
-    printf("apply_offset_to_point: FAILURE - Could not find matching blob for corner, not applying offset. Point: (%.3f, %.3f)\n", 
-         point.x, point.y);
-    printf("apply_offset_to_point: Nearby blobs were: ");
-    for (int blobId : nearbyBlobs) {
-      printf("%d ", blobId);
-    }
-    printf("\n");
-    
+    TRACE_WARN(TRACE_CORNER_BLOB_NOT_FOUND, -1, point.x, point.y, static_cast<int32_t>(nearbyBlobs.size()));
+  }
+  if (!foundBlob && TRACE_ENABLED(TRACE_LEVEL_DEBUG)) {
     // Debug: Find the closest vertex across all blobs
     float minDist = 999999.0f;
     Point2 closestVertex = {0, 0};
@@ -405,7 +403,6 @@ static void apply_offset_to_point(Point2& point, int vIdx, int tri, const Point2
       }
     }
     
-    printf("apply_offset_to_point: DEBUG - Closest vertex found at (%.3f, %.3f) in blob %d, distance=%.6f (tolerance=0.015)\n", 
-         closestVertex.x, closestVertex.y, closestBlob, minDist);
+    TRACE_DEBUG(TRACE_CORNER_BLOB_CLOSEST, -1, closestVertex.x, closestVertex.y, closestBlob, minDist);
   }
 } 
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include "nav_utils.h"
 #include "fast_priority_queue.h"
 #include "constants_layout.h"
+#include "trace_log.h"
+#include "nav_telemetry.h"
+#include "poly_congestion.h"
 #include <algorithm>
 #include <iostream>
 #include <iomanip>
@@ -11,18 +14,32 @@
 // Global state dependencies
 extern Navmesh g_navmesh;
 
-// Pre-allocated A* data structures for reuse
-static FastPriorityQueue openSet;
-static int32_t* cameFrom_parent = nullptr;
-static float* gScore = nullptr;
-static float* heuristic = nullptr;
-static int array_size = 0;
-static bool astar_initialized = false;
+// The simulation thread's A* scratch, reused across searches
+static PathSearchContext g_search;
+
+#define CTX_COUNT_ADD(member, n) NAV_COUNT_ADD_TO(*ctx.counters, member, n)
+#define CTX_COUNT(member) CTX_COUNT_ADD(member, 1)
 
 bool findCorridor(
   Navmesh& navmesh,
   float FREE_WIDTH,
   float STRAY_MULT,
+  float CONGESTION_MULT,
+  const Point2& startPoint,
+  const Point2& endPoint,
+  std::vector<int>& outCorridor,
+  int startPolyHint,
+  int endPolyHint
+) {
+  return findCorridor(g_search, navmesh, FREE_WIDTH, STRAY_MULT, CONGESTION_MULT, startPoint, endPoint, outCorridor, startPolyHint, endPolyHint);
+}
+
+bool findCorridor(
+  PathSearchContext& ctx,
+  Navmesh& navmesh,
+  float FREE_WIDTH,
+  float STRAY_MULT,
+  float CONGESTION_MULT,
   const Point2& startPoint,
   const Point2& endPoint,
   std::vector<int>& outCorridor,
@@ -32,8 +49,10 @@ bool findCorridor(
   const int startPoly = (startPolyHint != -1) ? startPolyHint : getPolygonFromPoint(startPoint);
   const int endPoly = (endPolyHint != -1) ? endPolyHint : getPolygonFromPoint(endPoint);
 
+  CTX_COUNT(astar_calls);
   if (startPoly == -1 || endPoly == -1) {
-    std::cout << "[WA] findCorridor: FAILED - invalid polygons" << std::endl;
+    CTX_COUNT(astar_invalid_polys);
+    if (ctx.sim_thread) TRACE_WARN(TRACE_CORRIDOR_INVALID_POLYS, -1, startPoly, endPoly);
     return false;
   }
 
@@ -45,16 +64,19 @@ bool findCorridor(
 
   const int numWalkablePolys = g_navmesh.walkable_polygon_count;
 
-  if (!astar_initialized) {
-    openSet.reserve(256);
-    array_size = numWalkablePolys;
-    cameFrom_parent = new int32_t[array_size];
-    gScore = new float[array_size];
-    heuristic = new float[array_size];
-    astar_initialized = true;
-  } else {
-    openSet.clear();
+  // Grows when a larger navmesh is loaded (headless runs switch navmeshes).
+  if (ctx.cameFrom.size() < static_cast<size_t>(numWalkablePolys)) {
+    ctx.cameFrom.resize(numWalkablePolys);
+    ctx.gScore.resize(numWalkablePolys);
+    ctx.heuristic.resize(numWalkablePolys);
+    ctx.openSet.reserve(256);
   }
+  ctx.openSet.clear();
+  FastPriorityQueue& openSet = ctx.openSet;
+  int32_t* cameFrom_parent = ctx.cameFrom.data();
+  float* gScore = ctx.gScore.data();
+  float* heuristic = ctx.heuristic.data();
+  const int array_size = static_cast<int>(ctx.cameFrom.size());
   
   std::fill(cameFrom_parent, cameFrom_parent + array_size, -1);
   const float kUnknown = std::numeric_limits<float>::lowest();
@@ -78,7 +100,9 @@ bool findCorridor(
   while (!openSet.empty()) {
     iterations++;
     if (iterations > 100000) {
-      std::cout << "[WA] findCorridor: FAILED - iteration limit reached" << std::endl;
+      CTX_COUNT(astar_iteration_cap);
+      CTX_COUNT_ADD(astar_nodes_expanded, iterations);
+      if (ctx.sim_thread) TRACE_WARN(TRACE_CORRIDOR_ITERATION_LIMIT, -1, startPoly, endPoly, iterations);
       return false;
     }
     
@@ -93,6 +117,7 @@ bool findCorridor(
         outCorridor.push_back(temp);
       }
       // std::cout << "[WA] " << iterations << " iterations" << std::endl;
+      CTX_COUNT_ADD(astar_nodes_expanded, iterations);
       return true;
     }
 
@@ -110,7 +135,11 @@ bool findCorridor(
       }
 
       const Point2 neighborCentroid = g_navmesh.poly_centroids[neighbor];
-      const float travelCost = math::distance(currentCentroid, neighborCentroid);
+      float travelCost = math::distance(currentCentroid, neighborCentroid);
+      if (CONGESTION_MULT > 0.0f) {
+        const float crowding = ctx.sim_thread ? poly_congestion(neighbor) : poly_congestion(ctx.crowding, neighbor);
+        travelCost *= 1.0f + CONGESTION_MULT * crowding / (1.0f + crowding);
+      }
       const float tentativeGScore = travelCost + myScore;
 
       const bool neighborHasScore = (gScore[neighbor] != kUnknown);
@@ -157,6 +186,8 @@ bool findCorridor(
     }
   }
 
-  std::cout << "[WA] findCorridor: FAILED - no path found after " << iterations << " iterations" << std::endl;
+  CTX_COUNT(astar_no_path);
+  CTX_COUNT_ADD(astar_nodes_expanded, iterations);
+  if (ctx.sim_thread) TRACE_WARN(TRACE_CORRIDOR_NO_PATH, -1, startPoly, endPoly, iterations);
   return false;
 } 
\ No newline at end of file
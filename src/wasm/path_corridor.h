@@ -3,12 +3,47 @@
 
 #include "data_structures.h"
 #include "navmesh.h"
+#include "fast_priority_queue.h"
+#include "nav_telemetry.h"
 #include <vector>
 
+// CONGESTION_MULT > 0 makes crowded polygons dearer to enter
+// (poly_congestion.h); 0 searches plain distances.
+
+// A* scratch for one thread. findCorridor without a context uses the
+// simulation thread's; every path worker owns one (path_workers.h), and so do
+// the batched queries (nav_batch.h).
+struct PathSearchContext {
+  FastPriorityQueue openSet;
+  std::vector<int32_t> cameFrom;
+  std::vector<float> gScore;
+  std::vector<float> heuristic;
+  NavCounters* counters = &g_nav_frame;
+  // Worker searches do not trace.
+  bool sim_thread = true;
+  // Crowding for searches off the simulation thread (poly_congestion.h);
+  // null searches without congestion. The simulation thread reads the layer.
+  const std::vector<float>* crowding = nullptr;
+};
+
+bool findCorridor(
+  PathSearchContext& ctx,
+  Navmesh& navmesh,
+  float FREE_WIDTH,
+  float STRAY_MULT,
+  float CONGESTION_MULT,
+  const Point2& startPoint,
+  const Point2& endPoint,
+  std::vector<int>& outCorridor,
+  int startPolyHint = -1,
+  int endPolyHint = -1
+);
+
 bool findCorridor(
   Navmesh& navmesh,
   float FREE_WIDTH,
   float STRAY_MULT,
+  float CONGESTION_MULT,
   const Point2& startPoint,
   const Point2& endPoint,
   std::vector<int>& outCorridor,
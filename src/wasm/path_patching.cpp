@@ -4,6 +4,7 @@
 #include "path_corridor.h"
 #include "constants_layout.h"
 #include "math_utils.h"
+#include "nav_telemetry.h"
 #include <algorithm>
  
 
@@ -105,7 +106,8 @@ bool attempt_path_patch(
   int hitV1_idx,
   int hitV2_idx,
   int hitTri_idx,
-  const std::vector<int>& raycastTriCorridor
+  const std::vector<int>& raycastTriCorridor,
+  const NavConstants& nc
 ) {
   if (raycastTriCorridor.empty()) return false;
 
@@ -128,7 +130,7 @@ bool attempt_path_patch(
 
     if (chosenVIdx != -1) {
       Point2 offsetPoint;
-      if (compute_corner_miter_offset(blockingPoly, chosenVIdx, chosenCornerPoint, CORNER_OFFSET, offsetPoint)) {
+      if (compute_corner_miter_offset(blockingPoly, chosenVIdx, chosenCornerPoint, nc.corner_offset, offsetPoint)) {
         const int offsetTri = getTriangleFromPoint(offsetPoint);
         if (offsetTri != -1) {
           RaycastCorridorResult rc1 = raycastCorridor(agent_data.positions[idx], offsetPoint, agent_data.current_tris[idx], offsetTri);
@@ -150,6 +152,7 @@ bool attempt_path_patch(
                   std::vector<int> merged;
                   // IMPORTANT: rejoin at old nextCorner, not nextCorner2
                   if (merge_corridors(rc2.corridor, rc1.corridor, agent_data.corridors[idx], oldNextCornerTri, merged)) {
+                    NAV_COUNT(patch_miter_ok);
                     agent_data.corridors[idx] = std::move(merged);
                     return true;
                   }
@@ -160,6 +163,7 @@ bool attempt_path_patch(
                 agent_data.next_corner_tris[idx] = offsetTri;
                 std::vector<int> merged;
                 if (merge_corridors(rc3.corridor, rc1.corridor, agent_data.corridors[idx], agent_data.next_corner_tris2[idx], merged)) {
+                  NAV_COUNT(patch_miter_ok);
                   agent_data.corridors[idx] = std::move(merged);
                   return true;
                 }
@@ -176,6 +180,7 @@ bool attempt_path_patch(
 
                 std::vector<int> merged;
                 if (merge_corridors(rc2.corridor, rc1.corridor, agent_data.corridors[idx], agent_data.next_corner_tris2[idx], merged)) {
+                  NAV_COUNT(patch_miter_ok);
                   agent_data.corridors[idx] = std::move(merged);
                   return true;
                 }
@@ -185,6 +190,7 @@ bool attempt_path_patch(
         }
       }
     }
+    NAV_COUNT(patch_miter_fail);
   }
 
   // Approach 1: Intersection-based patch
@@ -219,6 +225,7 @@ bool attempt_path_patch(
 
               std::vector<int> merged;
               if (merge_corridors(rc2.corridor, rc1.corridor, agent_data.corridors[idx], agent_data.next_corner_tris2[idx], merged)) {
+                NAV_COUNT(patch_intersection_ok);
                 agent_data.corridors[idx] = std::move(merged);
                 return true;
               }
@@ -229,5 +236,6 @@ bool attempt_path_patch(
     }
   }
 
+  NAV_COUNT(patch_intersection_fail);
   return false;
 } 
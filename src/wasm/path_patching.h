@@ -3,6 +3,7 @@
 
 #include "data_structures.h"
 #include "navmesh.h"
+#include "nav_constants.h"
 #include <vector>
 
 // Attempts multi-approach geometric path patching when a direct raycast fails.
@@ -13,7 +14,8 @@ bool attempt_path_patch(
   int hitV1_idx,
   int hitV2_idx,
   int hitTri_idx,
-  const std::vector<int>& raycastTriCorridor
+  const std::vector<int>& raycastTriCorridor,
+  const NavConstants& nc
 );
 
 #endif // PATH_PATCHING_H 
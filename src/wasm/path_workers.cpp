@@ -0,0 +1,184 @@
+#include "path_workers.h"
+#include "path_corridor.h"
+#include "agent_nav_utils.h"
+#include "data_structures.h"
+#include "event_buffer.h"
+#include "event_handler.h"
+#include "nav_utils.h"
+#include "nav_telemetry.h"
+#include "poly_congestion.h"
+#include "sim_thread.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern AgentSoA agent_data;
+extern Navmesh g_navmesh;
+
+namespace {
+
+struct PathJob {
+  PathRequest request;
+  CongestionSnapshot crowding;  // as of submit
+  uint32_t batch;
+  bool done = false;
+  bool found = false;
+  std::vector<int> corridor;
+  NavCounters counters = {};
+};
+
+struct PathResult {
+  uint32_t id;
+  int32_t agent;
+  uint32_t flags;
+  bool found;
+  std::vector<int> corridor;
+};
+
+// Never destroyed: detached workers still wait on them at exit, and destroying
+// a condition variable with waiters blocks.
+std::mutex& g_mutex = *new std::mutex;
+std::condition_variable& g_work_cv = *new std::condition_variable;
+std::condition_variable& g_done_cv = *new std::condition_variable;
+// Jobs in submit order; the first g_claimed have been taken by a worker.
+// A deque keeps references to running jobs valid while more are appended.
+std::deque<PathJob> g_jobs;
+size_t g_claimed = 0;
+std::vector<std::thread> g_workers;
+uint32_t g_batch = 0;
+
+// Delivered, not yet emitted (simulation thread only).
+std::deque<PathResult> g_results;
+// Undelivered PATH_APPLY_TO_AGENT requests per agent (simulation thread only).
+std::vector<uint16_t> g_agent_pending;
+
+void run_job(PathSearchContext& ctx, PathJob& job) {
+  const PathRequest& r = job.request;
+  ctx.counters = &job.counters;
+  ctx.crowding = job.crowding.get();
+  job.found = findCorridor(ctx, g_navmesh, r.free_width, r.stray_mult, r.congestion_mult, r.start, r.end, job.corridor);
+  job.crowding.reset();  // so the next fold can reuse it
+}
+
+void worker_loop() {
+  PathSearchContext ctx;
+  ctx.sim_thread = false;
+  std::unique_lock<std::mutex> lock(g_mutex);
+  for (;;) {
+    g_work_cv.wait(lock, [] { return g_claimed < g_jobs.size(); });
+    PathJob& job = g_jobs[g_claimed++];
+    lock.unlock();
+
+    run_job(ctx, job);
+
+    lock.lock();
+    job.done = true;
+    g_done_cv.notify_all();
+  }
+}
+
+void start_workers() {
+  const int hardware = static_cast<int>(std::thread::hardware_concurrency());
+  const int count = std::max(1, hardware - PATH_WORKER_RESERVED_THREADS);
+  for (int i = 0; i < count; ++i) {
+    g_workers.emplace_back(worker_loop);
+    g_workers.back().detach();
+  }
+}
+
+} // namespace
+
+void submit_path_request(const PathRequest& request) {
+  const int idx = request.agent;
+  if ((request.flags & PATH_APPLY_TO_AGENT) && idx >= 0) {
+    if (static_cast<size_t>(idx) >= g_agent_pending.size()) g_agent_pending.resize(idx + 1, 0);
+    g_agent_pending[idx]++;
+  }
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_jobs.emplace_back();
+  g_jobs.back().request = request;
+  if (request.congestion_mult > 0.0f) g_jobs.back().crowding = poly_congestion_snapshot();
+  g_jobs.back().batch = g_batch;
+  if (!WASM_THREADS) {
+    // No workers: search now. Delivery still waits for the next batch.
+    static PathSearchContext ctx;
+    ctx.sim_thread = false;
+    run_job(ctx, g_jobs.back());
+    g_jobs.back().done = true;
+    g_claimed++;
+    return;
+  }
+  if (g_workers.empty()) start_workers();
+  g_work_cv.notify_one();
+}
+
+void advance_path_batch() {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_batch++;
+}
+
+void deliver_path_results(int activeAgents, const NavConstants& nc) {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  // Stop at the first unfinished search so results keep their submit order.
+  while (!g_jobs.empty() && g_jobs.front().batch != g_batch && g_jobs.front().done) {
+    PathJob& job = g_jobs.front();
+    nav_counters_add(g_nav_frame, job.counters);
+
+    PathResult result = {job.request.id, job.request.agent, job.request.flags, job.found, std::move(job.corridor)};
+    const PathRequest request = job.request;
+    g_jobs.pop_front();
+    g_claimed--;
+
+    const int idx = request.agent;
+    if ((request.flags & PATH_APPLY_TO_AGENT) && idx >= 0) g_agent_pending[idx]--;
+    if (result.found && (request.flags & PATH_APPLY_TO_AGENT) && idx >= 0 && idx < activeAgents && agent_data.is_alive[idx]) {
+      agent_data.corridors[idx] = result.corridor;
+      agent_data.end_targets[idx] = request.end;
+      agent_data.end_target_tris[idx] = is_point_in_navmesh(request.end, -1);
+      if (recalc_agent_corners(idx, nc)) agent_data.states[idx] = AgentState::Traveling;
+    }
+    if (!(request.flags & PATH_NO_RESULT_EVENT)) g_results.push_back(std::move(result));
+  }
+}
+
+bool agent_path_pending(int idx) {
+  return idx >= 0 && static_cast<size_t>(idx) < g_agent_pending.size() && g_agent_pending[idx] != 0;
+}
+
+void emit_path_result_events() {
+  // [id][agent][found][count][polys...]
+  while (!g_results.empty()) {
+    const PathResult& r = g_results.front();
+    const uint32_t count = static_cast<uint32_t>(r.corridor.size());
+    // A corridor longer than the whole ring is reported by count only.
+    const bool withPolys = !(r.flags & PATH_RESULT_NO_CORRIDOR) && 6u + count <= g_event_ring.cap_words;
+    const uint32_t size = 6 + (withPolys ? count : 0u);
+    if (size > g_event_ring.room()) return;
+    uint32_t* out = g_event_ring.reserve(EVT_PATH_RESULT, size);
+    out[2] = r.id;
+    out[3] = static_cast<uint32_t>(r.agent);
+    out[4] = r.found ? 1u : 0u;
+    out[5] = count;
+    for (uint32_t i = 0; i + 6 < size; ++i) out[6 + i] = static_cast<uint32_t>(r.corridor[i]);
+    g_results.pop_front();
+  }
+}
+
+void reset_path_requests() {
+  std::unique_lock<std::mutex> lock(g_mutex);
+  // Unclaimed jobs are dropped; claimed ones finish against the old navmesh.
+  g_jobs.erase(g_jobs.begin() + g_claimed, g_jobs.end());
+  g_done_cv.wait(lock, [] {
+    for (const PathJob& job : g_jobs) {
+      if (!job.done) return false;
+    }
+    return true;
+  });
+  g_jobs.clear();
+  g_claimed = 0;
+  g_results.clear();
+  g_agent_pending.clear();
+}
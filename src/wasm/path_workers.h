@@ -0,0 +1,68 @@
+#ifndef PATH_WORKERS_H
+#define PATH_WORKERS_H
+
+#include <cstdint>
+#include "point2.h"
+#include "nav_constants.h"
+
+// Asynchronous A* for CMD_FIND_PATH.
+//
+// Requests are searched by a pool of worker threads, each with its own
+// PathSearchContext, against the navmesh (read only while they run). Results
+// are delivered on the simulation thread at the start of a step, in submit
+// order, no earlier than the first step after the next process_events: a
+// request sent with frame F is usually answered in the EVT_PATH_RESULT of
+// frame F + 1. A search still running then does not stall the step; it and
+// the requests behind it are delivered by a later step. Without threads the
+// search runs on submit, so the answer always comes with frame F + 1.
+
+// Cores left to the simulation and main threads; the pool gets the rest, at
+// least one.
+const int PATH_WORKER_RESERVED_THREADS = 2;
+
+enum PathRequestFlags : uint32_t {
+  // Set the agent's corridor and end target, recalculate its corners and
+  // start it Traveling.
+  PATH_APPLY_TO_AGENT = 1,
+  // Leave the polygons out of EVT_PATH_RESULT (the count is still reported).
+  PATH_RESULT_NO_CORRIDOR = 2,
+  // Apply the result without reporting it (CMD_SET_TARGETS).
+  PATH_NO_RESULT_EVENT = 4,
+};
+
+struct PathRequest {
+  uint32_t id;
+  int32_t agent;       // -1 = no agent
+  uint32_t flags;
+  Point2 start;
+  Point2 end;
+  float free_width;    // nc.path_free_width when submitted
+  float stray_mult;    // nc.path_width_penalty_mult when submitted
+  float congestion_mult;  // nc.congestion_cost_mult when submitted
+};
+
+// Simulation thread. Queues a search; starts the workers on first use.
+void submit_path_request(const PathRequest& request);
+
+// Simulation thread, once per process_events: later steps deliver what was
+// submitted before.
+void advance_path_batch();
+
+// Simulation thread, once per step before navigation: applies and queues
+// the finished results of earlier batches, up to the first that is still
+// being searched. Never waits.
+void deliver_path_results(int activeAgents, const NavConstants& nc);
+
+// Reserves queued results as EVT_PATH_RESULT in g_event_ring; results that do
+// not fit wait for the next call.
+void emit_path_result_events();
+
+// True while a PATH_APPLY_TO_AGENT request for agent idx is undelivered; the
+// agent then waits instead of searching synchronously.
+bool agent_path_pending(int idx);
+
+// Waits for running searches and drops every request and queued result.
+// Before the navmesh or the agents are replaced.
+void reset_path_requests();
+
+#endif // PATH_WORKERS_H
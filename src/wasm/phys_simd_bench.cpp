@@ -0,0 +1,138 @@
+#include "benchmarks.h"
+#include "agent_move_phys.h"
+#include "data_structures.h"
+#include "sim_thread.h"
+#include <stdio.h>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+extern AgentSoA agent_data;
+extern std::vector<uint8_t> g_wall_contact;
+
+namespace {
+
+// Everything the physics pass writes, so each variant starts from the same state.
+struct PhysState {
+  std::vector<float> positions_x, positions_y, velocities_x, velocities_y;
+  std::vector<Point2> last_coordinates, last_valid_positions;
+  std::vector<int> current_tris, last_valid_tris;
+  std::vector<float> stuck_ratings;
+  std::vector<uint8_t> wall_contact;
+
+  void save(int n) {
+    positions_x.assign(agent_data.positions.x, agent_data.positions.x + n);
+    positions_y.assign(agent_data.positions.y, agent_data.positions.y + n);
+    velocities_x.assign(agent_data.velocities.x, agent_data.velocities.x + n);
+    velocities_y.assign(agent_data.velocities.y, agent_data.velocities.y + n);
+    last_coordinates.assign(agent_data.last_coordinates, agent_data.last_coordinates + n);
+    last_valid_positions.assign(agent_data.last_valid_positions, agent_data.last_valid_positions + n);
+    current_tris.assign(agent_data.current_tris, agent_data.current_tris + n);
+    last_valid_tris.assign(agent_data.last_valid_tris, agent_data.last_valid_tris + n);
+    stuck_ratings.assign(agent_data.stuck_ratings, agent_data.stuck_ratings + n);
+    wall_contact = g_wall_contact;
+  }
+
+  void restore(int n) const {
+    std::copy(positions_x.begin(), positions_x.begin() + n, agent_data.positions.x);
+    std::copy(positions_y.begin(), positions_y.begin() + n, agent_data.positions.y);
+    std::copy(velocities_x.begin(), velocities_x.begin() + n, agent_data.velocities.x);
+    std::copy(velocities_y.begin(), velocities_y.begin() + n, agent_data.velocities.y);
+    std::copy(last_coordinates.begin(), last_coordinates.begin() + n, agent_data.last_coordinates);
+    std::copy(last_valid_positions.begin(), last_valid_positions.begin() + n, agent_data.last_valid_positions);
+    std::copy(current_tris.begin(), current_tris.begin() + n, agent_data.current_tris);
+    std::copy(last_valid_tris.begin(), last_valid_tris.begin() + n, agent_data.last_valid_tris);
+    std::copy(stuck_ratings.begin(), stuck_ratings.begin() + n, agent_data.stuck_ratings);
+    g_wall_contact = wall_contact;
+  }
+};
+
+typedef std::chrono::high_resolution_clock Clock;
+
+void integrate_scalar(int n, float dt, const NavConstants& nc) {
+  for (int i = 0; i < n; ++i) {
+    if (agent_data.is_alive[i]) integrate_agent_velocity(i, dt, nc);
+  }
+}
+
+void move_agents(int n, float dt, const NavConstants& nc) {
+  for (int i = 0; i < n; ++i) {
+    if (agent_data.is_alive[i]) update_agent_move(i, dt, nc);
+  }
+}
+
+double elapsed_ms(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+} // namespace
+
+// Both passes are compared one step at a time from the same state, and the
+// replay then continues from the scalar result. Running the two variants
+// free for many steps would compare chaos instead: a last-bit difference
+// flips a wall contact or triangle hand-off sooner or later and the
+// trajectories part by whole units.
+PhysSimdComparison compare_phys_simd_trajectory(int n, int steps, float dt) {
+  PhysSimdComparison out;
+  out.steps = steps;
+  for (int i = 0; i < n; ++i) out.agents += agent_data.is_alive[i] ? 1 : 0;
+
+  PhysState initial, before, scalarAfter;
+  initial.save(n);
+  const NavConstants nc = load_nav_constants();
+
+  for (int s = 0; s < steps; ++s) {
+    before.save(n);
+    auto start = Clock::now();
+    integrate_scalar(n, dt, nc);
+    out.scalar_ms += elapsed_ms(start);
+    move_agents(n, dt, nc);
+    scalarAfter.save(n);
+
+    before.restore(n);
+    start = Clock::now();
+    integrate_agent_velocities(0, n, dt, nc);
+    out.simd_ms += elapsed_ms(start);
+    move_agents(n, dt, nc);
+
+    for (int i = 0; i < n; ++i) {
+      if (!agent_data.is_alive[i]) continue;
+      const float dx = scalarAfter.positions_x[i] - agent_data.positions.x[i];
+      const float dy = scalarAfter.positions_y[i] - agent_data.positions.y[i];
+      const float d = std::sqrt(dx * dx + dy * dy);
+      if (d > out.max_deviation) {
+        out.max_deviation = d;
+        out.worst_agent = i;
+      }
+    }
+    scalarAfter.restore(n);
+  }
+  initial.restore(n);
+  return out;
+}
+
+// Replays the current agents for a short trajectory with the scalar and the
+// SIMD velocity pass and reports timing and the largest position deviation.
+void phys_simd_bench() {
+  const int STEPS = 120;
+  const float DT = 1.0f / 60.0f;
+
+  std::lock_guard<std::mutex> lock(g_sim_mutex);
+  const int n = agent_data.capacity;
+  if (n <= 0) {
+    printf("[WASM] phys_simd_bench: agents are not initialized\n");
+    return;
+  }
+
+  const PhysSimdComparison r = compare_phys_simd_trajectory(n, STEPS, DT);
+  printf("\nPhysics velocity pass over %d agents x %d steps\n", r.agents, r.steps);
+  printf("- %-30s: t=%.2f\n", "integrate_agent_velocity", r.scalar_ms);
+  printf("- %-30s: t=%.2f\n", "integrate_agent_velocities", r.simd_ms);
+  if (r.simd_ms > 0.0) printf("Speed difference: %.2fx\n", r.scalar_ms / r.simd_ms);
+  printf("Max position deviation: %f (agent %d)\n", r.max_deviation, r.worst_agent);
+  if (r.max_deviation > PHYS_SIMD_TOLERANCE) {
+    printf("[WASM] phys_simd_bench: SIMD trajectory deviates from scalar by %f (tolerance %f)\n",
+           r.max_deviation, PHYS_SIMD_TOLERANCE);
+  }
+}
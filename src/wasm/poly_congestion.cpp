@@ -0,0 +1,148 @@
+#include "poly_congestion.h"
+#include "data_structures.h"
+#include "navmesh.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+extern AgentSoA agent_data;
+extern Navmesh g_navmesh;
+
+namespace {
+
+struct CongestionLayer {
+  const int32_t* polygons = nullptr;  // g_navmesh.polygons the layer was sized for
+  int poly_count = 0;
+  std::vector<int32_t> agent_poly;    // polygon each agent is counted in, -1 = none
+  std::vector<uint32_t> counts;       // agents per walkable polygon
+  std::vector<float> area_scale;      // CONGESTION_REF_AREA / polygon area
+  // Published crowding, never written once published; spare is the one
+  // before it, reused by the next fold once no path request holds it.
+  std::shared_ptr<std::vector<float>> crowding;
+  std::shared_ptr<std::vector<float>> spare;
+  int frames = 0;                     // steps since the last fold
+  float elapsed = 0.0f;               // seconds since the last fold
+};
+
+CongestionLayer g_layer;
+
+float polygon_area(int poly) {
+  const int32_t start = g_navmesh.polygons[poly];
+  const int32_t end = g_navmesh.polygons[poly + 1];
+  float twice = 0.0f;
+  for (int32_t v = start; v < end; ++v) {
+    const Point2 a = g_navmesh.vertices[g_navmesh.poly_verts[v]];
+    const Point2 b = g_navmesh.vertices[g_navmesh.poly_verts[v + 1 < end ? v + 1 : start]];
+    twice += a.x * b.y - b.x * a.y;
+  }
+  return std::fabs(twice) * 0.5f;
+}
+
+} // namespace
+
+void reset_poly_congestion() {
+  CongestionLayer& l = g_layer;
+  const int n = g_navmesh.polygons ? g_navmesh.walkable_polygon_count : 0;
+  l.polygons = g_navmesh.polygons;
+  l.agent_poly.clear();
+  l.counts.assign(n, 0u);
+  l.frames = 0;
+  l.elapsed = 0.0f;
+  // Queued requests may still hold the old arrays, so start fresh ones.
+  l.crowding = std::make_shared<std::vector<float>>(n, 0.0f);
+  l.spare.reset();
+  l.area_scale.resize(n);
+  l.poly_count = n;
+  for (int p = 0; p < n; ++p) {
+    l.area_scale[p] = CONGESTION_REF_AREA / std::max(polygon_area(p), 1.0f);
+  }
+}
+
+void update_poly_congestion(int activeAgents, float dt, const NavConstants& nc) {
+  if (!(nc.congestion_cost_mult > 0.0f)) return;
+  CongestionLayer& l = g_layer;
+  // Headless runs swap g_navmesh without reloading it.
+  if (l.polygons != g_navmesh.polygons || l.poly_count != g_navmesh.walkable_polygon_count) reset_poly_congestion();
+
+  // Move each agent's count to the polygon it stands in now.
+  const int tracked = static_cast<int>(l.agent_poly.size());
+  if (activeAgents > tracked) l.agent_poly.resize(activeAgents, -1);
+  const int n = std::max(activeAgents, tracked);
+  for (int i = 0; i < n; ++i) {
+    int32_t poly = -1;
+    if (i < activeAgents && agent_data.is_alive[i]) {
+      const int tri = agent_data.current_tris[i];
+      if (tri >= 0) poly = g_navmesh.triangle_to_polygon[tri];
+      if (poly >= l.poly_count) poly = -1;
+    }
+    const int32_t prev = l.agent_poly[i];
+    if (poly == prev) continue;
+    if (prev >= 0) l.counts[prev]--;
+    if (poly >= 0) l.counts[poly]++;
+    l.agent_poly[i] = poly;
+  }
+
+  l.elapsed += dt;
+  if (++l.frames < std::max(1, static_cast<int>(nc.congestion_update_frames))) return;
+  const float keep = std::pow(std::min(std::max(nc.congestion_decay, 0.0f), 1.0f), l.elapsed);
+  const float take = 1.0f - keep;
+  std::shared_ptr<std::vector<float>> next = std::move(l.spare);
+  if (!next || next.use_count() != 1) next = std::make_shared<std::vector<float>>();
+  next->resize(l.poly_count);
+  const std::vector<float>& old = *l.crowding;
+  for (int p = 0; p < l.poly_count; ++p) {
+    (*next)[p] = old[p] * keep + l.counts[p] * l.area_scale[p] * take;
+  }
+  l.spare = std::move(l.crowding);
+  l.crowding = std::move(next);
+  l.frames = 0;
+  l.elapsed = 0.0f;
+}
+
+float poly_congestion(int poly) {
+  const CongestionLayer& l = g_layer;
+  return poly >= 0 && poly < l.poly_count ? (*l.crowding)[poly] : 0.0f;
+}
+
+CongestionSnapshot poly_congestion_snapshot() {
+  return g_layer.crowding;
+}
+
+void get_poly_congestion_state(PolyCongestionState& out) {
+  const CongestionLayer& l = g_layer;
+  const bool sized = l.crowding && l.polygons == g_navmesh.polygons && l.poly_count == g_navmesh.walkable_polygon_count;
+  const int n = sized ? l.poly_count : 0;
+  out.crowding.assign(l.crowding->begin(), l.crowding->begin() + n);
+  out.counts.assign(l.counts.begin(), l.counts.begin() + n);
+  out.agent_poly.clear();
+  out.frames = 0;
+  out.elapsed = 0.0f;
+  if (!sized) return;
+  out.agent_poly = l.agent_poly;
+  out.frames = l.frames;
+  out.elapsed = l.elapsed;
+}
+
+bool poly_congestion_state_fits(const PolyCongestionState& state) {
+  if (state.crowding.empty() && state.counts.empty() && state.agent_poly.empty()) return true;
+  const int n = g_navmesh.polygons ? g_navmesh.walkable_polygon_count : 0;
+  if (static_cast<int>(state.crowding.size()) != n || state.counts.size() != state.crowding.size()) return false;
+  for (const int32_t poly : state.agent_poly) {
+    if (poly < -1 || poly >= n) return false;
+  }
+  return true;
+}
+
+bool set_poly_congestion_state(const PolyCongestionState& state) {
+  if (!poly_congestion_state_fits(state)) return false;
+  reset_poly_congestion();
+  if (state.crowding.empty()) return true;
+  CongestionLayer& l = g_layer;
+  *l.crowding = state.crowding;
+  l.counts = state.counts;
+  l.agent_poly = state.agent_poly;
+  l.frames = state.frames;
+  l.elapsed = state.elapsed;
+  return true;
+}
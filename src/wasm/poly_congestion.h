@@ -0,0 +1,74 @@
+#ifndef POLY_CONGESTION_H
+#define POLY_CONGESTION_H
+
+#include "nav_constants.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Per-polygon crowding for congestion-aware A* (CONGESTION_COST_MULT > 0).
+// Agent counts per walkable polygon follow current_tris incrementally; every
+// CONGESTION_UPDATE_FRAMES steps they are folded into a crowding value that
+// decays by CONGESTION_DECAY per second. Crowding is agents per
+// CONGESTION_REF_AREA square units, so a plaza holding the same crowd as an
+// alley costs less to cross. findCorridor scales an edge's length by
+// 1 + CONGESTION_COST_MULT * c / (1 + c), c being the crowding of the polygon
+// it enters. The penalty saturates so a packed plaza near the start cannot
+// flood the search, and it never undercuts the distance heuristic.
+//
+// Every fold publishes a new crowding array and never writes it again. A path
+// request keeps the one published when it was submitted (CongestionSnapshot),
+// so its result does not depend on how far the simulation got while it was
+// searched. Snapshots carry the layer (PolyCongestionState), so a restore
+// continues from the same crowding.
+
+const float CONGESTION_REF_AREA = 100.0f;
+
+// Simulation thread, once per step after movement. Does nothing while
+// nc.congestion_cost_mult is 0.
+void update_poly_congestion(int activeAgents, float dt, const NavConstants& nc);
+
+// Simulation thread. 0 for polygons the layer does not cover.
+float poly_congestion(int poly);
+
+typedef std::shared_ptr<const std::vector<float>> CongestionSnapshot;
+
+// Simulation thread. The crowding of the last fold, one entry per walkable
+// polygon; null before the layer is sized.
+CongestionSnapshot poly_congestion_snapshot();
+
+// Any thread. crowding[poly], 0 without a snapshot or outside it.
+inline float poly_congestion(const std::vector<float>* crowding, int poly) {
+  return crowding && poly >= 0 && poly < static_cast<int>(crowding->size()) ? (*crowding)[poly] : 0.0f;
+}
+
+// Simulation thread, with no path search running: forgets all counts and
+// crowding and sizes the layer for g_navmesh. After the navmesh or the agents
+// are replaced.
+void reset_poly_congestion();
+
+// Everything update_poly_congestion carries from step to step. crowding and
+// counts hold one entry per walkable polygon, or none while the layer is not
+// sized for g_navmesh; agent_poly holds the polygon each agent is counted in
+// (-1 = none).
+struct PolyCongestionState {
+  std::vector<float> crowding;
+  std::vector<uint32_t> counts;
+  std::vector<int32_t> agent_poly;
+  int32_t frames = 0;
+  float elapsed = 0.0f;
+};
+
+// Simulation thread.
+void get_poly_congestion_state(PolyCongestionState& out);
+
+// Whether state can be loaded for g_navmesh: empty, or sized for its walkable
+// polygons with every agent_poly entry in range.
+bool poly_congestion_state_fits(const PolyCongestionState& state);
+
+// Simulation thread, with no path search running: resets the layer for
+// g_navmesh and loads state into it (an empty state leaves it reset).
+// Returns false, touching nothing, if state does not fit.
+bool set_poly_congestion_state(const PolyCongestionState& state);
+
+#endif // POLY_CONGESTION_H
@@ -0,0 +1,147 @@
+#include "populate_spatial_index.h"
+#include "math_utils.h"
+#include "sim_thread.h"
+#include "wasm_log.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct IndexShapes {
+  const SpatialIndex* index;
+  const Point2* vertices;
+  const int32_t* itemOffsets;  // nullptr = triangles
+  const int32_t* itemVerts;
+};
+
+// Calls visit(cellIndex) for every cell the item intersects. scratch holds the
+// corners of polygon items and is reused across items.
+template <typename Visit>
+void for_each_item_cell(const IndexShapes& s, int32_t item, std::vector<Point2>& scratch, Visit visit) {
+  const SpatialIndex& index = *s.index;
+  Point2 tri[3];
+  const Point2* points = tri;
+  int count = 3;
+  if (!s.itemOffsets) {
+    for (int k = 0; k < 3; ++k) tri[k] = s.vertices[s.itemVerts[item * 3 + k]];
+  } else {
+    const int32_t vertStart = s.itemOffsets[item];
+    count = s.itemOffsets[item + 1] - vertStart;
+    if (count <= 0) return;
+    if (scratch.size() < static_cast<size_t>(count)) scratch.resize(count);
+    for (int k = 0; k < count; ++k) scratch[k] = s.vertices[s.itemVerts[vertStart + k]];
+    points = scratch.data();
+  }
+
+  float minX = points[0].x, minY = points[0].y;
+  float maxX = points[0].x, maxY = points[0].y;
+  for (int k = 1; k < count; ++k) {
+    minX = std::min(minX, points[k].x);
+    minY = std::min(minY, points[k].y);
+    maxX = std::max(maxX, points[k].x);
+    maxY = std::max(maxY, points[k].y);
+  }
+
+  const int totalCells = index.gridWidth * index.gridHeight;
+  const int startX = std::max(0, static_cast<int>(std::floor((minX - index.minX) / index.cellSize)));
+  const int endX = std::min(index.gridWidth - 1, static_cast<int>(std::floor((maxX - index.minX) / index.cellSize)));
+  const int startY = std::max(0, static_cast<int>(std::floor((minY - index.minY) / index.cellSize)));
+  const int endY = std::min(index.gridHeight - 1, static_cast<int>(std::floor((maxY - index.minY) / index.cellSize)));
+
+  for (int cx = startX; cx <= endX; ++cx) {
+    for (int cy = startY; cy <= endY; ++cy) {
+      const Point2 cellMin = {index.minX + cx * index.cellSize, index.minY + cy * index.cellSize};
+      const Point2 cellMax = {index.minX + (cx + 1) * index.cellSize, index.minY + (cy + 1) * index.cellSize};
+      const bool hit = s.itemOffsets
+        ? math::polygonAABBIntersectionWithBounds(points, count, {minX, minY}, {maxX, maxY}, cellMin, cellMax)
+        : math::triangleAABBIntersectionWithBounds(points, {minX, minY}, {maxX, maxY}, cellMin, cellMax);
+      const int cellIndex = cy * index.gridWidth + cx;
+      if (hit && cellIndex < totalCells) visit(cellIndex);
+    }
+  }
+}
+
+// Runs fn(thread, rangeBegin, rangeEnd) over threads contiguous slices of [begin, end).
+template <typename Fn>
+void run_split(int threads, int32_t begin, int32_t end, Fn fn) {
+  const int64_t span = end - begin;
+  auto bound = [&](int t) { return begin + static_cast<int32_t>(span * t / threads); };
+  std::thread workers[SPATIAL_INDEX_BUILD_THREADS - 1];
+  for (int t = 1; t < threads; ++t) workers[t - 1] = std::thread(fn, t, bound(t), bound(t + 1));
+  fn(0, bound(0), bound(1));
+  for (int t = 1; t < threads; ++t) workers[t - 1].join();
+}
+
+int build_threads(int32_t items) {
+  if (!WASM_THREADS) return 1;
+  const int hardware = static_cast<int>(std::thread::hardware_concurrency());
+  const int wanted = std::max(1, items / SPATIAL_INDEX_ITEMS_PER_THREAD);
+  return std::max(1, std::min({hardware, wanted, SPATIAL_INDEX_BUILD_THREADS}));
+}
+
+} // namespace
+
+void populate_spatial_index(SpatialIndex& index, const Point2* vertices, const int32_t* itemOffsets, const int32_t* itemVerts,
+                            int32_t begin, int32_t end, const char* name,
+                            size_t& auxOffset, uint8_t* auxiliaryMemory, size_t auxiliaryMemorySize) {
+  const int totalCells = index.gridWidth * index.gridHeight;
+  const IndexShapes shapes = {&index, vertices, itemOffsets, itemVerts};
+  const int threads = build_threads(end - begin);
+
+  // Count pass: per-thread cell counts, turned into per-thread fill cursors.
+  // Each thread also records its (cell, item) hits so the fill pass does not
+  // repeat the intersection tests.
+  std::vector<uint32_t> cursors(static_cast<size_t>(threads) * totalCells, 0);
+  std::vector<std::vector<uint32_t>> hits(threads);
+  run_split(threads, begin, end, [&](int t, int32_t rangeBegin, int32_t rangeEnd) {
+    uint32_t* counts = cursors.data() + static_cast<size_t>(t) * totalCells;
+    std::vector<uint32_t>& threadHits = hits[t];
+    threadHits.reserve(static_cast<size_t>(rangeEnd - rangeBegin) * 4);
+    std::vector<Point2> scratch;
+    for (int32_t i = rangeBegin; i < rangeEnd; ++i) {
+      for_each_item_cell(shapes, i, scratch, [&](int cell) {
+        counts[cell]++;
+        threadHits.push_back(static_cast<uint32_t>(cell));
+        threadHits.push_back(static_cast<uint32_t>(i));
+      });
+    }
+  });
+
+  uint32_t totalItems = 0;
+  for (int c = 0; c < totalCells; ++c) {
+    index.cellOffsets[c] = totalItems;
+    for (int t = 0; t < threads; ++t) {
+      uint32_t& slot = cursors[static_cast<size_t>(t) * totalCells + c];
+      const uint32_t count = slot;
+      slot = totalItems;
+      totalItems += count;
+    }
+  }
+  index.cellOffsets[totalCells] = totalItems;
+
+  size_t itemsSize = alignTo(totalItems * sizeof(int32_t), SIMD_ALIGNMENT);
+  if (auxOffset + itemsSize > auxiliaryMemorySize) {
+    wasm_console_error(std::string("[WASM] Not enough auxiliary memory to populate ") + name + " index items");
+    std::memset(index.cellOffsets, 0, (totalCells + 1) * sizeof(uint32_t));
+    return;
+  }
+
+  index.cellItems = reinterpret_cast<int32_t*>(auxiliaryMemory + auxOffset);
+  index.cellItemsCount = totalItems;
+  auxOffset += itemsSize;
+
+  // Fill pass: scatter each thread's hits at its cursors.
+  int32_t* items = index.cellItems;
+  run_split(threads, 0, threads, [&](int, int32_t rangeBegin, int32_t rangeEnd) {
+    for (int32_t t = rangeBegin; t < rangeEnd; ++t) {
+      uint32_t* cellCursors = cursors.data() + static_cast<size_t>(t) * totalCells;
+      const std::vector<uint32_t>& threadHits = hits[t];
+      for (size_t h = 0; h < threadHits.size(); h += 2) {
+        items[cellCursors[threadHits[h]]++] = static_cast<int32_t>(threadHits[h + 1]);
+      }
+    }
+  });
+}
@@ -0,0 +1,26 @@
+#ifndef POPULATE_SPATIAL_INDEX_H
+#define POPULATE_SPATIAL_INDEX_H
+
+#include "navmesh.h"
+#include <cstdint>
+
+// Shared builder behind the populate_*_index functions.
+//
+// Items [begin, end) are shapes over vertices: item i's corners are
+// vertices[itemVerts[k]] for k in [itemOffsets[i], itemOffsets[i + 1]), or
+// three per item (itemVerts[i * 3 + k]) when itemOffsets is nullptr, which
+// selects the triangle test. The index is built in two passes without a
+// temporary grid: a count pass into index.cellOffsets (already allocated by
+// the caller), a prefix sum, and a fill pass straight into cellItems at
+// auxOffset. Both passes split the item range over up to
+// SPATIAL_INDEX_BUILD_THREADS threads; each thread keeps its own cell counts,
+// so items land in every cell in ascending order, as with a single thread.
+
+const int SPATIAL_INDEX_BUILD_THREADS = 4;          // including the calling thread
+const int SPATIAL_INDEX_ITEMS_PER_THREAD = 2048;    // smaller ranges are not worth a thread
+
+void populate_spatial_index(SpatialIndex& index, const Point2* vertices, const int32_t* itemOffsets, const int32_t* itemVerts,
+                            int32_t begin, int32_t end, const char* name,
+                            size_t& auxOffset, uint8_t* auxiliaryMemory, size_t auxiliaryMemorySize);
+
+#endif // POPULATE_SPATIAL_INDEX_H
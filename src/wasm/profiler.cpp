@@ -0,0 +1,156 @@
+#include "profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+const char* const STAGE_NAMES[PROFILE_STAGE_COUNT] = {
+#define X(id, name) name,
+  PROFILE_STAGES(X)
+#undef X
+};
+
+static_assert((PROFILE_WINDOW & (PROFILE_WINDOW - 1)) == 0, "window must be a power of two");
+
+// Rolling window of one stage. A stage is only timed from one thread at a
+// time (render on the main thread, the rest wherever the sim runs).
+struct StageWindow {
+  float samples[PROFILE_WINDOW];
+  uint32_t count;
+};
+
+struct TraceEvent {
+  uint32_t stage;
+  uint32_t tid;
+  double start_us;
+  double dur_us;
+};
+
+StageWindow g_windows[PROFILE_STAGE_COUNT] = {};
+uint32_t g_page[PROFILE_HEADER_WORDS + PROFILE_STAGE_COUNT * PROFILE_STAGE_WORDS] = {
+  0, PROFILE_STAGE_COUNT, PROFILE_STAGE_WORDS, PROFILE_WINDOW, PROFILE_BUCKETS, 0,
+};
+// Serializes writers of the page; readers never take it.
+std::atomic_flag g_page_lock = ATOMIC_FLAG_INIT;
+
+const ProfileClock::time_point g_epoch = ProfileClock::now();
+std::atomic<bool> g_capture{false};
+std::atomic<uint32_t> g_next_tid{0};
+std::mutex g_trace_mutex;
+std::vector<TraceEvent> g_trace_events;
+
+int bucket_of(float us) {
+  int b = 0;
+  uint32_t v = static_cast<uint32_t>(us);
+  while (v && b < PROFILE_BUCKETS - 1) {
+    v >>= 1;
+    b++;
+  }
+  return b;
+}
+
+uint32_t float_bits(float v) {
+  uint32_t u;
+  std::memcpy(&u, &v, sizeof(u));
+  return u;
+}
+
+uint32_t thread_index() {
+  thread_local uint32_t tid = g_next_tid.fetch_add(1, std::memory_order_relaxed);
+  return tid;
+}
+
+void publish(ProfileStage stage, float lastUs) {
+  const StageWindow& w = g_windows[stage];
+  const int n = w.count < PROFILE_WINDOW ? static_cast<int>(w.count) : PROFILE_WINDOW;
+
+  float sorted[PROFILE_WINDOW];
+  std::memcpy(sorted, w.samples, n * sizeof(float));
+  uint32_t buckets[PROFILE_BUCKETS] = {};
+  float sum = 0.0f;
+  for (int i = 0; i < n; ++i) {
+    sum += sorted[i];
+    buckets[bucket_of(sorted[i])]++;
+  }
+  const int p99Index = (n * 99) / 100 < n ? (n * 99) / 100 : n - 1;
+  std::nth_element(sorted, sorted + p99Index, sorted + n);
+  const float p99 = sorted[p99Index];
+  const float minUs = *std::min_element(sorted, sorted + n);
+  const float maxUs = *std::max_element(sorted, sorted + n);
+
+  while (g_page_lock.test_and_set(std::memory_order_acquire)) {}
+  __atomic_fetch_add(&g_page[0], 1u, __ATOMIC_RELAXED);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  uint32_t* s = g_page + PROFILE_HEADER_WORDS + stage * PROFILE_STAGE_WORDS;
+  s[0] = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(STAGE_NAMES[stage]));
+  s[1] = w.count;
+  s[2] = float_bits(lastUs);
+  s[3] = float_bits(minUs);
+  s[4] = float_bits(sum / n);
+  s[5] = float_bits(p99);
+  s[6] = float_bits(maxUs);
+  std::memcpy(s + 7, buckets, sizeof(buckets));
+
+  __atomic_fetch_add(&g_page[0], 1u, __ATOMIC_RELEASE);
+  g_page_lock.clear(std::memory_order_release);
+}
+
+} // namespace
+
+void profile_record(ProfileStage stage, ProfileClock::time_point start, ProfileClock::time_point end) {
+  const float us = std::chrono::duration<float, std::micro>(end - start).count();
+  StageWindow& w = g_windows[stage];
+  w.samples[w.count & (PROFILE_WINDOW - 1)] = us;
+  w.count++;
+  publish(stage, us);
+
+  if (g_capture.load(std::memory_order_relaxed)) {
+    TraceEvent e;
+    e.stage = stage;
+    e.tid = thread_index();
+    e.start_us = std::chrono::duration<double, std::micro>(start - g_epoch).count();
+    e.dur_us = us;
+    std::lock_guard<std::mutex> lock(g_trace_mutex);
+    g_trace_events.push_back(e);
+  }
+}
+
+const uint32_t* profiler_stats_page() {
+  // Stage names are static, fill them in so TS can label stages that never ran.
+  for (int i = 0; i < static_cast<int>(PROFILE_STAGE_COUNT); ++i) {
+    g_page[PROFILE_HEADER_WORDS + i * PROFILE_STAGE_WORDS] =
+        static_cast<uint32_t>(reinterpret_cast<uintptr_t>(STAGE_NAMES[i]));
+  }
+  return g_page;
+}
+
+void profiler_set_trace_capture(bool enabled) {
+  if (enabled) {
+    std::lock_guard<std::mutex> lock(g_trace_mutex);
+    g_trace_events.clear();
+  }
+  g_capture.store(enabled, std::memory_order_relaxed);
+}
+
+bool profiler_write_chrome_trace(const char* path) {
+  FILE* f = fopen(path, "w");
+  if (!f) {
+    printf("[WASM] profiler: cannot open %s for writing\n", path);
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(g_trace_mutex);
+  fprintf(f, "{\"traceEvents\":[\n");
+  for (size_t i = 0; i < g_trace_events.size(); ++i) {
+    const TraceEvent& e = g_trace_events[i];
+    fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}\n",
+            i ? "," : "", STAGE_NAMES[e.stage], e.tid, e.start_us, e.dur_us);
+  }
+  fprintf(f, "],\"displayTimeUnit\":\"ms\"}\n");
+  fclose(f);
+  return true;
+}
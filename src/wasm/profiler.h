@@ -0,0 +1,77 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include <chrono>
+
+// Scoped per-stage timers. Every finished scope feeds a rolling window of the
+// stage's last PROFILE_WINDOW samples; min/mean/p99/max and a log2 histogram
+// of that window are published into a fixed-layout stats page that TS reads
+// through a seqlock (src/logic/FrameProfiler.ts).
+
+// Build with -DPROFILER_ENABLED=0 to compile the scopes out.
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+// X(id, name)
+#define PROFILE_STAGES(X) \
+  X(PROFILE_PROCESS_EVENTS, "process_events") \
+  X(PROFILE_NAVIGATION, "navigation") \
+  X(PROFILE_PHYSICS, "physics") \
+  X(PROFILE_STATISTICS, "statistics") \
+  X(PROFILE_GRID_REINDEX, "clear_and_reindex_grid") \
+  X(PROFILE_CONGESTION, "update_poly_congestion") \
+  X(PROFILE_COLLISIONS, "update_agent_collisions") \
+  X(PROFILE_EMIT_EVENTS, "emit_events") \
+  X(PROFILE_STEP, "step") \
+  X(PROFILE_RENDER, "render") \
+  X(PROFILE_NAVMESH_INIT, "navmesh_init")
+
+enum ProfileStage : uint32_t {
+#define X(id, name) id,
+  PROFILE_STAGES(X)
+#undef X
+  PROFILE_STAGE_COUNT
+};
+
+const int PROFILE_WINDOW = 128;      // samples per stage, power of two
+const int PROFILE_BUCKETS = 16;      // bucket b counts samples in [2^(b-1), 2^b) us, bucket 0 is < 1us
+
+// Stats page exported via get_profiler_stats_ptr (u32 words):
+//   [0] seq (odd while a writer is inside), [1] stage count, [2] words per stage,
+//   [3] window size, [4] bucket count, [5] reserved
+//   then per stage: name ptr, total samples, last/min/mean/p99/max us (f32),
+//   PROFILE_BUCKETS histogram counts over the window.
+const int PROFILE_HEADER_WORDS = 6;
+const int PROFILE_STAGE_WORDS = 7 + PROFILE_BUCKETS;
+
+typedef std::chrono::steady_clock ProfileClock;
+
+void profile_record(ProfileStage stage, ProfileClock::time_point start, ProfileClock::time_point end);
+const uint32_t* profiler_stats_page();
+
+// Chrome trace capture (chrome://tracing, Perfetto). Scopes are appended to an
+// in-memory event list while capture is on; the native harness writes it out.
+void profiler_set_trace_capture(bool enabled);
+bool profiler_write_chrome_trace(const char* path);
+
+struct ProfileScope {
+  ProfileStage stage;
+  ProfileClock::time_point start;
+  explicit ProfileScope(ProfileStage s) : stage(s), start(ProfileClock::now()) {}
+  ~ProfileScope() { profile_record(stage, start, ProfileClock::now()); }
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#if PROFILER_ENABLED
+#define PROFILE_SCOPE(stage) ProfileScope PROFILE_CONCAT(_profile_scope_, __LINE__)(stage)
+#else
+#define PROFILE_SCOPE(stage) do {} while (0)
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,85 @@
+#include "render_snapshot.h"
+#include <cstring>
+#include <cstdlib>
+
+extern AgentSoA agent_data;
+
+RenderSnapshot g_render_snapshot;
+
+static inline uint32_t load_acquire(const uint32_t* p) {
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void store_release(uint32_t* p, uint32_t v) {
+  __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+void RenderSnapshot::init(int capacity_) {
+  capacity = capacity_;
+  const size_t headerWords = RENDER_SNAPSHOT_HEADER_WORDS + RENDER_SNAPSHOT_SLOTS * RENDER_SNAPSHOT_SLOT_WORDS;
+  header = static_cast<uint32_t*>(malloc(headerWords * sizeof(uint32_t)));
+  std::memset(header, 0, headerWords * sizeof(uint32_t));
+  header[2] = static_cast<uint32_t>(capacity);
+  header[3] = static_cast<uint32_t>(RENDER_SNAPSHOT_SLOTS);
+
+  for (int s = 0; s < RENDER_SNAPSHOT_SLOTS; ++s) {
+    RenderSnapshotSlot& slot = slots[s];
+    slot.positions_x = new float[capacity];
+    slot.positions_y = new float[capacity];
+    slot.looks = new Point2[capacity];
+    slot.frame_ids = new uint16_t[capacity];
+    slot.states = new AgentState[capacity];
+    slot.is_alive = new uint8_t[capacity];
+    slot.active_agents = 0;
+    slot.sim_time = 0.0f;
+    std::memset(slot.is_alive, 0, capacity);
+
+    uint32_t* w = header + RENDER_SNAPSHOT_HEADER_WORDS + s * RENDER_SNAPSHOT_SLOT_WORDS;
+    w[2] = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(slot.positions_x));
+    w[3] = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(slot.positions_y));
+    w[4] = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(slot.looks));
+    w[5] = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(slot.frame_ids));
+    w[6] = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(slot.states));
+    w[7] = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(slot.is_alive));
+  }
+}
+
+void RenderSnapshot::publish(int active_agents, float sim_time) {
+  if (!header) return;
+  const uint32_t seq = header[0];
+  const uint32_t target = (header[1] + 1) % RENDER_SNAPSHOT_SLOTS;
+  RenderSnapshotSlot& slot = slots[target];
+  const int count = active_agents < capacity ? active_agents : capacity;
+
+  std::memcpy(slot.positions_x, agent_data.positions.x, count * sizeof(float));
+  std::memcpy(slot.positions_y, agent_data.positions.y, count * sizeof(float));
+  std::memcpy(slot.looks, agent_data.looks, count * sizeof(Point2));
+  std::memcpy(slot.frame_ids, agent_data.frame_ids, count * sizeof(uint16_t));
+  std::memcpy(slot.states, agent_data.states, count * sizeof(AgentState));
+  std::memcpy(slot.is_alive, agent_data.is_alive, count * sizeof(uint8_t));
+  slot.active_agents = count;
+  slot.sim_time = sim_time;
+
+  uint32_t* w = header + RENDER_SNAPSHOT_HEADER_WORDS + target * RENDER_SNAPSHOT_SLOT_WORDS;
+  w[0] = static_cast<uint32_t>(count);
+  std::memcpy(&w[1], &sim_time, sizeof(float));
+  store_release(&w[8], seq + 1);
+
+  store_release(&header[1], target);
+  store_release(&header[0], seq + 1);
+}
+
+const RenderSnapshotSlot* RenderSnapshot::acquire(uint32_t& out_seq) const {
+  if (!header) return nullptr;
+  out_seq = load_acquire(&header[0]);
+  if (out_seq == 0) return nullptr;
+  return &slots[load_acquire(&header[1])];
+}
+
+bool RenderSnapshot::still_valid(uint32_t seq) const {
+  return load_acquire(&header[0]) - seq < 2;
+}
+
+bool RenderSnapshot::has_frame() const {
+  return header && load_acquire(&header[0]) != 0;
+}
@@ -0,0 +1,58 @@
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+#include <cstdint>
+#include <atomic>
+#include "data_structures.h"
+
+// Number of rotating snapshot slots. With three slots the writer never touches
+// the slot published last, nor the one published before it. The sim thread may
+// publish several ticks back to back, so readers still confirm with
+// still_valid() after copying and retry from a fresh acquire() if it fails.
+const int RENDER_SNAPSHOT_SLOTS = 3;
+
+// Compact per-frame copy of what the renderer and TS need to draw agents.
+// Written only by the simulation side, read without locks by render() and TS.
+struct RenderSnapshotSlot {
+  float* positions_x;
+  float* positions_y;
+  Point2* looks;
+  uint16_t* frame_ids;
+  AgentState* states;
+  uint8_t* is_alive;
+  int32_t active_agents;
+  float sim_time;
+};
+
+// Word layout exported to TS via get_render_snapshot_ptr (all u32 unless noted):
+//   [0] seq            - number of published frames, incremented after each publish
+//   [1] latest_slot    - slot index of the most recently published frame
+//   [2] capacity       - agents per slot
+//   [3] slot_count     - RENDER_SNAPSHOT_SLOTS
+//   then per slot RENDER_SNAPSHOT_SLOT_WORDS words:
+//   [+0] active_agents, [+1] sim_time (f32), [+2] positions_x ptr, [+3] positions_y ptr,
+//   [+4] looks ptr, [+5] frame_ids ptr, [+6] states ptr, [+7] is_alive ptr, [+8] slot seq
+// Readers sample seq before and after copying; if it advanced by 2 or more the
+// slot may have been reused and the read should be retried.
+const int RENDER_SNAPSHOT_HEADER_WORDS = 4;
+const int RENDER_SNAPSHOT_SLOT_WORDS = 9;
+
+struct RenderSnapshot {
+  RenderSnapshotSlot slots[RENDER_SNAPSHOT_SLOTS];
+  int capacity = 0;
+  // Shared descriptor read by TS; seq and latest_slot are updated atomically.
+  uint32_t* header = nullptr;
+
+  void init(int capacity);
+  // Copy the renderable columns of agent_data into the next slot and publish it.
+  void publish(int active_agents, float sim_time);
+  // Slot of the most recent publish together with the sequence it was read at.
+  const RenderSnapshotSlot* acquire(uint32_t& out_seq) const;
+  // True if the slot returned by acquire() at seq was not overwritten since.
+  bool still_valid(uint32_t seq) const;
+  bool has_frame() const;
+};
+
+extern RenderSnapshot g_render_snapshot;
+
+#endif // RENDER_SNAPSHOT_H
@@ -0,0 +1,287 @@
+#include "scenario_bench.h"
+#include "nav_constants.h"
+#include "data_structures.h"
+#include "init_navmesh.h"
+#include "math_utils.h"
+#include "model.h"
+#include "nav_telemetry.h"
+#include "navmesh.h"
+#include "sim_driver.h"
+#include "sim_thread.h"
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+extern Navmesh g_navmesh;
+extern Model g_model;
+
+namespace {
+
+const float SCENARIO_DT = 1.0f / 60.0f;
+const float JOURNEY_CELL_EXTENTS = 30.0f; // same area RandomJourney picks targets from
+const float SPLIT_CONGESTION_MULT = 0.5f;  // nc.congestion_cost_mult for split_crossing_congested
+
+struct ScenarioInfo {
+  const char* name;
+  int agents;
+  int frames;
+};
+
+const ScenarioInfo k_scenarios[SCENARIO_COUNT] = {
+#define X(id, name, agents, frames) {name, agents, frames},
+  SCENARIOS(X)
+#undef X
+};
+
+typedef std::chrono::steady_clock Clock;
+
+float elapsed_ms(Clock::time_point start) {
+  return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+size_t heap_bytes_in_use() {
+#if defined(__EMSCRIPTEN__)
+  return mallinfo().uordblks;
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  return mallinfo2().uordblks;
+#else
+  return 0;
+#endif
+}
+
+// Peak heap growth since construction; the caller samples it once per frame.
+struct HeapWatermark {
+  size_t base = heap_bytes_in_use();
+  size_t peak = 0;
+
+  void sample() {
+    const size_t now = heap_bytes_in_use();
+    if (now > base) peak = std::max(peak, now - base);
+  }
+};
+
+uint32_t total_repaths() {
+  const NavCounters& totals = nav_telemetry_totals();
+  uint32_t sum = 0;
+  for (int r = 0; r < static_cast<int>(REPATH_REASON_COUNT); ++r) sum += totals.repaths[r];
+  return sum;
+}
+
+uint32_t stuck_repaths() {
+  return nav_telemetry_totals().repaths[REPATH_FROM_STUCK];
+}
+
+void fill_percentiles(std::vector<float>& samples, ScenarioResult& out) {
+  if (samples.empty()) return;
+  std::sort(samples.begin(), samples.end());
+  auto at = [&](float q) { return samples[static_cast<size_t>(q * (samples.size() - 1) + 0.5f)]; };
+  out.p50_ms = at(0.50f);
+  out.p95_ms = at(0.95f);
+  out.p99_ms = at(0.99f);
+  out.max_ms = samples.back();
+}
+
+// Spawns agents [first, first + count) around center, alternating the smart and
+// stupid benchmarker presets like the TS benchmark spawner.
+bool spawn_in_area(int first, int count, Point2 center, float numCellExtents, uint64_t* seed) {
+  const AgentSpawnParams smart;
+  const AgentSpawnParams stupid = benchmarker_stupid_params();
+  for (int i = first; i < first + count; ++i) {
+    const int tri = random_triangle_in_area(center, numCellExtents, seed);
+    if (tri == -1) return false;
+    spawn_agent(i, random_point_in_triangle(tri, seed), (i & 1) ? stupid : smart);
+  }
+  return true;
+}
+
+bool send_to_area(int first, int count, Point2 center, float numCellExtents, uint64_t* seed) {
+  for (int i = first; i < first + count; ++i) {
+    const int tri = random_triangle_in_area(center, numCellExtents, seed);
+    if (tri == -1) return false;
+    send_agent_to_triangle(i, tri);
+  }
+  return true;
+}
+
+// Spawns the scenario's agents and hands out initial targets. randomJourneys
+// tells whether Standing agents get a new random journey every frame.
+bool setup_agents(ScenarioId id, int n, uint64_t* seed, bool* randomJourneys) {
+  const Point2 origin = {0.0f, 0.0f};
+  *randomJourneys = false;
+  switch (id) {
+    case SCENARIO_RANDOM_JOURNEYS_1K:
+    case SCENARIO_RANDOM_JOURNEYS_10K:
+    case SCENARIO_RANDOM_JOURNEYS_50K:
+      *randomJourneys = true;
+      return spawn_in_area(0, n, origin, JOURNEY_CELL_EXTENTS, seed);
+    case SCENARIO_ALL_TO_ONE: {
+      if (!spawn_in_area(0, n, origin, JOURNEY_CELL_EXTENTS, seed)) return false;
+      const int target = random_triangle_in_area(origin, 1.0f, seed);
+      if (target == -1) return false;
+      for (int i = 0; i < n; ++i) send_agent_to_triangle(i, target);
+      return true;
+    }
+    case SCENARIO_BOTTLENECK:
+    case SCENARIO_SPLIT_CROSSING:
+    case SCENARIO_SPLIT_CONGESTION: {
+      // Two groups swap sides through the map center. On the synthetic
+      // bottleneck navmesh the only way across is the gap in the middle wall;
+      // on the split navmesh there are two gaps, equally far from both groups.
+      const float side = 6.0f * g_navmesh.triangle_index.cellSize;
+      const Point2 left = {-side, 0.0f};
+      const Point2 right = {side, 0.0f};
+      const int half = n / 2;
+      return spawn_in_area(0, half, left, 2.0f, seed) && spawn_in_area(half, n - half, right, 2.0f, seed) &&
+             send_to_area(0, half, right, 2.0f, seed) && send_to_area(half, n - half, left, 2.0f, seed);
+    }
+    case SCENARIO_MASS_STUCK: {
+      // Everyone starts piled into one cell and has to untangle before the
+      // random journeys can make progress.
+      *randomJourneys = true;
+      const int tri = random_triangle_in_area(origin, 2.0f, seed);
+      return tri != -1 && spawn_in_area(0, n, g_navmesh.triangle_centroids[tri], 0.5f, seed);
+    }
+    default:
+      return false;
+  }
+}
+
+bool run_cold_start(int loads, ScenarioResult& out) {
+  // The binary still sits at the start of the navmesh memory; derived data
+  // baked into a v2 binary is reused, the rest is rebuilt on every load.
+  const uint8_t* binary = g_navmesh.binary;
+  const uint32_t binaryBytes = g_navmesh.binary_bytes;
+  const float cellSize = g_navmesh.triangle_index.cellSize;
+  const uint32_t memoryBytes = navmesh_memory_bytes(binary, binaryBytes, cellSize);
+  if (binary == nullptr || memoryBytes == 0) return false;
+  const Navmesh saved = g_navmesh;
+
+  HeapWatermark heap;
+  std::vector<float> samples;
+  samples.reserve(loads);
+  bool ok = true;
+  for (int i = 0; i < loads && ok; ++i) {
+    uint8_t* memory = static_cast<uint8_t*>(aligned_alloc(SIMD_ALIGNMENT, alignTo(memoryBytes, SIMD_ALIGNMENT)));
+    const auto start = Clock::now();
+    memcpy(memory, binary, binaryBytes);
+    ok = init_navmesh_from_buffer(memory, binaryBytes, memoryBytes, cellSize, false) != 0;
+    samples.push_back(elapsed_ms(start));
+    heap.sample();
+    g_navmesh = saved;
+    free(memory);
+  }
+
+  out.frames = loads;
+  out.memory_high_water = heap.peak;
+  fill_percentiles(samples, out);
+  return ok;
+}
+
+} // namespace
+
+const char* scenario_name(ScenarioId id) {
+  return (id >= 0 && id < SCENARIO_COUNT) ? k_scenarios[id].name : "unknown";
+}
+
+int scenario_from_name(const char* name) {
+  for (int i = 0; i < SCENARIO_COUNT; ++i) {
+    if (strcmp(k_scenarios[i].name, name) == 0) return i;
+  }
+  return -1;
+}
+
+bool run_scenario(ScenarioId id, ScenarioResult& out) {
+  out = ScenarioResult();
+  if (id < 0 || id >= SCENARIO_COUNT) {
+    printf("[WASM] Unknown scenario %d\n", static_cast<int>(id));
+    return false;
+  }
+  if (is_simulation_threaded()) {
+    printf("[WASM] Scenario %s: stop the simulation thread first\n", scenario_name(id));
+    return false;
+  }
+  if (!g_navmesh.triangle_centroids || g_navmesh.walkable_triangle_count <= 0) {
+    printf("[WASM] Scenario %s: navmesh is not loaded\n", scenario_name(id));
+    return false;
+  }
+#ifndef NAV_CONSTANTS_BAKED
+  if (!g_constants_buffer) {
+    printf("[WASM] Scenario %s: constants buffer is not set\n", scenario_name(id));
+    return false;
+  }
+#endif
+
+  const ScenarioInfo& info = k_scenarios[id];
+  if (id == SCENARIO_COLD_START) return run_cold_start(info.frames, out);
+
+  // Congestion on for this scenario only, through the constants the steps
+  // get; the buffer TS owns is left alone.
+  NavConstants nc = load_nav_constants();
+  if (id == SCENARIO_SPLIT_CONGESTION) nc.congestion_cost_mult = SPLIT_CONGESTION_MULT;
+
+  const int n = info.agents;
+  HeapWatermark heap;
+  ScopedAgentSet agents(n);
+  uint64_t seed = 1000 + static_cast<uint64_t>(id);
+  g_model.rng_seed = seed;
+  math::set_rng_seed(seed);
+  g_model.sim_time = 0.0f;
+
+  bool randomJourneys = false;
+  if (!setup_agents(id, n, &seed, &randomJourneys)) {
+    printf("[WASM] Scenario %s: could not place agents on this navmesh\n", info.name);
+    return false;
+  }
+
+  std::vector<float> samples;
+  samples.reserve(info.frames);
+  const uint32_t repathsBefore = total_repaths();
+  const uint32_t stuckBefore = stuck_repaths();
+  for (int f = 0; f < info.frames; ++f) {
+    if (randomJourneys) update_random_journeys(n, &seed);
+    const auto start = Clock::now();
+    g_model.step(SCENARIO_DT, n, nc);
+    samples.push_back(elapsed_ms(start));
+    heap.sample();
+  }
+
+  out.agents = n;
+  out.frames = info.frames;
+  out.repaths_per_sec = (total_repaths() - repathsBefore) / (info.frames * SCENARIO_DT);
+  out.stuck_repaths_per_sec = (stuck_repaths() - stuckBefore) / (info.frames * SCENARIO_DT);
+  out.memory_high_water = heap.peak;
+  fill_percentiles(samples, out);
+  return true;
+}
+
+void print_scenario_header() {
+  printf("%-24s %7s %6s %9s %9s %9s %9s %10s %9s %10s\n",
+         "scenario", "agents", "frames", "p50 ms", "p95 ms", "p99 ms", "max ms", "repaths/s", "stuck/s", "mem KB");
+}
+
+void print_scenario_result(ScenarioId id, const ScenarioResult& r) {
+  printf("%-24s %7d %6d %9.3f %9.3f %9.3f %9.3f %10.1f %9.1f %10llu\n",
+         scenario_name(id), r.agents, r.frames, r.p50_ms, r.p95_ms, r.p99_ms, r.max_ms,
+         r.repaths_per_sec, r.stuck_repaths_per_sec, static_cast<unsigned long long>(r.memory_high_water / 1024));
+}
+
+void scenario_bench(int id) {
+  ScenarioResult r;
+  if (!run_scenario(static_cast<ScenarioId>(id), r)) return;
+  printf("\n");
+  print_scenario_header();
+  print_scenario_result(static_cast<ScenarioId>(id), r);
+}
+
+void scenario_suite() {
+  printf("\nScenario suite\n");
+  print_scenario_header();
+  for (int i = 0; i < SCENARIO_COUNT; ++i) {
+    ScenarioResult r;
+    if (run_scenario(static_cast<ScenarioId>(i), r)) print_scenario_result(static_cast<ScenarioId>(i), r);
+  }
+}
@@ -0,0 +1,57 @@
+#ifndef SCENARIO_BENCH_H
+#define SCENARIO_BENCH_H
+
+#include <cstdint>
+
+// Standard crowd scenarios run on the loaded navmesh with a private agent set,
+// so they can be triggered from a live game (WasmImpulse) without touching the
+// TS-visible agents, or from the native runner (native/sim_runner --scenarios).
+
+// X(id, name, agents, frames)
+#define SCENARIOS(X) \
+  X(SCENARIO_RANDOM_JOURNEYS_1K, "random_journeys_1k", 1000, 600) \
+  X(SCENARIO_RANDOM_JOURNEYS_10K, "random_journeys_10k", 10000, 300) \
+  X(SCENARIO_RANDOM_JOURNEYS_50K, "random_journeys_50k", 50000, 120) \
+  X(SCENARIO_ALL_TO_ONE, "all_to_one", 5000, 600) \
+  X(SCENARIO_BOTTLENECK, "bottleneck_crossing", 2000, 900) \
+  X(SCENARIO_MASS_STUCK, "mass_stuck_recovery", 5000, 300) \
+  X(SCENARIO_SPLIT_CROSSING, "split_crossing", 2000, 900) \
+  X(SCENARIO_SPLIT_CONGESTION, "split_crossing_congested", 2000, 900) \
+  X(SCENARIO_COLD_START, "cold_start_navmesh", 0, 20)
+
+enum ScenarioId : int {
+#define X(id, name, agents, frames) id,
+  SCENARIOS(X)
+#undef X
+  SCENARIO_COUNT
+};
+
+struct ScenarioResult {
+  int agents = 0;
+  int frames = 0;         // simulated frames, or navmesh loads for cold start
+  float p50_ms = 0.0f;    // per frame (per load for cold start)
+  float p95_ms = 0.0f;
+  float p99_ms = 0.0f;
+  float max_ms = 0.0f;
+  float repaths_per_sec = 0.0f;    // per simulated second, all repath reasons
+  float stuck_repaths_per_sec = 0.0f; // per simulated second, REPATH_FROM_STUCK only
+  uint64_t memory_high_water = 0;  // heap bytes above the pre-scenario level
+};
+
+const char* scenario_name(ScenarioId id);
+// -1 if no scenario has this name.
+int scenario_from_name(const char* name);
+
+// Runs one scenario with its default agent and frame counts. Agent state is
+// swapped out and restored afterwards; the navmesh is left as it was.
+// Returns false if it cannot run (no navmesh, simulation thread running).
+bool run_scenario(ScenarioId id, ScenarioResult& out);
+
+void print_scenario_header();
+void print_scenario_result(ScenarioId id, const ScenarioResult& r);
+
+// WasmImpulse entry points: run and print one scenario, or all of them.
+void scenario_bench(int id);
+void scenario_suite();
+
+#endif // SCENARIO_BENCH_H
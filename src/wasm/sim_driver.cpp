@@ -0,0 +1,184 @@
+#include "sim_driver.h"
+#include "agent_grid.h"
+#include "agent_watch.h"
+#include "agent_init.h"
+#include "agent_layout.h"
+#include "model.h"
+#include "navmesh.h"
+#include "nav_utils.h"
+#include "path_workers.h"
+#include "poly_congestion.h"
+#include "math_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+extern AgentSoA agent_data;
+extern Navmesh g_navmesh;
+extern Model g_model;
+extern std::vector<uint8_t> g_wall_contact;
+
+AgentSpawnParams benchmarker_stupid_params() {
+  AgentSpawnParams p;
+  p.intelligence = 0.0f;
+  p.arrivalDesiredSpeed = 0.05f;
+  p.arrivalThresholdSq = 25.0f;
+  return p;
+}
+
+bool spawn_agent(int idx, Point2 position, const AgentSpawnParams& params) {
+  if (idx < 0 || idx >= agent_data.capacity) return false;
+
+  float maxSpeed;
+  if (params.resistance >= 1.0f) maxSpeed = 0.0f;
+  else if (params.resistance <= 0.0f) maxSpeed = std::numeric_limits<float>::infinity();
+  else maxSpeed = params.accel / -std::log(1.0f - params.resistance);
+
+  const int tri = getTriangleFromPoint(position);
+
+  agent_data.positions[idx] = position;
+  agent_data.last_coordinates[idx] = position;
+  agent_data.velocities[idx] = {0.0f, 0.0f};
+  agent_data.looks[idx] = {1.0f, 0.0f};
+  agent_data.states[idx] = AgentState::Standing;
+  agent_data.is_alive[idx] = true;
+
+  agent_data.current_tris[idx] = tri;
+  agent_data.last_valid_tris[idx] = tri;
+
+  agent_data.accels[idx] = params.accel;
+  agent_data.resistances[idx] = params.resistance;
+  agent_data.intelligences[idx] = params.intelligence;
+  agent_data.max_speeds[idx] = maxSpeed;
+
+  agent_data.max_frustrations[idx] = params.maxFrustration;
+  agent_data.arrival_desired_speeds[idx] = params.arrivalDesiredSpeed;
+  agent_data.arrival_threshold_sqs[idx] = params.arrivalThresholdSq;
+  agent_data.look_speeds[idx] = params.lookSpeed;
+
+  agent_data.stuck_ratings[idx] = 0.0f;
+  agent_data.path_frustrations[idx] = 0.0f;
+  agent_data.predicament_ratings[idx] = 0.0f;
+  agent_data.frame_ids[idx] = params.frameId;
+  agent_data.corridors[idx].clear();
+  return true;
+}
+
+int spawn_agent_batch(int first, int count, Point2 minCorner, Point2 maxCorner, const AgentSpawnParams& params, uint64_t* seed) {
+  if (first < 0 || count <= 0 || static_cast<int64_t>(first) + count > agent_data.capacity) return -1;
+  int placed = 0;
+  for (int idx = first; idx < first + count; ++idx) {
+    agent_data.is_alive[idx] = false;
+    for (int attempt = 0; attempt < SPAWN_BATCH_ATTEMPTS; ++attempt) {
+      const Point2 p = {minCorner.x + (maxCorner.x - minCorner.x) * math::seed_to_random_no_advance(seed),
+                        minCorner.y + (maxCorner.y - minCorner.y) * math::seed_to_random_no_advance(seed)};
+      if (getTriangleFromPoint(p) == -1) continue;
+      spawn_agent(idx, p, params);
+      agent_data.last_valid_positions[idx] = p;
+      placed++;
+      break;
+    }
+  }
+  return placed;
+}
+
+int random_triangle_in_area(Point2 center, float numCellExtents, uint64_t* seed) {
+  const SpatialIndex& index = g_navmesh.triangle_index;
+  const float halfExtent = numCellExtents * index.cellSize;
+  const float minX = std::max(center.x - halfExtent, index.minX);
+  const float maxX = std::min(center.x + halfExtent, index.maxX);
+  const float minY = std::max(center.y - halfExtent, index.minY);
+  const float maxY = std::min(center.y + halfExtent, index.maxY);
+
+  const int maxAttempts = 20;
+  for (int i = 0; i < maxAttempts; ++i) {
+    const auto rx = math::seededRandom(*seed);
+    *seed = rx.newSeed;
+    const auto ry = math::seededRandom(*seed);
+    *seed = ry.newSeed;
+    const Point2 p = {minX + rx.value * (maxX - minX), minY + ry.value * (maxY - minY)};
+    const int tri = getTriangleFromPoint(p);
+    if (tri != -1) return tri;
+  }
+
+  std::vector<int> candidates = index.queryArea(minX, minY, maxX, maxY);
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+  const auto r = math::seededRandom(*seed);
+  if (!candidates.empty()) {
+    return candidates[static_cast<size_t>(r.value * candidates.size()) % candidates.size()];
+  }
+  if (g_navmesh.walkable_triangle_count <= 0) return -1;
+  return static_cast<int>(r.value * g_navmesh.walkable_triangle_count) % g_navmesh.walkable_triangle_count;
+}
+
+void send_agent_to_triangle(int idx, int tri) {
+  agent_data.end_targets[idx] = g_navmesh.triangle_centroids[tri];
+  agent_data.end_target_tris[idx] = tri;
+  agent_data.predicament_ratings[idx] = 0.0f;
+  agent_data.states[idx] = AgentState::Traveling;
+}
+
+void update_random_journeys(int active_agents, uint64_t* seed) {
+  for (int i = 0; i < active_agents; ++i) {
+    if (!agent_data.is_alive[i] || agent_data.states[i] != AgentState::Standing) continue;
+
+    // TS hands a copy of the seed to the area search and advances it once afterwards.
+    uint64_t areaSeed = *seed;
+    const int endTri = random_triangle_in_area({0.0f, 0.0f}, 30.0f, &areaSeed);
+    *seed = math::advance_seed(*seed);
+    if (endTri == -1) continue;
+    send_agent_to_triangle(i, endTri);
+  }
+}
+
+Point2 random_point_in_triangle(int tri, uint64_t* seed) {
+  const auto ru = math::seededRandom(*seed);
+  const auto rv = math::seededRandom(ru.newSeed);
+  *seed = rv.newSeed;
+  float u = ru.value;
+  float v = rv.value;
+  if (u + v > 1.0f) {
+    u = 1.0f - u;
+    v = 1.0f - v;
+  }
+  const Point2 a = g_navmesh.vertices[g_navmesh.triangles[tri * 3]];
+  const Point2 b = g_navmesh.vertices[g_navmesh.triangles[tri * 3 + 1]];
+  const Point2 c = g_navmesh.vertices[g_navmesh.triangles[tri * 3 + 2]];
+  return a + (b - a) * u + (c - a) * v;
+}
+
+ScopedAgentSet::ScopedAgentSet(int count)
+  : saved_(agent_data), savedSeed_(g_model.rng_seed), savedTime_(g_model.sim_time), savedFrameCounter_(frame_counter) {
+  reset_path_requests();
+  math::get_rng_state(&savedPcgState_, &savedPcgInc_);
+  frame_counter = 0;
+  const size_t bytes = agent_layout_bytes(count);
+  buffer_ = static_cast<uint8_t*>(std::aligned_alloc(16, bytes));
+  std::memset(buffer_, 0, bytes);
+  bind_agent_columns(agent_data, buffer_, count);
+  agent_data.corridors = new std::vector<int>[count];
+  agent_data.corridor_indices = new int[count]();
+  savedWallContact_.swap(g_wall_contact);
+  g_wall_contact.assign(count, 0);
+  savedWatches_.swap(g_agent_watches);
+  reset_poly_congestion();
+}
+
+ScopedAgentSet::~ScopedAgentSet() {
+  reset_path_requests();
+  delete[] agent_data.corridors;
+  delete[] agent_data.corridor_indices;
+  std::free(buffer_);
+  agent_data = saved_;
+  g_wall_contact.swap(savedWallContact_);
+  g_model.rng_seed = savedSeed_;
+  g_model.sim_time = savedTime_;
+  math::set_rng_state(savedPcgState_, savedPcgInc_);
+  frame_counter = savedFrameCounter_;
+  g_agent_watches.swap(savedWatches_);
+  agent_grid.indexed_agents = -1;
+  reset_poly_congestion();
+}
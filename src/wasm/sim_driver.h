@@ -0,0 +1,77 @@
+#ifndef SIM_DRIVER_H
+#define SIM_DRIVER_H
+
+#include <cstdint>
+#include <vector>
+#include "data_structures.h"
+#include "agent_watch.h"
+
+// C++ ports of the TS agent spawner and RandomJourney brain cell, so headless
+// runs (native runner, scenario benchmarks) drive agents the way the game does.
+
+// Mirrors AgentConfigs.benchmarkerSmart; see AgentConfigs.ts for the other presets.
+struct AgentSpawnParams {
+  float accel = 500.0f;
+  float resistance = 0.9f;
+  float intelligence = 1.0f;
+  float maxFrustration = 4.0f;
+  float arrivalDesiredSpeed = 1.0f;
+  float arrivalThresholdSq = 4.0f;
+  float lookSpeed = 50.0f;
+  uint16_t frameId = 0;
+};
+
+// AgentConfigs.benchmarkerStupid
+AgentSpawnParams benchmarker_stupid_params();
+
+// Mirrors createWasmAgent/createWasmAgentFromPrototype: writes a Standing agent
+// into SoA slot idx. Returns false if idx is outside the agent capacity.
+bool spawn_agent(int idx, Point2 position, const AgentSpawnParams& params);
+
+const int SPAWN_BATCH_ATTEMPTS = 32;  // random points tried per agent
+
+// CMD_SPAWN_BATCH: spawn_agent for slots [first, first + count) at random
+// walkable points of the rect [minCorner, maxCorner]. A slot with no walkable
+// point after SPAWN_BATCH_ATTEMPTS tries is left dead. Returns the number placed,
+// or -1 if the slot range is empty or outside agent capacity.
+int spawn_agent_batch(int first, int count, Point2 minCorner, Point2 maxCorner, const AgentSpawnParams& params, uint64_t* seed);
+
+// Mirrors getRandomTriangleInArea: random walkable triangle within numCellExtents
+// spatial-index cells of center, or -1.
+int random_triangle_in_area(Point2 center, float numCellExtents, uint64_t* seed);
+
+// Sets the agent Traveling towards the centroid of walkable triangle tri.
+void send_agent_to_triangle(int idx, int tri);
+
+// Mirrors update_random_journey: every Standing agent gets a random end target.
+void update_random_journeys(int active_agents, uint64_t* seed);
+
+// Uniform random point inside triangle tri.
+Point2 random_point_in_triangle(int tri, uint64_t* seed);
+
+// Swaps agent_data and the per-agent state main.cpp owns for a private, zeroed
+// set of `count` agents; everything is restored on destruction, so a live game
+// keeps its agents while benchmarks run. The math:: RNG and the grid's
+// frame_counter are saved too (frame_counter restarts at 0), and queued path
+// requests are dropped on the way in and out so none lands in the wrong set.
+class ScopedAgentSet {
+public:
+  explicit ScopedAgentSet(int count);
+  ~ScopedAgentSet();
+
+  ScopedAgentSet(const ScopedAgentSet&) = delete;
+  ScopedAgentSet& operator=(const ScopedAgentSet&) = delete;
+
+private:
+  AgentSoA saved_;
+  uint64_t savedSeed_;
+  float savedTime_;
+  uint64_t savedPcgState_ = 0;
+  uint64_t savedPcgInc_ = 0;
+  int savedFrameCounter_;
+  AgentWatchList savedWatches_;
+  std::vector<uint8_t> savedWallContact_;
+  uint8_t* buffer_ = nullptr;
+};
+
+#endif // SIM_DRIVER_H
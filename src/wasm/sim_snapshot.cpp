@@ -0,0 +1,340 @@
+#include "sim_snapshot.h"
+#include "agent_grid.h"
+#include "agent_layout.h"
+#include "data_structures.h"
+#include "math_utils.h"
+#include "model.h"
+#include "path_workers.h"
+#include "agent_watch.h"
+#include "poly_congestion.h"
+#include <stdio.h>
+#include <cstring>
+
+extern AgentSoA agent_data;
+extern Model g_model;
+extern std::vector<uint8_t> g_wall_contact;
+
+namespace {
+
+// A literal run ends once this many zero bytes follow it, so short zero gaps
+// inside changed data do not cost a pair header each.
+const size_t DELTA_MIN_ZERO_RUN = 4;
+
+uint32_t fnv1a(const uint8_t* data, size_t bytes, uint32_t hash = 2166136261u) {
+  for (size_t i = 0; i < bytes; ++i) {
+    hash ^= data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+uint32_t agent_layout_hash() {
+  uint32_t hash = 2166136261u;
+#define X(name, member, ctype, type, group, align) \
+  hash = fnv1a(reinterpret_cast<const uint8_t*>(#name), sizeof(#name) - 1, hash); \
+  { const uint32_t size = sizeof(ctype); hash = fnv1a(reinterpret_cast<const uint8_t*>(&size), 4, hash); }
+  AGENT_COLUMNS(X)
+#undef X
+  return hash;
+}
+
+void put(std::vector<uint8_t>& out, const void* data, size_t bytes) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  out.insert(out.end(), p, p + bytes);
+}
+
+template<typename T>
+void put_value(std::vector<uint8_t>& out, T value) {
+  put(out, &value, sizeof(T));
+}
+
+// Bounds-checked cursor over a decoded payload.
+struct PayloadReader {
+  const uint8_t* data;
+  size_t size;
+  size_t pos = 0;
+
+  const uint8_t* take(size_t bytes) {
+    if (bytes > size - pos) return nullptr;
+    const uint8_t* p = data + pos;
+    pos += bytes;
+    return p;
+  }
+
+  template<typename T>
+  bool value(T* out) {
+    const uint8_t* p = take(sizeof(T));
+    if (!p) return false;
+    std::memcpy(out, p, sizeof(T));
+    return true;
+  }
+};
+
+void write_raw_payload(int n, std::vector<uint8_t>& raw) {
+  uint64_t pcgState = 0;
+  uint64_t pcgInc = 0;
+  math::get_rng_state(&pcgState, &pcgInc);
+  put_value<uint64_t>(raw, g_model.rng_seed);
+  put_value<uint64_t>(raw, pcgState);
+  put_value<uint64_t>(raw, pcgInc);
+  put_value<float>(raw, g_model.sim_time);
+  put_value<int32_t>(raw, frame_counter);
+
+#define X(name, member, ctype, type, group, align) put(raw, agent_data.member, sizeof(ctype) * n);
+  AGENT_COLUMNS(X)
+#undef X
+
+  put(raw, agent_data.corridor_indices, sizeof(int) * n);
+  for (int i = 0; i < n; ++i) {
+    put_value<uint8_t>(raw, i < static_cast<int>(g_wall_contact.size()) ? g_wall_contact[i] : 0);
+  }
+  for (int i = 0; i < n; ++i) put_value<uint32_t>(raw, static_cast<uint32_t>(agent_data.corridors[i].size()));
+  for (int i = 0; i < n; ++i) put(raw, agent_data.corridors[i].data(), sizeof(int) * agent_data.corridors[i].size());
+
+  PolyCongestionState congestion;
+  get_poly_congestion_state(congestion);
+  put_value<uint32_t>(raw, static_cast<uint32_t>(congestion.crowding.size()));
+  put_value<uint32_t>(raw, static_cast<uint32_t>(congestion.agent_poly.size()));
+  put_value<int32_t>(raw, congestion.frames);
+  put_value<float>(raw, congestion.elapsed);
+  put(raw, congestion.crowding.data(), sizeof(float) * congestion.crowding.size());
+  put(raw, congestion.counts.data(), sizeof(uint32_t) * congestion.counts.size());
+  put(raw, congestion.agent_poly.data(), sizeof(int32_t) * congestion.agent_poly.size());
+}
+
+// Reads the congestion layer written by write_raw_payload.
+bool read_congestion(PayloadReader& in, PolyCongestionState& out) {
+  uint32_t polys = 0, agents = 0;
+  if (!in.value(&polys) || !in.value(&agents) || !in.value(&out.frames) || !in.value(&out.elapsed)) return false;
+  const uint8_t* crowding = in.take(sizeof(float) * static_cast<size_t>(polys));
+  const uint8_t* counts = in.take(sizeof(uint32_t) * static_cast<size_t>(polys));
+  const uint8_t* agentPoly = in.take(sizeof(int32_t) * static_cast<size_t>(agents));
+  if (!crowding || !counts || !agentPoly) return false;
+  out.crowding.resize(polys);
+  out.counts.resize(polys);
+  out.agent_poly.resize(agents);
+  if (polys > 0) {
+    std::memcpy(out.crowding.data(), crowding, sizeof(float) * polys);
+    std::memcpy(out.counts.data(), counts, sizeof(uint32_t) * polys);
+  }
+  if (agents > 0) std::memcpy(out.agent_poly.data(), agentPoly, sizeof(int32_t) * agents);
+  return true;
+}
+
+void put_varint(std::vector<uint8_t>& out, size_t v) {
+  while (v >= 0x80) {
+    out.push_back(static_cast<uint8_t>(v) | 0x80);
+    v >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(v));
+}
+
+bool get_varint(PayloadReader& in, size_t* v) {
+  *v = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    uint8_t b = 0;
+    if (!in.value(&b)) return false;
+    *v |= static_cast<size_t>(b & 0x7F) << shift;
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
+
+inline uint8_t base_byte(const uint8_t* base, size_t baseSize, size_t i) {
+  return i < baseSize ? base[i] : 0;
+}
+
+void encode_delta(const std::vector<uint8_t>& raw, const uint8_t* base, size_t baseSize, std::vector<uint8_t>& out) {
+  const size_t n = raw.size();
+  size_t i = 0;
+  while (i < n) {
+    const size_t zeroStart = i;
+    while (i < n && raw[i] == base_byte(base, baseSize, i)) ++i;
+    const size_t literalStart = i;
+    size_t zeros = 0;
+    while (i < n && zeros < DELTA_MIN_ZERO_RUN) {
+      zeros = raw[i] == base_byte(base, baseSize, i) ? zeros + 1 : 0;
+      ++i;
+    }
+    const size_t literalEnd = zeros >= DELTA_MIN_ZERO_RUN ? i - zeros : i;
+    i = literalEnd;
+    put_varint(out, literalStart - zeroStart);
+    put_varint(out, literalEnd - literalStart);
+    for (size_t k = literalStart; k < literalEnd; ++k) out.push_back(raw[k] ^ base_byte(base, baseSize, k));
+  }
+}
+
+bool decode_delta(PayloadReader in, size_t rawBytes, const uint8_t* base, size_t baseSize, std::vector<uint8_t>& raw) {
+  raw.clear();
+  raw.reserve(rawBytes);
+  while (raw.size() < rawBytes) {
+    size_t zeros = 0;
+    size_t literals = 0;
+    if (!get_varint(in, &zeros) || !get_varint(in, &literals)) return false;
+    if (zeros + literals > rawBytes - raw.size()) return false;
+    raw.insert(raw.end(), zeros, 0);
+    const uint8_t* p = in.take(literals);
+    if (!p) return false;
+    raw.insert(raw.end(), p, p + literals);
+  }
+  for (size_t i = 0; i < rawBytes; ++i) raw[i] ^= base_byte(base, baseSize, i);
+  return in.pos == in.size;
+}
+
+// Header of a keyframe usable as delta base, or nullptr.
+const SimSnapshotHeader* keyframe_header(const uint8_t* base, uint32_t baseBytes) {
+  if (!base || baseBytes < sizeof(SimSnapshotHeader)) return nullptr;
+  const SimSnapshotHeader* h = reinterpret_cast<const SimSnapshotHeader*>(base);
+  if (h->magic != SIM_SNAPSHOT_MAGIC || h->version != SIM_SNAPSHOT_VERSION || (h->flags & SIM_SNAPSHOT_DELTA)) return nullptr;
+  if (h->raw_bytes != baseBytes - sizeof(SimSnapshotHeader)) return nullptr;
+  return h;
+}
+
+} // namespace
+
+bool capture_simulation_snapshot(int activeAgents, std::vector<uint8_t>& out, const uint8_t* base, uint32_t baseBytes) {
+  if (activeAgents < 0 || activeAgents > agent_data.capacity || (activeAgents > 0 && !agent_data.corridors)) {
+    printf("[WASM] capture_simulation_snapshot: %d active agents but capacity %d\n", activeAgents, agent_data.capacity);
+    return false;
+  }
+  const SimSnapshotHeader* baseHeader = nullptr;
+  if (base) {
+    baseHeader = keyframe_header(base, baseBytes);
+    if (!baseHeader) {
+      printf("[WASM] capture_simulation_snapshot: delta base is not a keyframe snapshot\n");
+      return false;
+    }
+  }
+
+  std::vector<uint8_t> raw;
+  write_raw_payload(activeAgents, raw);
+
+  SimSnapshotHeader header;
+  header.magic = SIM_SNAPSHOT_MAGIC;
+  header.version = SIM_SNAPSHOT_VERSION;
+  header.flags = baseHeader ? static_cast<uint32_t>(SIM_SNAPSHOT_DELTA) : 0u;
+  header.layout_hash = agent_layout_hash();
+  header.active_agents = static_cast<uint32_t>(activeAgents);
+  header.raw_bytes = static_cast<uint32_t>(raw.size());
+  header.raw_checksum = fnv1a(raw.data(), raw.size());
+  header.base_checksum = baseHeader ? baseHeader->raw_checksum : 0;
+
+  out.clear();
+  put(out, &header, sizeof(header));
+  if (baseHeader) {
+    encode_delta(raw, base + sizeof(SimSnapshotHeader), baseHeader->raw_bytes, out);
+  } else {
+    put(out, raw.data(), raw.size());
+  }
+  return true;
+}
+
+int restore_simulation_snapshot(const uint8_t* data, uint32_t bytes, const uint8_t* base, uint32_t baseBytes) {
+  if (!data || bytes < sizeof(SimSnapshotHeader)) {
+    printf("[WASM] restore_simulation_snapshot: snapshot too small (%u bytes)\n", bytes);
+    return -1;
+  }
+  SimSnapshotHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != SIM_SNAPSHOT_MAGIC || header.version != SIM_SNAPSHOT_VERSION) {
+    printf("[WASM] restore_simulation_snapshot: not a version %u snapshot\n", SIM_SNAPSHOT_VERSION);
+    return -1;
+  }
+  if (header.layout_hash != agent_layout_hash()) {
+    printf("[WASM] restore_simulation_snapshot: snapshot was taken with a different agent column layout\n");
+    return -1;
+  }
+  const int n = static_cast<int>(header.active_agents);
+  if (n > agent_data.capacity || (n > 0 && !agent_data.corridors)) {
+    printf("[WASM] restore_simulation_snapshot: snapshot has %d agents but capacity is %d\n", n, agent_data.capacity);
+    return -1;
+  }
+
+  const PayloadReader payload{data + sizeof(header), bytes - sizeof(header)};
+  std::vector<uint8_t> decoded;
+  const uint8_t* raw = payload.data;
+  if (header.flags & SIM_SNAPSHOT_DELTA) {
+    const SimSnapshotHeader* baseHeader = keyframe_header(base, baseBytes);
+    if (!baseHeader || baseHeader->raw_checksum != header.base_checksum) {
+      printf("[WASM] restore_simulation_snapshot: delta needs the keyframe it was taken against\n");
+      return -1;
+    }
+    if (!decode_delta(payload, header.raw_bytes, base + sizeof(SimSnapshotHeader), baseHeader->raw_bytes, decoded)) {
+      printf("[WASM] restore_simulation_snapshot: corrupt delta payload\n");
+      return -1;
+    }
+    raw = decoded.data();
+  } else if (payload.size != header.raw_bytes) {
+    printf("[WASM] restore_simulation_snapshot: payload is %zu bytes, header says %u\n", payload.size, header.raw_bytes);
+    return -1;
+  }
+  if (fnv1a(raw, header.raw_bytes) != header.raw_checksum) {
+    printf("[WASM] restore_simulation_snapshot: checksum mismatch\n");
+    return -1;
+  }
+
+  // Validate the whole payload before touching any state.
+  PayloadReader in{raw, header.raw_bytes};
+  uint64_t modelSeed = 0, pcgState = 0, pcgInc = 0;
+  float simTime = 0.0f;
+  int32_t frameCounter = 0;
+  if (!in.value(&modelSeed) || !in.value(&pcgState) || !in.value(&pcgInc) || !in.value(&simTime) || !in.value(&frameCounter)) {
+    printf("[WASM] restore_simulation_snapshot: truncated snapshot\n");
+    return -1;
+  }
+  size_t columnBytes = 0;
+#define X(name, member, ctype, type, group, align) columnBytes += sizeof(ctype) * n;
+  AGENT_COLUMNS(X)
+#undef X
+  const uint8_t* columns = in.take(columnBytes);
+  const uint8_t* corridorIndices = in.take(sizeof(int) * n);
+  const uint8_t* wallContact = in.take(n);
+  const uint8_t* corridorLengths = in.take(sizeof(uint32_t) * n);
+  size_t corridorWords = 0;
+  for (int i = 0; corridorLengths && i < n; ++i) {
+    uint32_t len = 0;
+    std::memcpy(&len, corridorLengths + i * sizeof(uint32_t), sizeof(len));
+    corridorWords += len;
+  }
+  const uint8_t* corridorData = in.take(sizeof(int) * corridorWords);
+  PolyCongestionState congestion;
+  if (!columns || !corridorIndices || !wallContact || !corridorLengths || (!corridorData && corridorWords > 0) ||
+      !read_congestion(in, congestion) || in.pos != in.size) {
+    printf("[WASM] restore_simulation_snapshot: truncated snapshot\n");
+    return -1;
+  }
+  if (!poly_congestion_state_fits(congestion)) {
+    printf("[WASM] restore_simulation_snapshot: congestion layer does not match the navmesh\n");
+    return -1;
+  }
+
+  // Requests in flight belong to the replaced state.
+  reset_path_requests();
+  reset_agent_watches();
+  set_poly_congestion_state(congestion);
+  g_model.rng_seed = modelSeed;
+  g_model.sim_time = simTime;
+  math::set_rng_state(pcgState, pcgInc);
+  frame_counter = frameCounter;
+  agent_grid.indexed_agents = -1;  // indexes the replaced positions until the next step
+
+  const uint8_t* column = columns;
+#define X(name, member, ctype, type, group, align) \
+  std::memcpy(agent_data.member, column, sizeof(ctype) * n); \
+  column += sizeof(ctype) * n;
+  AGENT_COLUMNS(X)
+#undef X
+
+  std::memcpy(agent_data.corridor_indices, corridorIndices, sizeof(int) * n);
+  if (g_wall_contact.size() < static_cast<size_t>(n)) g_wall_contact.resize(n, 0);
+  std::memcpy(g_wall_contact.data(), wallContact, n);
+  const uint8_t* corridor = corridorData;
+  for (int i = 0; i < n; ++i) {
+    uint32_t len = 0;
+    std::memcpy(&len, corridorLengths + i * sizeof(uint32_t), sizeof(len));
+    agent_data.corridors[i].resize(len);
+    if (len > 0) std::memcpy(agent_data.corridors[i].data(), corridor, sizeof(int) * len);
+    corridor += sizeof(int) * len;
+  }
+  return n;
+}
@@ -0,0 +1,50 @@
+#ifndef SIM_SNAPSHOT_H
+#define SIM_SNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+
+// Versioned binary snapshot of the running simulation: the AgentSoA columns of
+// the active agents, their corridors and corridor indices, wall contact flags,
+// both RNGs (Model::rng_seed and the math:: PCG32 state), sim_time, the
+// agent grid frame_counter and the polygon congestion layer. Restoring a snapshot and stepping gives bit-exact
+// the same results as stepping the original, so benchmarks can start from an
+// identical warm state. The agent grid itself is rebuilt every step and the
+// navmesh is not included; restore into a simulation with the same navmesh.
+// Pending CMD_FIND_PATH requests are not captured; restoring drops them.
+//
+// Layout: SimSnapshotHeader, then the payload. A keyframe stores the raw payload;
+// a delta stores the payload XORed with a keyframe's raw payload, encoded as
+// (zero run varint, literal count varint, literal bytes) pairs.
+
+const uint32_t SIM_SNAPSHOT_MAGIC = 0x50414E53; // "SNAP"
+const uint32_t SIM_SNAPSHOT_VERSION = 2;  // 2 added the congestion layer
+
+enum SimSnapshotFlags : uint32_t {
+  SIM_SNAPSHOT_DELTA = 1u << 0,
+};
+
+struct SimSnapshotHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t flags;
+  uint32_t layout_hash;   // AGENT_COLUMNS names and element sizes
+  uint32_t active_agents;
+  uint32_t raw_bytes;     // decoded payload size
+  uint32_t raw_checksum;  // FNV-1a of the decoded payload
+  uint32_t base_checksum; // raw_checksum of the keyframe a delta applies to, else 0
+};
+
+// Serializes the first activeAgents agents into out. With a keyframe as base
+// (and base != nullptr) the payload is delta-encoded against it.
+// Returns false if the state cannot be captured or base is not a keyframe.
+bool capture_simulation_snapshot(int activeAgents, std::vector<uint8_t>& out,
+                                 const uint8_t* base = nullptr, uint32_t baseBytes = 0);
+
+// Restores a snapshot taken by capture_simulation_snapshot. Deltas need the keyframe
+// they were encoded against. Returns the snapshot's active agent count, or -1
+// on a corrupt/mismatching snapshot, in which case the simulation is untouched.
+int restore_simulation_snapshot(const uint8_t* data, uint32_t bytes,
+                                const uint8_t* base = nullptr, uint32_t baseBytes = 0);
+
+#endif // SIM_SNAPSHOT_H
@@ -0,0 +1,98 @@
+#include "sim_thread.h"
+#include "model.h"
+#include "event_buffer.h"
+#include "event_handler.h"
+#include "render_snapshot.h"
+#include "wasm_log.h"
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+extern Model g_model;
+
+std::mutex g_sim_mutex;
+
+namespace {
+std::thread g_thread;
+std::atomic<bool> g_running{false};
+std::atomic<int> g_active_agents{0};
+// Pending simulated seconds posted by the main thread, not yet consumed by ticks.
+std::atomic<float> g_time_budget{0.0f};
+float g_tick_dt = 1.0f / 60.0f;
+int g_max_ticks_per_wake = 4;
+
+void add_budget(float dt) {
+  float cur = g_time_budget.load(std::memory_order_relaxed);
+  while (!g_time_budget.compare_exchange_weak(cur, cur + dt, std::memory_order_relaxed)) {}
+}
+
+bool take_tick() {
+  float cur = g_time_budget.load(std::memory_order_relaxed);
+  while (cur >= g_tick_dt) {
+    if (g_time_budget.compare_exchange_weak(cur, cur - g_tick_dt, std::memory_order_relaxed)) return true;
+  }
+  return false;
+}
+
+void simulation_loop() {
+  const auto tickDuration = std::chrono::duration<float>(g_tick_dt);
+  auto nextWake = std::chrono::steady_clock::now();
+
+  while (g_running.load(std::memory_order_acquire)) {
+    int ticks = 0;
+    while (ticks < g_max_ticks_per_wake && take_tick()) {
+      std::lock_guard<std::mutex> lock(g_sim_mutex);
+      const int activeAgents = g_active_agents.load(std::memory_order_acquire);
+      // The event rings need no handoff: every tick takes whatever commands
+      // TS has published and publishes its own events.
+      const NavConstants nc = load_nav_constants();
+      process_events(nc);
+      g_model.step(g_tick_dt, activeAgents, nc);
+      g_model.emit_events(activeAgents);
+      g_render_snapshot.publish(activeAgents, g_model.sim_time);
+      ticks++;
+    }
+
+    // Drop budget we could not catch up on instead of spiralling.
+    if (ticks == g_max_ticks_per_wake) {
+      float cur = g_time_budget.load(std::memory_order_relaxed);
+      if (cur > g_tick_dt * g_max_ticks_per_wake) g_time_budget.store(0.0f, std::memory_order_relaxed);
+    }
+
+    nextWake += std::chrono::duration_cast<std::chrono::steady_clock::duration>(tickDuration);
+    const auto now = std::chrono::steady_clock::now();
+    if (nextWake < now) nextWake = now;
+    std::this_thread::sleep_until(nextWake);
+  }
+}
+} // namespace
+
+bool start_simulation_thread(float tick_dt, int max_ticks_per_wake) {
+  if (!WASM_THREADS) {
+    printf("[WASM] start_simulation_thread: built without threads (make THREADS=1)\n");
+    return false;
+  }
+  if (g_running.load()) return true;
+  g_tick_dt = tick_dt > 0.0f ? tick_dt : 1.0f / 60.0f;
+  g_max_ticks_per_wake = max_ticks_per_wake > 0 ? max_ticks_per_wake : 1;
+  g_time_budget.store(0.0f);
+  g_running.store(true, std::memory_order_release);
+  g_thread = std::thread(simulation_loop);
+  return true;
+}
+
+void stop_simulation_thread() {
+  if (!g_running.load()) return;
+  g_running.store(false, std::memory_order_release);
+  if (g_thread.joinable()) g_thread.join();
+}
+
+bool is_simulation_threaded() {
+  return g_running.load(std::memory_order_acquire);
+}
+
+void post_simulation_frame(float sim_dt, int active_agents) {
+  g_active_agents.store(active_agents, std::memory_order_release);
+  if (sim_dt > 0.0f) add_budget(sim_dt);
+}
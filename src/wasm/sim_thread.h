@@ -0,0 +1,34 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include <mutex>
+
+// 0 in a wasm build without -pthread (make THREADS=0), where std::thread
+// cannot start: the simulation thread stays off, and path searches and index
+// builds run on the calling thread.
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define WASM_THREADS 0
+#else
+#define WASM_THREADS 1
+#endif
+
+// Runs Model::step on a dedicated thread at a fixed tick. The main thread feeds
+// it simulated time (already scaled/paused by TS) and shares agent data under
+// g_sim_mutex; commands and events flow through the SPSC rings of
+// event_buffer.h, and rendering reads g_render_snapshot, without the lock.
+// False if this build has no threads.
+bool start_simulation_thread(float tick_dt, int max_ticks_per_wake);
+void stop_simulation_thread();
+bool is_simulation_threaded();
+
+// Called by the main thread once per display frame, after publishing its
+// commands. Adds sim_dt to the time budget; every tick processes the commands
+// published so far. Agent slots from active_agents on belong to TS until this
+// call, so it may fill fresh slots without the lock.
+void post_simulation_frame(float sim_dt, int active_agents);
+
+// Held by the sim thread for each tick. TS only takes it for whole-state
+// operations (snapshots); per-frame agent changes go through the command ring.
+extern std::mutex g_sim_mutex;
+
+#endif // SIM_THREAD_H
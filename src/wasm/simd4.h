@@ -0,0 +1,176 @@
+#ifndef SIMD4_H
+#define SIMD4_H
+
+// Minimal 4-lane float abstraction used by the batched physics kernels.
+// In the wasm build it maps onto wasm_simd128 intrinsics (-msimd128); other
+// compilers get a GCC/Clang vector-extension fallback with the same semantics
+// so kernels can be compiled and checked natively.
+// Masks are f4 values whose lanes are all-ones (true) or all-zeros (false).
+// i4 holds four int32 lanes for packing results into integer formats.
+
+#include <cmath>
+#include <cstdint>
+#include "point2.h"
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+namespace simd4 {
+
+#if defined(__wasm_simd128__)
+
+typedef v128_t f4;
+typedef v128_t i4;
+
+inline f4 splat(float v) { return wasm_f32x4_splat(v); }
+inline f4 set(float a, float b, float c, float d) { return wasm_f32x4_make(a, b, c, d); }
+inline f4 load(const float* p) { return wasm_v128_load(p); }
+inline void store(float* p, f4 v) { wasm_v128_store(p, v); }
+
+inline f4 add(f4 a, f4 b) { return wasm_f32x4_add(a, b); }
+inline f4 sub(f4 a, f4 b) { return wasm_f32x4_sub(a, b); }
+inline f4 mul(f4 a, f4 b) { return wasm_f32x4_mul(a, b); }
+inline f4 div(f4 a, f4 b) { return wasm_f32x4_div(a, b); }
+inline f4 sqrt(f4 a) { return wasm_f32x4_sqrt(a); }
+inline f4 min(f4 a, f4 b) { return wasm_f32x4_pmin(a, b); }
+inline f4 max(f4 a, f4 b) { return wasm_f32x4_pmax(a, b); }
+
+inline f4 lt(f4 a, f4 b) { return wasm_f32x4_lt(a, b); }
+inline f4 gt(f4 a, f4 b) { return wasm_f32x4_gt(a, b); }
+inline f4 mask_and(f4 a, f4 b) { return wasm_v128_and(a, b); }
+inline f4 mask_or(f4 a, f4 b) { return wasm_v128_or(a, b); }
+// Lane-wise mask ? a : b
+inline f4 select(f4 mask, f4 a, f4 b) { return wasm_v128_bitselect(a, b, mask); }
+inline bool any(f4 mask) { return wasm_v128_any_true(mask); }
+
+inline f4 mask_from_bools(bool a, bool b, bool c, bool d) {
+  return wasm_i32x4_make(a ? -1 : 0, b ? -1 : 0, c ? -1 : 0, d ? -1 : 0);
+}
+
+// Deinterleave four consecutive Point2 into x and y lanes.
+inline void load_xy(const Point2* p, f4& x, f4& y) {
+  const f4 lo = wasm_v128_load(&p[0]);
+  const f4 hi = wasm_v128_load(&p[2]);
+  x = wasm_i32x4_shuffle(lo, hi, 0, 2, 4, 6);
+  y = wasm_i32x4_shuffle(lo, hi, 1, 3, 5, 7);
+}
+
+inline void store_xy(Point2* p, f4 x, f4 y) {
+  wasm_v128_store(&p[0], wasm_i32x4_shuffle(x, y, 0, 4, 1, 5));
+  wasm_v128_store(&p[2], wasm_i32x4_shuffle(x, y, 2, 6, 3, 7));
+}
+
+inline i4 splat_i(int32_t v) { return wasm_i32x4_splat(v); }
+inline i4 set_i(int32_t a, int32_t b, int32_t c, int32_t d) { return wasm_i32x4_make(a, b, c, d); }
+// Truncates toward zero; lanes must already be in int32 range.
+inline i4 to_int(f4 a) { return wasm_i32x4_trunc_sat_f32x4(a); }
+inline i4 and_i(i4 a, i4 b) { return wasm_v128_and(a, b); }
+inline i4 or_i(i4 a, i4 b) { return wasm_v128_or(a, b); }
+inline i4 shl_i(i4 a, int bits) { return wasm_i32x4_shl(a, bits); }
+
+// Writes four records of four uint16 {a[l], b[l], c[l], d[l]} for lanes
+// l = 0..3, saturating each lane to 0..65535.
+inline void store_u16_quads(uint16_t* p, i4 a, i4 b, i4 c, i4 d) {
+  const v128_t ab = wasm_u16x8_narrow_i32x4(a, b);  // a0..a3 b0..b3
+  const v128_t cd = wasm_u16x8_narrow_i32x4(c, d);
+  wasm_v128_store(p, wasm_i16x8_shuffle(ab, cd, 0, 4, 8, 12, 1, 5, 9, 13));
+  wasm_v128_store(p + 8, wasm_i16x8_shuffle(ab, cd, 2, 6, 10, 14, 3, 7, 11, 15));
+}
+
+#else
+
+typedef float f4 __attribute__((vector_size(16)));
+typedef int32_t i4 __attribute__((vector_size(16)));
+
+inline f4 splat(float v) { return f4{v, v, v, v}; }
+inline f4 set(float a, float b, float c, float d) { return f4{a, b, c, d}; }
+inline f4 load(const float* p) { return f4{p[0], p[1], p[2], p[3]}; }
+inline void store(float* p, f4 v) { p[0] = v[0]; p[1] = v[1]; p[2] = v[2]; p[3] = v[3]; }
+
+inline f4 add(f4 a, f4 b) { return a + b; }
+inline f4 sub(f4 a, f4 b) { return a - b; }
+inline f4 mul(f4 a, f4 b) { return a * b; }
+inline f4 div(f4 a, f4 b) { return a / b; }
+inline f4 sqrt(f4 a) { return f4{std::sqrt(a[0]), std::sqrt(a[1]), std::sqrt(a[2]), std::sqrt(a[3])}; }
+inline f4 min(f4 a, f4 b) {
+  return f4{b[0] < a[0] ? b[0] : a[0], b[1] < a[1] ? b[1] : a[1], b[2] < a[2] ? b[2] : a[2], b[3] < a[3] ? b[3] : a[3]};
+}
+inline f4 max(f4 a, f4 b) {
+  return f4{a[0] < b[0] ? b[0] : a[0], a[1] < b[1] ? b[1] : a[1], a[2] < b[2] ? b[2] : a[2], a[3] < b[3] ? b[3] : a[3]};
+}
+
+inline f4 lt(f4 a, f4 b) { return reinterpret_cast<f4>(a < b); }
+inline f4 gt(f4 a, f4 b) { return reinterpret_cast<f4>(a > b); }
+inline f4 mask_and(f4 a, f4 b) { return reinterpret_cast<f4>(reinterpret_cast<i4>(a) & reinterpret_cast<i4>(b)); }
+inline f4 mask_or(f4 a, f4 b) { return reinterpret_cast<f4>(reinterpret_cast<i4>(a) | reinterpret_cast<i4>(b)); }
+inline f4 select(f4 mask, f4 a, f4 b) {
+  const i4 m = reinterpret_cast<i4>(mask);
+  return reinterpret_cast<f4>((reinterpret_cast<i4>(a) & m) | (reinterpret_cast<i4>(b) & ~m));
+}
+inline bool any(f4 mask) {
+  const i4 m = reinterpret_cast<i4>(mask);
+  return (m[0] | m[1] | m[2] | m[3]) != 0;
+}
+
+inline f4 mask_from_bools(bool a, bool b, bool c, bool d) {
+  return reinterpret_cast<f4>(i4{a ? -1 : 0, b ? -1 : 0, c ? -1 : 0, d ? -1 : 0});
+}
+
+inline void load_xy(const Point2* p, f4& x, f4& y) {
+  x = f4{p[0].x, p[1].x, p[2].x, p[3].x};
+  y = f4{p[0].y, p[1].y, p[2].y, p[3].y};
+}
+
+inline void store_xy(Point2* p, f4 x, f4 y) {
+  for (int l = 0; l < 4; ++l) {
+    p[l].x = x[l];
+    p[l].y = y[l];
+  }
+}
+
+inline i4 splat_i(int32_t v) { return i4{v, v, v, v}; }
+inline i4 set_i(int32_t a, int32_t b, int32_t c, int32_t d) { return i4{a, b, c, d}; }
+inline i4 to_int(f4 a) { return __builtin_convertvector(a, i4); }
+inline i4 and_i(i4 a, i4 b) { return a & b; }
+inline i4 or_i(i4 a, i4 b) { return a | b; }
+inline i4 shl_i(i4 a, int bits) { return a << bits; }
+
+inline i4 saturate_u16(i4 v) {
+  const i4 zero = splat_i(0);
+  const i4 top = splat_i(65535);
+  v = v < zero ? zero : v;
+  return v > top ? top : v;
+}
+
+inline void store_u16_quads(uint16_t* p, i4 a, i4 b, i4 c, i4 d) {
+  a = saturate_u16(a);
+  b = saturate_u16(b);
+  c = saturate_u16(c);
+  d = saturate_u16(d);
+  for (int l = 0; l < 4; ++l) {
+    p[l * 4 + 0] = static_cast<uint16_t>(a[l]);
+    p[l * 4 + 1] = static_cast<uint16_t>(b[l]);
+    p[l * 4 + 2] = static_cast<uint16_t>(c[l]);
+    p[l * 4 + 3] = static_cast<uint16_t>(d[l]);
+  }
+}
+
+#endif
+
+inline f4 length_sq(f4 x, f4 y) { return add(mul(x, x), mul(y, y)); }
+inline f4 dot(f4 ax, f4 ay, f4 bx, f4 by) { return add(mul(ax, bx), mul(ay, by)); }
+inline f4 lerp(f4 a, f4 b, f4 t) { return add(a, mul(t, sub(b, a))); }
+
+// Matches math::normalize_inplace: zero-length vectors become {0,0}.
+inline void normalize_inplace(f4& x, f4& y) {
+  const f4 len = sqrt(length_sq(x, y));
+  const f4 ok = gt(len, splat(0.0f));
+  const f4 safeLen = select(ok, len, splat(1.0f));
+  x = select(ok, div(x, safeLen), splat(0.0f));
+  y = select(ok, div(y, safeLen), splat(0.0f));
+}
+
+} // namespace simd4
+
+#endif // SIMD4_H
@@ -0,0 +1,49 @@
+# Simulation core sources shared by the emscripten build (Makefile) and the
+# native host build (native/Makefile). Web-only sources are listed in Makefile.
+CORE_SRCS = main.cpp \
+     model.cpp \
+     math_utils.cpp \
+     init_navmesh.cpp \
+     navmesh_format.cpp \
+     navmesh.cpp \
+     spatial_index.cpp \
+     nav_utils.cpp \
+     nav_batch.cpp \
+     raycasting.cpp \
+     fast_priority_queue.cpp \
+     path_corridor.cpp \
+     path_workers.cpp \
+     path_corners.cpp \
+     poly_congestion.cpp \
+     path_patching.cpp \
+     agent_move_phys.cpp \
+     agent_navigation.cpp \
+     agent_nav_utils.cpp \
+     agent_grid.cpp \
+     agent_collision.cpp \
+     agent_statistic.cpp \
+     agent_init.cpp \
+     agent_watch.cpp \
+     populate_triangle_index.cpp \
+     populate_polygon_index.cpp \
+     populate_building_index.cpp \
+     populate_blob_index.cpp \
+     populate_spatial_index.cpp \
+     point_in_triangle_bench.cpp \
+     point_in_polygon_bench.cpp \
+     phys_simd_bench.cpp \
+     nav_constants_bench.cpp \
+     wasm_impulse.cpp \
+     event_buffer.cpp \
+     event_handler.cpp \
+     render_snapshot.cpp \
+     sprite_instances.cpp \
+     sim_thread.cpp \
+     trace_log.cpp \
+     profiler.cpp \
+     nav_telemetry.cpp \
+     sim_driver.cpp \
+     sim_snapshot.cpp \
+     scenario_bench.cpp \
+     microbench.cpp \
+     navmesh_microbench.cpp
@@ -0,0 +1,225 @@
+#include "sprite_instances.h"
+#include "agent_grid.h"
+#include "simd4.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Branch-free: off-screen agents are scattered at random, so the outcome
+// would be mispredicted about as often as not.
+bool in_rect(const BoundingBox& r, float x, float y) {
+  return (x >= r.minX) & (x <= r.maxX) & (y >= r.minY) & (y <= r.maxY);
+}
+
+bool contains(const BoundingBox& outer, const BoundingBox& inner) {
+  return inner.minX >= outer.minX && inner.maxX <= outer.maxX && inner.minY >= outer.minY && inner.maxY <= outer.maxY;
+}
+
+// Agents the grid holds in the cells overlapping view.
+int indexed_in(const BoundingBox& view, const AgentGridData& grid) {
+  int x0, y0, x1, y1;
+  if (!agent_grid_cell_range(view, &x0, &y0, &x1, &y1)) return 0;
+  int total = 0;
+  for (int gy = y0; gy <= y1; ++gy) {
+    for (int gx = x0; gx <= x1; ++gx) total += grid.cell_counts[agent_grid_cell_index(gx, gy)];
+  }
+  return total;
+}
+
+const float QUANT_MAX = 65535.0f;
+const float ROT_MAX = 127.0f;
+// Rounding is floor(v + 0.5) by truncation, so rotations (-127..127) are
+// shifted positive first and back after.
+const int ROT_BIAS = 256;
+
+} // namespace
+
+SpriteQuantization sprite_quantization(const BoundingBox& rect) {
+  return {rect.minX, rect.minY, std::max(rect.maxX - rect.minX, 1e-3f), std::max(rect.maxY - rect.minY, 1e-3f)};
+}
+
+void pack_sprite_instances_scalar(const SpriteSource& src, const int* order, int count, const SpriteQuantization& q, SpriteInstance* out) {
+  const float sx = QUANT_MAX / q.extent_x;
+  const float sy = QUANT_MAX / q.extent_y;
+  for (int k = 0; k < count; ++k) {
+    const int i = order[k];
+    const float qx = std::min(std::max((src.positions_x[i] - q.origin_x) * sx, 0.0f), QUANT_MAX);
+    const float qy = std::min(std::max((src.positions_y[i] - q.origin_y) * sy, 0.0f), QUANT_MAX);
+    const Point2 look = src.looks[i];
+    const float rot = ROT_MAX / (std::sqrt(look.x * look.x + look.y * look.y) + 1e-6f);
+    out[k].x = static_cast<uint16_t>(static_cast<int>(qx + 0.5f));
+    out[k].y = static_cast<uint16_t>(static_cast<int>(qy + 0.5f));
+    // Rotate sprite so its "up" in texture aligns with look direction: apply -90 deg offset
+    out[k].cosv = static_cast<int8_t>(static_cast<int>(look.y * rot + (ROT_BIAS + 0.5f)) - ROT_BIAS);   // cos(phi - pi/2) = sin(phi)
+    out[k].sinv = static_cast<int8_t>(static_cast<int>(-look.x * rot + (ROT_BIAS + 0.5f)) - ROT_BIAS);  // sin(phi - pi/2) = -cos(phi)
+    out[k].frame = src.frame_ids ? src.frame_ids[i] : 0;
+  }
+}
+
+void pack_sprite_instances(const SpriteSource& src, const int* order, int count, const SpriteQuantization& q, SpriteInstance* out) {
+  using namespace simd4;
+  const f4 ox = splat(q.origin_x);
+  const f4 oy = splat(q.origin_y);
+  const f4 sx = splat(QUANT_MAX / q.extent_x);
+  const f4 sy = splat(QUANT_MAX / q.extent_y);
+  const f4 zero = splat(0.0f);
+  const f4 half = splat(0.5f);
+  const f4 qmax = splat(QUANT_MAX);
+  const f4 rmax = splat(ROT_MAX);
+  const f4 rbias = splat(ROT_BIAS + 0.5f);
+  const f4 eps = splat(1e-6f);
+  const i4 byte = splat_i(0xff);
+  const float* px = src.positions_x;
+  const float* py = src.positions_y;
+  const Point2* looks = src.looks;
+
+  int k = 0;
+  for (; k + 4 <= count; k += 4) {
+    // order skips dead and culled agents, so the columns are gathered.
+    const int i0 = order[k], i1 = order[k + 1], i2 = order[k + 2], i3 = order[k + 3];
+    const f4 x = set(px[i0], px[i1], px[i2], px[i3]);
+    const f4 y = set(py[i0], py[i1], py[i2], py[i3]);
+    const f4 lx = set(looks[i0].x, looks[i1].x, looks[i2].x, looks[i3].x);
+    const f4 ly = set(looks[i0].y, looks[i1].y, looks[i2].y, looks[i3].y);
+
+    const f4 qx = add(min(max(mul(sub(x, ox), sx), zero), qmax), half);
+    const f4 qy = add(min(max(mul(sub(y, oy), sy), zero), qmax), half);
+    const f4 rot = div(rmax, add(sqrt(length_sq(lx, ly)), eps));
+    // Biased by 256, which the low byte drops: (v + 256) & 0xff == v & 0xff.
+    const i4 cosv = to_int(add(mul(ly, rot), rbias));
+    const i4 sinv = to_int(add(mul(sub(zero, lx), rot), rbias));
+    const i4 packedRot = or_i(and_i(cosv, byte), shl_i(and_i(sinv, byte), 8));
+    const i4 frame = src.frame_ids
+        ? set_i(src.frame_ids[i0], src.frame_ids[i1], src.frame_ids[i2], src.frame_ids[i3])
+        : splat_i(0);
+    store_u16_quads(reinterpret_cast<uint16_t*>(out + k), to_int(qx), to_int(qy), packedRot, frame);
+  }
+  pack_sprite_instances_scalar(src, order + k, count - k, q, out + k);
+}
+
+bool sprite_view_rect(const float* m3x3, float margin, BoundingBox* out) {
+  // clip = A * world + t, so world = A^-1 * (clip - t) for the four clip corners.
+  const float a = m3x3[0], b = m3x3[1], tx = m3x3[2];
+  const float c = m3x3[3], d = m3x3[4], ty = m3x3[5];
+  const float det = a * d - b * c;
+  if (!(std::fabs(det) > 1e-20f)) return false;
+  const float inv = 1.0f / det;
+  BoundingBox r = {0.0f, 0.0f, 0.0f, 0.0f};
+  for (int k = 0; k < 4; ++k) {
+    const float cx = ((k & 1) ? 1.0f : -1.0f) - tx;
+    const float cy = ((k & 2) ? 1.0f : -1.0f) - ty;
+    const float x = (d * cx - b * cy) * inv;
+    const float y = (a * cy - c * cx) * inv;
+    if (k == 0) r = {x, y, x, y};
+    r.minX = std::min(r.minX, x);
+    r.minY = std::min(r.minY, y);
+    r.maxX = std::max(r.maxX, x);
+    r.maxY = std::max(r.maxY, y);
+  }
+  *out = {r.minX - margin, r.minY - margin, r.maxX + margin, r.maxY + margin};
+  return true;
+}
+
+int SpriteInstanceBuilder::gather_all(const SpriteSource& src) {
+  int m = 0;
+  for (int i = 0; i < src.active_agents; ++i) {
+    if (src.is_alive[i]) visible_[m++] = i;
+  }
+  return m;
+}
+
+int SpriteInstanceBuilder::gather_rect(const SpriteSource& src, const BoundingBox& view) {
+  int m = 0;
+  for (int i = 0; i < src.active_agents; ++i) {
+    visible_[m] = i;
+    m += (src.is_alive[i] != 0) & in_rect(view, src.positions_x[i], src.positions_y[i]);
+  }
+  return m;
+}
+
+// Agents outside the grid's world bounds are never indexed, so they are not
+// drawn on this path.
+int SpriteInstanceBuilder::gather_grid(const SpriteSource& src, const BoundingBox& view, const AgentGridData& grid) {
+  int x0, y0, x1, y1;
+  if (!agent_grid_cell_range(view, &x0, &y0, &x1, &y1)) return 0;
+  int m = 0;
+  for (int gy = y0; gy <= y1; ++gy) {
+    for (int gx = x0; gx <= x1; ++gx) {
+      const int cell = agent_grid_cell_index(gx, gy);
+      const int count = grid.cell_counts[cell];
+      if (count == 0) continue;
+      const uint16_t* agents = grid.cell_data.data() + grid.cell_offsets[cell];
+      if (contains(view, agent_grid_cell_bounds(gx, gy))) {
+        // Agents may have died since the reindex.
+        for (int k = 0; k < count; ++k) {
+          if (src.is_alive[agents[k]]) visible_[m++] = agents[k];
+        }
+      } else {
+        for (int k = 0; k < count; ++k) {
+          const int i = agents[k];
+          visible_[m] = i;
+          m += (src.is_alive[i] != 0) & in_rect(view, src.positions_x[i], src.positions_y[i]);
+        }
+      }
+    }
+  }
+  return m;
+}
+
+int SpriteInstanceBuilder::build(const SpriteSource& src, int frameCount, const BoundingBox* view,
+                                 const AgentGridData* grid) {
+  count_ = 0;
+  if (frameCount <= 0) return 0;
+  const int n = src.active_agents;
+  if (static_cast<int>(visible_.size()) < n) visible_.resize(n);
+  int visible;
+  if (!view) {
+    visible = gather_all(src);
+  } else if (grid && grid->indexed_agents == n && !grid->overflowed && indexed_in(*view, *grid) * 4 < n) {
+    // Walking cells reads the columns out of order, which only pays off
+    // while the view holds a small share of the crowd.
+    visible = gather_grid(src, *view, *grid);
+  } else {
+    visible = gather_rect(src, *view);
+  }
+
+  // Pack in agent order, where the column reads are nearly sequential, then
+  // counting-sort the 8-byte records by frame id.
+  if (view) {
+    quantization_ = sprite_quantization(*view);
+  } else if (visible > 0) {
+    BoundingBox bounds = {src.positions_x[visible_[0]], src.positions_y[visible_[0]], src.positions_x[visible_[0]], src.positions_y[visible_[0]]};
+    for (int k = 1; k < visible; ++k) {
+      const float x = src.positions_x[visible_[k]];
+      const float y = src.positions_y[visible_[k]];
+      bounds.minX = std::min(bounds.minX, x);
+      bounds.minY = std::min(bounds.minY, y);
+      bounds.maxX = std::max(bounds.maxX, x);
+      bounds.maxY = std::max(bounds.maxY, y);
+    }
+    quantization_ = sprite_quantization(bounds);
+  }
+  if (static_cast<int>(packed_.size()) < visible) packed_.resize(visible);
+  if (static_cast<int>(instances_.size()) < visible) instances_.resize(visible);
+  pack_sprite_instances(src, visible_.data(), visible, quantization_, packed_.data());
+
+  // Count pass: offsets_[f + 1] = instances with frame id f.
+  offsets_.assign(static_cast<size_t>(frameCount) + 1, 0u);
+  for (int k = 0; k < visible; ++k) {
+    const int f = packed_[k].frame;
+    if (f < frameCount) offsets_[f + 1]++;
+  }
+  for (int f = 0; f < frameCount; ++f) offsets_[f + 1] += offsets_[f];
+  count_ = static_cast<int>(offsets_[frameCount]);
+
+  // Scatter pass. offsets_[f] walks from the start to the end of frame f, so
+  // afterwards each entry holds the next frame's start; shift them back.
+  for (int k = 0; k < visible; ++k) {
+    const int f = packed_[k].frame;
+    if (f < frameCount) instances_[offsets_[f]++] = packed_[k];
+  }
+  for (int f = frameCount; f > 0; --f) offsets_[f] = offsets_[f - 1];
+  offsets_[0] = 0;
+  return count_;
+}
@@ -0,0 +1,94 @@
+#ifndef SPRITE_INSTANCES_H
+#define SPRITE_INSTANCES_H
+
+#include <cstdint>
+#include <vector>
+#include "data_structures.h"
+
+// CPU stage of the sprite renderer, kept free of GL so it runs (and is
+// benchmarked) headless. Alive agents become one instance each, counting-
+// sorted by frame id and packed into a persistent 8-byte-per-instance array:
+// the renderer uploads it once and draws it with a single instanced call,
+// decoding the instance and looking its UVs up in the vertex shader.
+// Given a view rect, only agents inside it become instances; agent_grid cells
+// fully inside the rect are taken whole and only the boundary cells are tested
+// agent by agent. When the view holds most of the crowd a plain scan is
+// cheaper and is used instead.
+
+// Columns the renderer reads: either the live SoA or a published snapshot slot.
+struct SpriteSource {
+  const float* positions_x;
+  const float* positions_y;
+  const Point2* looks;
+  const uint16_t* frame_ids;  // nullptr = frame 0 for everyone
+  const uint8_t* is_alive;
+  int active_agents;
+};
+
+// Matches the instance attributes of the sprite vertex shader. Positions are
+// 16-bit fixed point across the SpriteQuantization rect, so their error stays
+// below 1/65535 of the view whatever the zoom. The rotation is the look
+// direction turned by -90 degrees, as a snorm8 pair. The sprite height is the
+// same for every agent and goes in a uniform.
+struct SpriteInstance {
+  uint16_t x, y;       // 0..65535 across the quantization rect
+  int8_t cosv, sinv;   // sprite rotation * 127
+  uint16_t frame;
+};
+
+static_assert(sizeof(SpriteInstance) == 8, "sprite_renderer.cpp binds an 8-byte instance stride");
+
+// Rect the instance positions are quantized over: world = origin + (q / 65535) * extent.
+struct SpriteQuantization {
+  float origin_x, origin_y;
+  float extent_x, extent_y;
+};
+
+SpriteQuantization sprite_quantization(const BoundingBox& rect);
+
+// World rect visible through the row-major world-to-clip matrix render()
+// receives, grown by margin on every side. False if the matrix is singular.
+bool sprite_view_rect(const float* m3x3, float margin, BoundingBox* out);
+
+// Packs the agents order[0..count) of src into out, four at a time with
+// simd4. Positions outside q clamp to its edges. Headless; the scalar
+// version is the reference it must match, up to one snorm step of rotation
+// where -ffast-math rounds a half differently.
+void pack_sprite_instances(const SpriteSource& src, const int* order, int count, const SpriteQuantization& q, SpriteInstance* out);
+void pack_sprite_instances_scalar(const SpriteSource& src, const int* order, int count, const SpriteQuantization& q, SpriteInstance* out);
+
+class SpriteInstanceBuilder {
+public:
+  // Rebuilds instances() from src: alive agents whose frame id is below
+  // frameCount and whose position lies in view (all of them when view is
+  // null), ordered by frame id. Pass grid (agent_grid) only when it indexes
+  // src's own columns; it is used if its last reindex covered
+  // src.active_agents, dropped nobody and puts under a quarter of the crowd
+  // in view; otherwise every agent is tested.
+  // Within a frame agents are in index order, or in cell order when the grid
+  // was used. Positions are quantized over view, or over the bounds of the
+  // agents drawn when there is none. Allocates only when the agent count or
+  // frameCount grows. Returns the instance count.
+  int build(const SpriteSource& src, int frameCount, const BoundingBox* view = nullptr,
+            const AgentGridData* grid = nullptr);
+
+  const SpriteInstance* instances() const { return instances_.data(); }
+  int count() const { return count_; }
+  const SpriteQuantization& quantization() const { return quantization_; }
+  // Instances with frame id f are [frame_start(f), frame_start(f + 1)).
+  uint32_t frame_start(int f) const { return offsets_[f]; }
+
+private:
+  int gather_all(const SpriteSource& src);
+  int gather_rect(const SpriteSource& src, const BoundingBox& view);
+  int gather_grid(const SpriteSource& src, const BoundingBox& view, const AgentGridData& grid);
+
+  std::vector<int> visible_;            // agents to draw, filled by a gather_*
+  std::vector<SpriteInstance> packed_;  // visible_ packed, before sorting
+  std::vector<uint32_t> offsets_;       // frameCount + 1 after build
+  std::vector<SpriteInstance> instances_;
+  SpriteQuantization quantization_ = {0.0f, 0.0f, 1.0f, 1.0f};
+  int count_ = 0;
+};
+
+#endif // SPRITE_INSTANCES_H
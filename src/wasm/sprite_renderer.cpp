@@ -3,12 +3,18 @@
 #include <emscripten/emscripten.h>
 #include <emscripten/html5.h>
 #include <GLES3/gl3.h>
+#include <cstddef>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
 #include <vector>
+#include "agent_grid.h"
 #include "data_structures.h"
+#include "render_snapshot.h"
+#include "sprite_instances.h"
+#include "sim_thread.h"
+#include "profiler.h"
 #include <iostream>
 
 // Pull SoA and counters from main TU (C++ linkage)
@@ -21,51 +27,59 @@ int g_viewport_h = 0;
 float g_dpr = 1.0f;
 GLuint g_program = 0;
 GLuint g_tex = 0;
+GLuint g_uv_tex = 0;  // frame table, one RGBA32F texel (u0,v0,u1,v1) per frame id
 GLuint g_vao = 0;
 GLuint g_vbo = 0;
 GLuint g_ebo = 0;
 GLuint g_instance_vbo = 0;
+size_t g_instance_vbo_bytes = 0;  // allocated size; grows, never shrinks
 GLint u_worldToClip_loc = -1;
 GLint u_atlas_loc = -1;
-GLint u_uv_loc = -1;
+GLint u_frame_uvs_loc = -1;
+GLint u_scale_loc = -1;
+GLint u_inst_origin_loc = -1;
+GLint u_inst_extent_loc = -1;
 bool g_debugOverlay = false;
 // Derived each frame: pixels per world unit
 float g_pixelsPerWorld = 1.0f;
 
-// Frame table (u0,v0,u1,v1) per frame id
-std::vector<float> g_frameUVs; // length = g_frameCount * 4
+// Frames in the uploaded frame table (g_uv_tex)
 int g_frameCount = 0;
 
 // Persistent instance storage to avoid per-frame allocations
-struct Instance { float x, y, cosv, sinv, scale; };
+SpriteInstanceBuilder g_instances;
 
 const char* kVS = R"(#version 300 es
 layout(location=0) in vec2 a_pos;    // quad unit vertex: (-0.5..+0.5)
-layout(location=1) in vec2 i_worldXY;  // instance
-layout(location=2) in vec2 i_cosSin;   // instance
-layout(location=3) in float i_scale;   // instance
+layout(location=1) in vec2 i_posN;     // instance, unorm16 across the quantization rect
+layout(location=2) in vec2 i_cosSin;   // instance, snorm8
+layout(location=3) in uint i_frame;    // instance
 
 uniform mat3 u_worldToClip; // 3x3 affine to NDC
-uniform vec4 u_uv; // u0,v0,u1,v1
+uniform float u_scale;      // sprite height in world units
+uniform vec2 u_instOrigin;  // quantization rect (SpriteQuantization)
+uniform vec2 u_instExtent;
 uniform sampler2D u_atlas; // for textureSize
+uniform highp sampler2D u_frameUVs; // u0,v0,u1,v1 per frame id
 out vec2 v_uv;
 
 void main() {
+  vec4 uv = texelFetch(u_frameUVs, ivec2(int(i_frame), 0), 0);
   // derive aspect ratio of the frame in pixels (handles non-square atlases)
   ivec2 texSize = textureSize(u_atlas, 0);
-  vec2 uvSize = abs(u_uv.zw - u_uv.xy);
+  vec2 uvSize = abs(uv.zw - uv.xy);
   vec2 pxSize = uvSize * vec2(texSize);
   float aspect = pxSize.y > 0.0 ? (pxSize.x / pxSize.y) : 1.0;
 
-  // non-uniform scale in world units: i_scale encodes height; width = height * aspect
-  vec2 local = a_pos * vec2(i_scale * aspect, i_scale);
+  // non-uniform scale in world units: u_scale is the height; width = height * aspect
+  vec2 local = a_pos * vec2(u_scale * aspect, u_scale);
   vec2 rotated = vec2(
   local.x * i_cosSin.x - local.y * i_cosSin.y,
   local.x * i_cosSin.y + local.y * i_cosSin.x
   );
-  vec2 world = i_worldXY + rotated;
+  vec2 world = u_instOrigin + i_posN * u_instExtent + rotated;
   vec2 uv01 = a_pos + 0.5; // 0..1 within the quad
-  v_uv = mix(u_uv.xy, u_uv.zw, uv01);
+  v_uv = mix(uv.xy, uv.zw, uv01);
   vec3 clip = u_worldToClip * vec3(world, 1.0);
   gl_Position = vec4(clip.xy, 0.0, 1.0);
 }
@@ -122,7 +136,10 @@ void ensurePipeline() {
   g_program = linkProgram(vs, fs);
   u_worldToClip_loc = glGetUniformLocation(g_program, "u_worldToClip");
   u_atlas_loc = glGetUniformLocation(g_program, "u_atlas");
-  u_uv_loc = glGetUniformLocation(g_program, "u_uv");
+  u_frame_uvs_loc = glGetUniformLocation(g_program, "u_frameUVs");
+  u_scale_loc = glGetUniformLocation(g_program, "u_scale");
+  u_inst_origin_loc = glGetUniformLocation(g_program, "u_instOrigin");
+  u_inst_extent_loc = glGetUniformLocation(g_program, "u_instExtent");
 
   // Unit quad
   const float quadVerts[] = {
@@ -146,22 +163,22 @@ void ensurePipeline() {
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ebo);
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quadIdx), quadIdx, GL_STATIC_DRAW);
 
-  // Instance buffer (pos, cossin, scale)
+  // Instance buffer (pos, cossin, frame id): one 8-byte SpriteInstance each
   glGenBuffers(1, &g_instance_vbo);
   glBindBuffer(GL_ARRAY_BUFFER, g_instance_vbo);
-  const GLsizei stride = sizeof(float)*5; // 2 + 2 + 1
+  const GLsizei stride = sizeof(SpriteInstance);
   glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_STREAM_DRAW);
 
   glEnableVertexAttribArray(1);
-  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(0));
+  glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)offsetof(SpriteInstance, x));
   glVertexAttribDivisor(1, 1);
 
   glEnableVertexAttribArray(2);
-  glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(float)*2));
+  glVertexAttribPointer(2, 2, GL_BYTE, GL_TRUE, stride, (void*)offsetof(SpriteInstance, cosv));
   glVertexAttribDivisor(2, 1);
 
   glEnableVertexAttribArray(3);
-  glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(float)*4));
+  glVertexAttribIPointer(3, 1, GL_UNSIGNED_SHORT, stride, (void*)offsetof(SpriteInstance, frame));
   glVertexAttribDivisor(3, 1);
 
   glBindVertexArray(0);
@@ -175,17 +192,42 @@ void ensureTexture() {
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+  // Only read with texelFetch; float textures must not be filtered.
+  glGenTextures(1, &g_uv_tex);
+  glBindTexture(GL_TEXTURE_2D, g_uv_tex);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 }
 
-void renderInstances(const float* m3x3, int active_agents) {
-  const float scaleWorld = 2.5f;
+const float SPRITE_SCALE_WORLD = 2.5f;
+// Snapshot reads retried before the frame is skipped; a retry only fails if
+// the sim publishes two more frames while the instances are built.
+const int SNAPSHOT_READ_ATTEMPTS = 3;
 
-  int aliveCount = 0;
-  for (int i = 0; i < active_agents; ++i) {
-    if (agent_data.is_alive[i]) aliveCount++;
-  }
+// Fills g_instances from src. grid: agent_grid when src is the live SoA it
+// indexes, else null. Returns the instance count.
+int buildInstances(const float* m3x3, const SpriteSource& src, const AgentGridData* grid) {
+  // Require a valid frame table
+  if (g_frameCount <= 0 || u_frame_uvs_loc < 0) return 0;
 
-  if (aliveCount <= 0) return;
+  // Keep agents whose centre is just off screen but whose quad (width is
+  // height * atlas aspect, rotated) still reaches into it.
+  BoundingBox view;
+  const bool culled = m3x3 && sprite_view_rect(m3x3, 2.0f * SPRITE_SCALE_WORLD, &view);
+  return g_instances.build(src, g_frameCount, culled ? &view : nullptr, grid);
+}
+
+// Uploads and draws the count instances buildInstances left in g_instances.
+void drawInstances(const float* m3x3, int count) {
+  if (count <= 0) return;
+
+  const SpriteQuantization& q = g_instances.quantization();
+  glUniform1f(u_scale_loc, SPRITE_SCALE_WORLD);
+  glUniform2f(u_inst_origin_loc, q.origin_x, q.origin_y);
+  glUniform2f(u_inst_extent_loc, q.extent_x, q.extent_y);
 
   // Update dynamic uniform per frame
   if (u_worldToClip_loc >= 0 && m3x3) {
@@ -193,51 +235,14 @@ void renderInstances(const float* m3x3, int active_agents) {
     glUniformMatrix3fv(u_worldToClip_loc, 1, GL_FALSE, m);
   }
 
-  // Require a valid frame table
-  if (g_frameCount <= 0 || (int)g_frameUVs.size() < g_frameCount * 4 || u_uv_loc < 0) return;
-
-  struct FrameBatch { int fid; std::vector<Instance> instances; };
-  std::vector<FrameBatch> batches;
-  batches.reserve(4); // assume few distinct fids per frame
-
-  // Single pass over agents: bucket by frame id (few unique expected)
-  for (int i = 0; i < active_agents; ++i) {
-    if (!agent_data.is_alive[i]) continue;
-    const uint16_t frameId = agent_data.frame_ids ? agent_data.frame_ids[i] : 0;
-    const Point2 p = agent_data.positions[i];
-    const Point2 look = agent_data.looks[i];
-    const float len = std::sqrt(look.x*look.x + look.y*look.y) + 1e-6f;
-    // Rotate sprite so its "up" in texture aligns with look direction: apply -90 deg offset
-    const float cos_phi = look.x / len;
-    const float sin_phi = look.y / len; // no Y flip in WASM world space
-    const float cosv = sin_phi;  // cos(phi - pi/2) = sin(phi)
-    const float sinv = -cos_phi;   // sin(phi - pi/2) = -cos(phi)
-    // find or create batch
-    int batchIndex = -1;
-    for (size_t b = 0; b < batches.size(); ++b) {
-      if (batches[b].fid == (int)frameId) { batchIndex = (int)b; break; }
-    }
-    if (batchIndex < 0) {
-      FrameBatch fb; fb.fid = (int)frameId; fb.instances.reserve(active_agents-i);
-      batches.push_back(std::move(fb));
-      batchIndex = (int)batches.size() - 1;
-    }
-    batches[batchIndex].instances.push_back({ p.x, p.y, cosv, sinv, scaleWorld });
-  }
-
-  // Draw each batch
-  for (const FrameBatch& fb : batches) {
-    if (fb.fid < 0 || fb.fid >= g_frameCount) continue;
-    const float* uv = &g_frameUVs[(size_t)fb.fid * 4];
-    glUniform4fv(u_uv_loc, 1, uv);
-
-    const size_t bytes = fb.instances.size() * sizeof(Instance);
-    if (bytes == 0) continue;
-    glBindBuffer(GL_ARRAY_BUFFER, g_instance_vbo);
-    glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, fb.instances.data());
-    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, (void*)0, (GLsizei)fb.instances.size());
-  }
+  // Orphan the buffer (same size, no copy) so the driver never waits for the
+  // previous frame's draw, then upload every instance at once.
+  const size_t bytes = static_cast<size_t>(count) * sizeof(SpriteInstance);
+  glBindBuffer(GL_ARRAY_BUFFER, g_instance_vbo);
+  if (bytes > g_instance_vbo_bytes) g_instance_vbo_bytes = bytes + bytes / 2;
+  glBufferData(GL_ARRAY_BUFFER, g_instance_vbo_bytes, nullptr, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, g_instances.instances());
+  glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, (void*)0, (GLsizei)count);
 }
 
 } // namespace
@@ -270,6 +275,7 @@ EMSCRIPTEN_KEEPALIVE void sprite_renderer_init(const char* canvas_selector) {
   // Set up static GL state once - these never change
   glUseProgram(g_program);
   glUniform1i(u_atlas_loc, 0);
+  glUniform1i(u_frame_uvs_loc, 1);
   
   // Set up blend state once - this never changes
   glEnable(GL_BLEND);
@@ -277,6 +283,8 @@ EMSCRIPTEN_KEEPALIVE void sprite_renderer_init(const char* canvas_selector) {
   
   // Bind static rendering state
   glBindVertexArray(g_vao);
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, g_uv_tex);
   glActiveTexture(GL_TEXTURE0);
   glBindTexture(GL_TEXTURE_2D, g_tex);
 }
@@ -291,13 +299,17 @@ EMSCRIPTEN_KEEPALIVE void sprite_upload_atlas_rgba(uint8_t* pixels, int width, i
 }
 
 EMSCRIPTEN_KEEPALIVE void sprite_upload_frame_table(const float* uv4_array, int frameCount) {
-  if (frameCount <= 0) {
-    g_frameUVs.clear();
+  if (!g_ctx || frameCount <= 0) {
     g_frameCount = 0;
     return;
   }
+  emscripten_webgl_make_context_current(g_ctx);
+  ensureTexture();
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, g_uv_tex);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, frameCount, 1, 0, GL_RGBA, GL_FLOAT, uv4_array);
+  glActiveTexture(GL_TEXTURE0);
   g_frameCount = frameCount;
-  g_frameUVs.assign(uv4_array, uv4_array + (size_t)frameCount * 4);
 }
 
 EMSCRIPTEN_KEEPALIVE void set_renderer_debug(int enable) {
@@ -307,6 +319,7 @@ EMSCRIPTEN_KEEPALIVE void set_renderer_debug(int enable) {
 EMSCRIPTEN_KEEPALIVE void render(float dt, int active_agents, const float* m3x3, int widthPx, int heightPx, float dpr) {
   (void)dt;
   if (!g_ctx) return;
+  PROFILE_SCOPE(PROFILE_RENDER);
   emscripten_webgl_make_context_current(g_ctx);
 
   if (widthPx != g_viewport_w || heightPx != g_viewport_h || dpr != g_dpr) {
@@ -334,7 +347,27 @@ EMSCRIPTEN_KEEPALIVE void render(float dt, int active_agents, const float* m3x3,
   ensurePipeline();
   ensureTexture();
 
-  renderInstances(m3x3, active_agents);
+  if (is_simulation_threaded()) {
+    // The sim thread owns agent_data; draw the latest published frame instead.
+    // The instances are copied out of the slot, so once they are built the
+    // slot may be reused; if it was reused during the build, start over from
+    // the newer frame.
+    for (int attempt = 0; attempt < SNAPSHOT_READ_ATTEMPTS; ++attempt) {
+      uint32_t seq = 0;
+      const RenderSnapshotSlot* slot = g_render_snapshot.acquire(seq);
+      if (!slot) return;
+      SpriteSource src = { slot->positions_x, slot->positions_y, slot->looks, slot->frame_ids, slot->is_alive, slot->active_agents };
+      const int count = buildInstances(m3x3, src, nullptr);
+      if (g_render_snapshot.still_valid(seq)) {
+        drawInstances(m3x3, count);
+        return;
+      }
+    }
+  } else {
+    SpriteSource src = { agent_data.positions.x, agent_data.positions.y, agent_data.looks, agent_data.frame_ids,
+                         reinterpret_cast<const uint8_t*>(agent_data.is_alive), active_agents };
+    drawInstances(m3x3, buildInstances(m3x3, src, &agent_grid));
+  }
 }
 
 EMSCRIPTEN_KEEPALIVE void sprite_renderer_clear() {
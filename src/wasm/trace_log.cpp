@@ -0,0 +1,43 @@
+#include "trace_log.h"
+
+namespace {
+
+struct TraceRing {
+  uint32_t header[TRACE_HEADER_WORDS];
+  TraceRecord records[TRACE_CAPACITY];
+};
+
+static_assert(sizeof(TraceRecord) == 32, "TraceLog.ts assumes 8-word records");
+static_assert((TRACE_CAPACITY & (TRACE_CAPACITY - 1)) == 0, "capacity must be a power of two");
+
+TraceRing g_trace = {
+  {0, TRACE_CAPACITY, sizeof(TraceRecord) / 4, TRACE_MIN_LEVEL},
+  {},
+};
+float g_trace_time = 0.0f;
+
+} // namespace
+
+void trace_write(uint8_t level, uint16_t code, int32_t agent, const uint32_t* args) {
+  // Reserve a slot first so concurrent writers never share one.
+  const uint32_t index = __atomic_fetch_add(&g_trace.header[0], 1u, __ATOMIC_RELAXED);
+  TraceRecord& r = g_trace.records[index & (TRACE_CAPACITY - 1)];
+  __atomic_store_n(&r.seq, 0u, __ATOMIC_RELAXED);
+  r.code = code;
+  r.level = level;
+  r.agent = agent;
+  r.sim_time = g_trace_time;
+  r.args[0] = args[0];
+  r.args[1] = args[1];
+  r.args[2] = args[2];
+  r.args[3] = args[3];
+  __atomic_store_n(&r.seq, index + 1, __ATOMIC_RELEASE);
+}
+
+void trace_set_time(float sim_time) {
+  g_trace_time = sim_time;
+}
+
+const uint32_t* trace_log_header() {
+  return g_trace.header;
+}
@@ -0,0 +1,85 @@
+#ifndef TRACE_LOG_H
+#define TRACE_LOG_H
+
+#include <cstdint>
+#include <cstring>
+
+// Binary trace ring in linear memory. The simulation only stores fixed-size
+// records (code, agent, up to four numeric args); TS drains and formats them
+// (src/logic/TraceLog.ts). No string formatting happens on the WASM side.
+
+#define TRACE_LEVEL_DEBUG 0
+#define TRACE_LEVEL_INFO 1
+#define TRACE_LEVEL_WARN 2
+#define TRACE_LEVEL_ERROR 3
+#define TRACE_LEVEL_OFF 4
+
+// Records below this level are compiled out (build with -DTRACE_MIN_LEVEL=0 for debug traces).
+#ifndef TRACE_MIN_LEVEL
+#define TRACE_MIN_LEVEL TRACE_LEVEL_INFO
+#endif
+
+#define TRACE_ENABLED(level) ((level) >= TRACE_MIN_LEVEL)
+
+// Codes MUST match TraceCode in src/logic/TraceLog.ts, which also owns the message text.
+enum TraceCode : uint16_t {
+  TRACE_FIND_PATH = 1,                  // args: start tri, end tri, RepathReason
+  TRACE_CORRIDOR_INVALID_POLYS = 2,     // args: start poly, end poly
+  TRACE_CORRIDOR_ITERATION_LIMIT = 3,   // args: start poly, end poly, iterations
+  TRACE_CORRIDOR_NO_PATH = 4,           // args: start poly, end poly, iterations
+  TRACE_UNWALKABLE_TRIANGLE = 5,        // args: old tri, new tri, walkable triangle count
+  TRACE_PREDICAMENT_RESET = 6,          // args: x (f32), y (f32)
+  TRACE_NO_CORNER_AFTER_STUCK = 7,
+  TRACE_PATH_RECOVERY_FAILED = 8,
+  TRACE_NO_CORNER_AFTER_ESCAPE = 9,
+  TRACE_END_TARGET_OFF_NAVMESH = 10,
+  TRACE_CORNER_BLOB_NOT_FOUND = 11,     // args: x (f32), y (f32), nearby blob count
+  TRACE_CORNER_BLOB_CLOSEST = 12,       // args: x (f32), y (f32), blob, distance (f32)
+  TRACE_UNKNOWN_COMMAND = 13,           // args: event type
+  TRACE_BAD_COMMAND = 14,               // args: event type, size in words
+};
+
+struct TraceRecord {
+  uint32_t seq;      // index + 1 once the record is fully written
+  uint16_t code;
+  uint8_t level;
+  uint8_t reserved;
+  int32_t agent;     // -1 if not agent specific
+  float sim_time;
+  uint32_t args[4];
+};
+
+const int TRACE_CAPACITY = 4096; // records, power of two
+// Header words exported via get_trace_log_ptr (u32):
+//   [0] records written (monotonic), [1] capacity, [2] words per record, [3] TRACE_MIN_LEVEL
+//   followed by the records. A reader that falls more than capacity behind has lost records.
+const int TRACE_HEADER_WORDS = 4;
+
+void trace_write(uint8_t level, uint16_t code, int32_t agent, const uint32_t* args);
+void trace_set_time(float sim_time);
+const uint32_t* trace_log_header();
+
+inline uint32_t trace_bits(int32_t v) { return static_cast<uint32_t>(v); }
+inline uint32_t trace_bits(uint32_t v) { return v; }
+inline uint32_t trace_bits(float v) { uint32_t u; std::memcpy(&u, &v, sizeof(u)); return u; }
+inline uint32_t trace_bits(double v) { return trace_bits(static_cast<float>(v)); }
+
+template<typename... Args>
+inline void trace_emit(uint8_t level, uint16_t code, int32_t agent, Args... args) {
+  static_assert(sizeof...(Args) <= 4, "trace records carry at most four args");
+  uint32_t packed[4] = {0, 0, 0, 0};
+  int i = 0;
+  ((packed[i++] = trace_bits(args)), ...);
+  (void)i;
+  trace_write(level, code, agent, packed);
+}
+
+#define TRACE_LOG(level, code, agent, ...) \
+  do { if (TRACE_ENABLED(level)) trace_emit((level), (code), (agent), ##__VA_ARGS__); } while (0)
+
+#define TRACE_DEBUG(code, agent, ...) TRACE_LOG(TRACE_LEVEL_DEBUG, code, agent, ##__VA_ARGS__)
+#define TRACE_INFO(code, agent, ...) TRACE_LOG(TRACE_LEVEL_INFO, code, agent, ##__VA_ARGS__)
+#define TRACE_WARN(code, agent, ...) TRACE_LOG(TRACE_LEVEL_WARN, code, agent, ##__VA_ARGS__)
+#define TRACE_ERROR(code, agent, ...) TRACE_LOG(TRACE_LEVEL_ERROR, code, agent, ##__VA_ARGS__)
+
+#endif // TRACE_LOG_H
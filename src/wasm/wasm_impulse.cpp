@@ -1,5 +1,7 @@
 #include "wasm_impulse.h"
 #include "benchmarks.h"
+#include "microbench.h"
+#include "scenario_bench.h"
 #include <stdio.h>
 #include <emscripten/emscripten.h>
 
@@ -13,7 +15,23 @@ extern "C" {
       case WasmImpulse::POINT_IN_POLYGON_BENCH:
         point_in_polygon_bench();
         break;
+      case WasmImpulse::PHYS_SIMD_BENCH:
+        phys_simd_bench();
+        break;
+      case WasmImpulse::NAV_CONSTANTS_BENCH:
+        nav_constants_bench();
+        break;
+      case WasmImpulse::SCENARIO_SUITE:
+        scenario_suite();
+        break;
+      case WasmImpulse::MICROBENCH_SUITE:
+        microbench_suite();
+        break;
       default:
+        if (impulse_code >= WasmImpulse::SCENARIO_FIRST && impulse_code < WasmImpulse::SCENARIO_FIRST + SCENARIO_COUNT) {
+          scenario_bench(impulse_code - WasmImpulse::SCENARIO_FIRST);
+          break;
+        }
         printf("[WASM] Unknown impulse code: %d\n", impulse_code);
         break;
     }
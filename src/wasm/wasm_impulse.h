@@ -4,4 +4,10 @@
 enum WasmImpulse {
   POINT_IN_TRIANGLE_BENCH = 1,
   POINT_IN_POLYGON_BENCH = 2,
+  PHYS_SIMD_BENCH = 3,
+  NAV_CONSTANTS_BENCH = 4,
+  SCENARIO_SUITE = 5,
+  MICROBENCH_SUITE = 6,
+  // SCENARIO_FIRST + ScenarioId runs a single scenario (scenario_bench.h)
+  SCENARIO_FIRST = 16,
 }; 
\ No newline at end of file